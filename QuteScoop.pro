@@ -46,7 +46,7 @@ macx: {
 !build_pass:message(Qt bin: $$[QT_INSTALL_BINS])
 !build_pass:message(Qt plugins: $$[QT_INSTALL_PLUGINS])
 
-QT *= core gui network opengl xml
+QT *= core gui network opengl xml concurrent
 # in debug mode, we output to current directory
 CONFIG(debug,release|debug) {
     !build_pass:message("DEBUG")
@@ -148,11 +148,15 @@ HEADERS += \
     src/helpers.h \
     src/WhazzupData.h \
     src/Whazzup.h \
+    src/WhazzupArchive.h \
     src/Waypoint.h \
     src/Tessellator.h \
+    src/VertexBatch.h \
     src/Settings.h \
+    src/OrderedSet.h \
     src/Pilot.h \
     src/NavData.h \
+    src/NavDataCache.h \
     src/NavAid.h \
     src/Metar.h \
     src/MapObject.h \
@@ -161,14 +165,23 @@ HEADERS += \
     src/SectorReader.h \
     src/Sector.h \
     src/FileReader.h \
+    src/FixTable.h \
+    src/GeoIndex.h \
+    src/GeoPoints.h \
+    src/GlyphAtlas.h \
+    src/LabelPlacer.h \
     src/Controller.h \
     src/Client.h \
     src/BookedController.h \
+    src/BookingIndex.h \
     src/Airline.h \
     src/Airway.h \
     src/Airport.h \
     src/Airac.h \
+    src/Benchmark.h \
+    src/JsonPullReader.h \
     src/dialogs/Window.h \
+    src/SearchIndex.h \
     src/SearchVisitor.h \
     src/models/SearchResultModel.h \
     src/dialogs/PreferencesDialog.h \
@@ -178,6 +191,7 @@ HEADERS += \
     src/models/MetarModel.h \
     src/MapObjectVisitor.h \
     src/GLWidget.h \
+    src/Friends.h \
     src/FriendsVisitor.h \
     src/dialogs/ControllerDetails.h \
     src/ClientSelectionWidget.h \
@@ -190,6 +204,9 @@ HEADERS += \
     src/models/AirportDetailsArrivalsModel.h \
     src/dialogs/AirportDetails.h \
     src/Route.h \
+    src/GreatCircleCache.h \
+    src/RouteCache.h \
+    src/RouteTokenizer.h \
     src/models/PlanFlightRoutesModel.h \
     src/models/filters/BookedAtcSortFilter.h \
     src/models/ListClientsDialogModel.h \
@@ -203,18 +220,22 @@ HEADERS += \
     src/MetarDelegate.h \
     src/Platform.h \
     src/mustache/Renderer.h \
+    src/mustache/Template.h \
     src/mustache/contexts/AirportContext.h \
     src/mustache/contexts/ControllerContext.h \
     src/mustache/contexts/PilotContext.h \
     src/mustache/external/qt-mustache/mustache.h
 SOURCES += src/WhazzupData.cpp \
     src/Whazzup.cpp \
+    src/WhazzupArchive.cpp \
     src/Waypoint.cpp \
     src/Tessellator.cpp \
+    src/VertexBatch.cpp \
     src/Settings.cpp \
     src/QuteScoop.cpp \
     src/Pilot.cpp \
     src/NavData.cpp \
+    src/NavDataCache.cpp \
     src/NavAid.cpp \
     src/Metar.cpp \
     src/MapObject.cpp \
@@ -224,13 +245,22 @@ SOURCES += src/WhazzupData.cpp \
     src/SectorReader.cpp \
     src/Sector.cpp \
     src/FileReader.cpp \
+    src/FixTable.cpp \
+    src/GeoIndex.cpp \
+    src/GeoPoints.cpp \
+    src/GlyphAtlas.cpp \
+    src/LabelPlacer.cpp \
     src/Controller.cpp \
     src/Client.cpp \
     src/BookedController.cpp \
+    src/BookingIndex.cpp \
     src/Airway.cpp \
     src/Airport.cpp \
     src/Airac.cpp \
+    src/Benchmark.cpp \
+    src/JsonPullReader.cpp \
     src/dialogs/Window.cpp \
+    src/SearchIndex.cpp \
     src/SearchVisitor.cpp \
     src/models/SearchResultModel.cpp \
     src/dialogs/PreferencesDialog.cpp \
@@ -239,6 +269,7 @@ SOURCES += src/WhazzupData.cpp \
     src/MetarSearchVisitor.cpp \
     src/models/MetarModel.cpp \
     src/GLWidget.cpp \
+    src/Friends.cpp \
     src/FriendsVisitor.cpp \
     src/dialogs/ControllerDetails.cpp \
     src/ClientSelectionWidget.cpp \
@@ -251,6 +282,9 @@ SOURCES += src/WhazzupData.cpp \
     src/models/AirportDetailsArrivalsModel.cpp \
     src/dialogs/AirportDetails.cpp \
     src/Route.cpp \
+    src/GreatCircleCache.cpp \
+    src/RouteCache.cpp \
+    src/RouteTokenizer.cpp \
     src/models/PlanFlightRoutesModel.cpp \
     src/models/filters/BookedAtcSortFilter.cpp \
     src/models/ListClientsDialogModel.cpp \
@@ -264,6 +298,7 @@ SOURCES += src/WhazzupData.cpp \
     src/MetarDelegate.cpp \
     src/Platform.cpp \
     src/mustache/Renderer.cpp \
+    src/mustache/Template.cpp \
     src/mustache/contexts/AirportContext.cpp \
     src/mustache/contexts/ControllerContext.cpp \
     src/mustache/contexts/PilotContext.cpp \
@@ -2,8 +2,12 @@
 
 #include "Airport.h"
 #include "FileReader.h"
+#include "GreatCircleCache.h"
 #include "GuiMessage.h"
 #include "NavData.h"
+#include "NavDataCache.h"
+#include "RouteCache.h"
+#include "RouteTokenizer.h"
 #include "Settings.h"
 #include "Waypoint.h"
 
@@ -36,11 +40,7 @@ QString Airac::effectiveCycle(const QDate &date) {
 Airac::Airac() {}
 
 Airac::~Airac() {
-    foreach (const QSet<Waypoint*> &wl, fixes) {
-        foreach (Waypoint* w, wl) {
-            delete w;
-        }
-    }
+    fixes.deleteWaypoints();
     foreach (const QSet<NavAid*> &nl, navaids) {
         foreach (NavAid* n, nl) {
             delete n;
@@ -57,23 +57,29 @@ void Airac::load() {
     qDebug() << Settings::navdataDirectory();
     GuiMessages::status("Loading navigation database...", "airacload");
     if (Settings::useNavdata()) {
-        readFixes(Settings::navdataDirectory());
-        readNavaids(Settings::navdataDirectory());
-        readAirways(Settings::navdataDirectory());
+        QElapsedTimer timer;
+        timer.start();
+        const QString directory = Settings::navdataDirectory();
+        NavDataCache cache(
+            "airac",
+            { directory + "/earth_fix.dat", directory + "/earth_nav.dat", directory + "/earth_awy.dat" }
+        );
+        const bool fromCache = cache.read([this](QDataStream& in) { return readCache(in); });
+        if (!fromCache) {
+            readFixes(directory);
+            readNavaids(directory);
+            readAirways(directory);
+            cache.write([this](QDataStream& out) { writeCache(out); });
+        }
+        qDebug() << "Airac loaded" << (fromCache? "from cache": "from navdata files")
+                 << "in" << timer.elapsed() << "ms";
     }
 
-    allPoints.clear();
-    allPoints.reserve(fixes.size() + navaids.size());
-    foreach (const QSet<Waypoint*> &wl, fixes.values()) {
-        foreach (Waypoint* w, wl) {
-            allPoints.insert(w);
-        }
-    }
-    foreach (const QSet<NavAid*> &nl, navaids.values()) {
-        foreach (NavAid* n, nl) {
-            allPoints.insert(n);
-        }
-    }
+    buildAirwayGraph();
+
+    // resolved routes point into the previous data
+    RouteCache::instance()->clear();
+    GreatCircleCache::instance()->clear();
 
     GuiMessages::remove("airacload");
     emit loaded();
@@ -108,12 +114,22 @@ void Airac::readFixes(const QString& directory) {
             break;
         }
 
-        Waypoint* wp = new Waypoint(line.split(' ', Qt::SkipEmptyParts));
-        if (wp == 0 || wp->id.isEmpty()) {
+        const QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        if (fields.size() != 6) {
+            QMessageLogger(file.toLocal8Bit(), 0, QT_MESSAGELOG_FUNC).critical()
+                << fields << ": Expected 6 fields";
+            continue;
+        }
+        bool latOk, lonOk;
+        const float lat = fields[0].toFloat(&latOk);
+        const float lon = fields[1].toFloat(&lonOk);
+        if (!latOk || !lonOk) {
+            QMessageLogger(file.toLocal8Bit(), 0, QT_MESSAGELOG_FUNC).critical()
+                << fields << ": unable to parse lat/lon";
             continue;
         }
 
-        fixes[wp->id].insert(wp);
+        fixes.append(fields[2], fields[4], lat, lon);
     }
     qDebug() << "Read fixes from" << (directory + "/earth_fix.dat")
              << "-" << fixes.size() << "imported";
@@ -265,12 +281,154 @@ void Airac::readAirways(const QString& directory) {
              << "-" << airways.size() << "airways," << segments << "segments imported and sorted";
 }
 
+void Airac::buildAirwayGraph() {
+    _waypointAirways.clear();
+    _waypointNeighbours.clear();
+    int edges = 0;
+    foreach (const QList<Airway*> &al, airways) {
+        foreach (Airway* a, al) {
+            const QList<Waypoint*> waypoints = a->waypoints();
+            for (int i = 0; i < waypoints.size(); i++) {
+                QList<Airway*> &waypointAirways = _waypointAirways[waypoints[i]];
+                if (!waypointAirways.contains(a)) {
+                    waypointAirways.append(a);
+                }
+                QList<AirwayNeighbour> &waypointNeighbours = _waypointNeighbours[waypoints[i]];
+                if (i > 0) {
+                    waypointNeighbours.append({ a, waypoints[i - 1] });
+                    edges++;
+                }
+                if (i < waypoints.size() - 1) {
+                    waypointNeighbours.append({ a, waypoints[i + 1] });
+                    edges++;
+                }
+            }
+        }
+    }
+    qDebug() << "Airway graph:" << _waypointAirways.size() << "waypoints," << edges << "edges";
+}
+
+QList<Airway*> Airac::airwaysOf(const Waypoint* w) const {
+    return _waypointAirways.value(w);
+}
+
+QList<AirwayNeighbour> Airac::neighbours(const Waypoint* w) const {
+    return _waypointNeighbours.value(w);
+}
+
+/**
+ * Cache layout: fixes (by row), navaids, then airways referencing their
+ * waypoints by their position in the fixes + navaids sequence.
+ */
+void Airac::writeCache(QDataStream& out) const {
+    QHash<Waypoint*, qint32> indexes;
+
+    out << (qint32) fixes.size();
+    for (int row = 0; row < fixes.size(); row++) {
+        out << fixes.id(row) << fixes.regionCode(row) << fixes.lat(row) << fixes.lon(row);
+    }
+    // only fixes on airways have a Waypoint at this point
+    for (auto iter = fixes.waypoints().constBegin(); iter != fixes.waypoints().constEnd(); ++iter) {
+        indexes.insert(iter.value(), iter.key());
+    }
+
+    qint32 count = 0;
+    foreach (const QSet<NavAid*> &nl, navaids) {
+        count += nl.size();
+    }
+    out << count;
+    qint32 index = fixes.size();
+    foreach (const QSet<NavAid*> &nl, navaids) {
+        foreach (NavAid* n, nl) {
+            n->writeTo(out);
+            indexes.insert(n, index++);
+        }
+    }
+
+    out << (qint32) airways.size();
+    for (auto iter = airways.constBegin(); iter != airways.constEnd(); ++iter) {
+        out << iter.key() << (qint32) iter.value().size();
+        foreach (const Airway* a, iter.value()) {
+            const QList<Waypoint*> waypoints = a->waypoints();
+            out << (qint32) waypoints.size();
+            foreach (Waypoint* w, waypoints) {
+                out << indexes.value(w, -1);
+            }
+        }
+    }
+}
+
+bool Airac::readCache(QDataStream& in) {
+    FixTable newFixes;
+    QVector<NavAid*> newNavaidList;
+    QHash<QString, QSet<NavAid*> > newNavaids;
+    QHash<QString, QList<Airway*> > newAirways;
+    auto cleanup = [&]() {
+        newFixes.deleteWaypoints();
+        qDeleteAll(newNavaidList);
+        foreach (const QList<Airway*> &al, newAirways) {
+            qDeleteAll(al);
+        }
+        return false;
+    };
+
+    qint32 count;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString id, regionCode;
+        float lat, lon;
+        in >> id >> regionCode >> lat >> lon;
+        newFixes.append(id, regionCode, lat, lon);
+    }
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        NavAid* n = new NavAid(in);
+        newNavaids[n->id].insert(n);
+        newNavaidList.append(n);
+    }
+
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString name;
+        qint32 airwayCount;
+        in >> name >> airwayCount;
+        QList<Airway*> &list = newAirways[name];
+        for (qint32 j = 0; j < airwayCount && in.status() == QDataStream::Ok; j++) {
+            qint32 waypointCount;
+            in >> waypointCount;
+            QList<Waypoint*> waypoints;
+            for (qint32 k = 0; k < waypointCount; k++) {
+                qint32 index;
+                in >> index;
+                if (index < 0 || index >= newFixes.size() + newNavaidList.size()) {
+                    return cleanup();
+                }
+                waypoints.append(
+                    index < newFixes.size()
+                    ? newFixes.waypoint(index)
+                    : newNavaidList[index - newFixes.size()]
+                );
+            }
+            list.append(new Airway(name, waypoints));
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        return cleanup();
+    }
+    fixes = newFixes;
+    navaids = newNavaids;
+    airways = newAirways;
+    qDebug() << "Read" << fixes.size() << "fixes," << navaids.size() << "navaids,"
+             << airways.size() << "airways from cache";
+    return true;
+}
+
 Waypoint* Airac::waypoint(const QString &id, const QString &regionCode, const int &type) const {
     if (type == 11) {
-        foreach (Waypoint* w, fixes.value(id)) {
-            if (w->regionCode == regionCode) {
-                return w;
-            }
+        const int row = fixes.row(id, regionCode);
+        if (row != -1) {
+            return fixes.waypoint(row);
         }
     } else {
         foreach (NavAid* n, navaids.value(id)) {
@@ -286,7 +444,9 @@ Waypoint* Airac::waypoint(const QString &id, const QString &regionCode, const in
  * find a waypoint that is near the given location with the given maximum distance.
  * @returns 0 if none found
  **/
-Waypoint* Airac::waypointNearby(const QString& input, double lat, double lon, double maxDist = 20000.) {
+Waypoint* Airac::waypointNearby(
+    const QString& input, double lat, double lon, double maxDist, QList<Waypoint*>* synthesized
+) {
     // @todo clean this up
     // @todo add "virtual" fixes (ARINC424) to our nav database upfront instead of returning them
     // here dynamically (without adding them), which leads to duplicates
@@ -301,13 +461,17 @@ Waypoint* Airac::waypointNearby(const QString& input, double lat, double lon, do
             minDist = d;
         }
     }
-    foreach (Waypoint* w, fixes[input]) {
-        double d = NavData::distance(lat, lon, w->lat, w->lon);
+    int fixRow = -1;
+    for (int row = fixes.firstRow(input); row != -1; row = fixes.nextRow(row)) {
+        double d = NavData::distance(lat, lon, fixes.lat(row), fixes.lon(row));
         if ((d < minDist) && (d < maxDist)) {
-            result = w;
+            fixRow = row;
             minDist = d;
         }
     }
+    if (fixRow != -1) {
+        result = fixes.waypoint(fixRow);
+    }
     if (NavData::instance()->airports.contains(input)) { // trying aerodromes
         double d = NavData::distance(
             lat, lon,
@@ -315,28 +479,12 @@ Waypoint* Airac::waypointNearby(const QString& input, double lat, double lon, do
             NavData::instance()->airports.value(input)->lon
         );
         if ((d < minDist) && (d < maxDist)) {
-            result = new Waypoint(
-                input, NavData::instance()->airports.value(input)->lat,
-                NavData::instance()->airports.value(input)->lon
-            );
+            result = NavData::instance()->airports.value(input)->routeWaypoint();
             minDist = d;
         }
     }
 
     if (result == 0) { // trying generic formats
-        QRegExp eurocontrol("(\\d{2})"
-            "((\\d{2})?)"
-            "((\\d{2})?)"
-            "([NS])"
-            "(\\d{2,3})"
-            "((\\d{2})?)"
-            "((\\d{2})?)"
-            "([EW])"); // things that are valid for the Eurocontrol route validator:
-        // 63N005W or 6330N00530W (minutes) or 633000N0053000W (minutes and seconds)
-        // we are not strict and also allow 2-char longitudes like 63N05W
-        QRegExp slash("([\\-]?\\d{2})/([\\-]?\\d{2,3})"); // some pilots
-        // ..like to use non-standard: -53/170
-
         double foundLat = -180., foundLon = -360.;
 
         const QPair<double, double>* arincP = NavData::fromArinc(input);
@@ -347,8 +495,8 @@ Waypoint* Airac::waypointNearby(const QString& input, double lat, double lon, do
                 foundLon = arincP->second;
             }
             delete arincP;
-        } else if (eurocontrol.exactMatch(input)) {
-            auto capturedTexts = eurocontrol.capturedTexts();
+        } else if (const auto eurocontrol = RouteTokenizer::eurocontrolRegExp.match(input); eurocontrol.hasMatch()) {
+            const auto capturedTexts = eurocontrol.capturedTexts();
 
             double wLat = capturedTexts[1].toDouble() + capturedTexts[2].toDouble() / 60. + capturedTexts[4].toDouble() / 3600.;
             double wLon = capturedTexts[7].toDouble() + capturedTexts[8].toDouble() / 60. + capturedTexts[10].toDouble() / 3600.;
@@ -363,8 +511,8 @@ Waypoint* Airac::waypointNearby(const QString& input, double lat, double lon, do
                 foundLat = wLat;
                 foundLon = wLon;
             }
-        } else if (slash.exactMatch(input)) { // slash-style: 35/30
-            auto capturedTexts = slash.capturedTexts();
+        } else if (const auto slash = RouteTokenizer::slashRegExp.match(input); slash.hasMatch()) { // slash-style: 35/30
+            const auto capturedTexts = slash.capturedTexts();
             double wLat = capturedTexts[1].toDouble();
             double wLon = capturedTexts[2].toDouble();
             double d = NavData::distance(lat, lon, wLat, wLon);
@@ -381,16 +529,17 @@ Waypoint* Airac::waypointNearby(const QString& input, double lat, double lon, do
                 foundId = NavData::toEurocontrol(foundLat, foundLon);
             }
             if (fixes.contains(foundId)) {
-                auto founds = fixes.value(foundId).values();
-                if (founds.size() > 0) {
-                    return founds.at(0);
-                }
+                return fixes.waypoint(fixes.firstRow(foundId));
             }
 
-            result = new Waypoint(foundId, foundLat, foundLon);
-            // we add it to our database
-            // @todo consider if this is a good idea here
-            fixes[foundId].insert(result);
+            if (synthesized != 0) {
+                result = new Waypoint(foundId, foundLat, foundLon);
+                synthesized->append(result);
+            } else {
+                // we add it to our database
+                // @todo consider if this is a good idea here
+                result = fixes.waypoint(fixes.append(foundId, QString(), foundLat, foundLon));
+            }
         }
     }
 
@@ -448,7 +597,9 @@ void Airac::addAirwaySegment(Waypoint* from, Waypoint* to, const QString& name)
  *
  * Unknown fixes and/or airways will be ignored.
  **/
-QList<Waypoint*> Airac::resolveFlightplan(QStringList plan, double lat, double lon, double maxDist) {
+QList<Waypoint*> Airac::resolveFlightplan(
+    QStringList plan, double lat, double lon, double maxDist, QList<Waypoint*>* synthesized
+) {
     QList<Waypoint*> result;
     Waypoint* currPoint = 0;
     Airway* awy = 0;
@@ -464,7 +615,7 @@ QList<Waypoint*> Airac::resolveFlightplan(QStringList plan, double lat, double l
             // have airway - next should be a waypoint
             QString endId = fpTokenToWaypoint(plan.first());
 
-            Waypoint* wp = waypointNearby(endId, lat, lon, maxDist);
+            Waypoint* wp = waypointNearby(endId, lat, lon, maxDist, synthesized);
             if (wp != 0) {
                 if (currPoint != 0) {
                     auto _expand = awy->expand(currPoint->id, wp->id);
@@ -478,15 +629,15 @@ QList<Waypoint*> Airac::resolveFlightplan(QStringList plan, double lat, double l
             }
         } else if (awy == 0) {
             if (!plan.isEmpty()) { // joining with the next point for idiot style..
-                if (
-                    QRegExp("\\d{2,4}[NS]").exactMatch(id) //.. 30(00)N (0)50(00)W
-                    && QRegExp("(\\d{2,3}|\\d{5})[EW]").exactMatch(plan.first())
+                if ( //.. 30(00)N (0)50(00)W
+                    RouteTokenizer::isLatitudeHalf(id)
+                    && RouteTokenizer::isLongitudeHalf(plan.first())
                 ) {
                     id += fpTokenToWaypoint(plan.takeFirst());
                 }
             }
 
-            Waypoint* wp = waypointNearby(id, lat, lon, maxDist);
+            Waypoint* wp = waypointNearby(id, lat, lon, maxDist, synthesized);
             if (wp != 0) {
                 result.append(wp);
                 currPoint = wp;
@@ -501,6 +652,16 @@ QList<Waypoint*> Airac::resolveFlightplan(QStringList plan, double lat, double l
 }
 
 QString Airac::fpTokenToWaypoint(QString token) const {
+    if (RouteTokenizer::isSlashCoordinate(token)) {
+        return token;
+    }
     // remove everything following an invalid character (e.g. "/N320F240", "/S1130K400")
-    return token.replace(QRegExp("[^A-Za-z0-9].*$"), "");
+    for (int i = 0; i < token.size(); i++) {
+        const QChar c = token[i];
+        if (!((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))) {
+            token.truncate(i);
+            break;
+        }
+    }
+    return token;
 }
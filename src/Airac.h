@@ -2,9 +2,16 @@
 #define AIRAC_H_
 
 #include "Airway.h"
+#include "FixTable.h"
 #include "NavAid.h"
 #include "Waypoint.h"
 
+// a waypoint adjacent to another one on an airway
+struct AirwayNeighbour {
+    Airway* airway;
+    Waypoint* waypoint;
+};
+
 class Airac
     : public QObject {
     Q_OBJECT
@@ -19,15 +26,22 @@ class Airac
         virtual ~Airac();
 
         Waypoint* waypoint(const QString &id, const QString &regionCode, const int &type) const;
-        Waypoint* waypointNearby(const QString &id, double lat, double lon, double maxDist);
+        // coordinates without a fix are added to the fixes, or to synthesized if given (owned by the caller)
+        Waypoint* waypointNearby(
+            const QString &id, double lat, double lon, double maxDist, QList<Waypoint*>* synthesized = 0
+        );
 
         Airway* airway(const QString& name);
         Airway* airwayNearby(const QString& name, double lat, double lon) const;
+        // airway graph: built on load()
+        QList<Airway*> airwaysOf(const Waypoint* w) const;
+        QList<AirwayNeighbour> neighbours(const Waypoint* w) const;
 
-        QList<Waypoint*> resolveFlightplan(QStringList plan, double lat, double lon, double maxDist);
+        QList<Waypoint*> resolveFlightplan(
+            QStringList plan, double lat, double lon, double maxDist, QList<Waypoint*>* synthesized = 0
+        );
 
-        QSet<Waypoint*> allPoints;
-        QHash<QString, QSet<Waypoint*> > fixes;
+        FixTable fixes;
         QHash<QString, QSet<NavAid*> > navaids;
         QHash<QString, QList<Airway*> > airways;
     public slots:
@@ -35,11 +49,19 @@ class Airac
     signals:
         void loaded();
     private:
+        friend class Benchmark;
+
         Airac();
         void readFixes(const QString &directory);
         void readNavaids(const QString &directory);
         void readAirways(const QString &directory);
+        bool readCache(QDataStream& in);
+        void writeCache(QDataStream& out) const;
         void addAirwaySegment(Waypoint* from, Waypoint* to, const QString &name);
+        void buildAirwayGraph();
+
+        QHash<const Waypoint*, QList<Airway*> > _waypointAirways;
+        QHash<const Waypoint*, QList<AirwayNeighbour> > _waypointNeighbours;
 
         QString fpTokenToWaypoint(QString token) const;
 };
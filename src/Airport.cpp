@@ -3,6 +3,7 @@
 #include "helpers.h"
 #include "NavData.h"
 #include "Settings.h"
+#include "Waypoint.h"
 #include "dialogs/AirportDetails.h"
 #include "src/mustache/Renderer.h"
 
@@ -36,6 +37,18 @@ Airport::Airport(const QStringList& list, unsigned int debugLineNumber)
     lon = list[5].toDouble();
 }
 
+Airport::Airport(QDataStream &in)
+    : MapObject(),
+      _appDisplayList(0), _twrDisplayList(0), _gndDisplayList(0), _delDisplayList(0) {
+    resetWhazzupStatus();
+
+    in >> id >> name >> city >> countryCode >> lat >> lon;
+}
+
+void Airport::writeTo(QDataStream &out) const {
+    out << id << name << city << countryCode << lat << lon;
+}
+
 Airport::~Airport() {
     MustacheQs::Renderer::teardownContext(this);
 
@@ -51,6 +64,8 @@ Airport::~Airport() {
     if (_delDisplayList != 0 && glIsList(_delDisplayList) == GL_TRUE) {
         glDeleteLists(_delDisplayList, 1);
     }
+
+    delete _routeWaypoint;
 }
 
 void Airport::resetWhazzupStatus() {
@@ -445,6 +460,13 @@ const GLuint& Airport::delDisplayList() {
     return _delDisplayList;
 }
 
+Waypoint* Airport::routeWaypoint() {
+    if (_routeWaypoint == 0) {
+        _routeWaypoint = new Waypoint(id, lat, lon);
+    }
+    return _routeWaypoint;
+}
+
 void Airport::showDetailsDialog() {
     AirportDetails* infoDialog = AirportDetails::instance();
     infoDialog->refresh(this);
@@ -18,6 +18,7 @@ class Airport
         static const QRegularExpression pdcRegExp;
 
         Airport(const QStringList &list, unsigned int debugLineNumber = 0);
+        Airport(QDataStream &in); // see writeTo()
         virtual ~Airport();
 
         virtual bool matches(const QRegExp& regex) const override;
@@ -41,6 +42,8 @@ class Airport
         const QString frequencyString() const;
         const QString pdcString(const QString& prepend = "", bool alwaysWithIdentifier = true) const;
 
+        void writeTo(QDataStream &out) const;
+
         void resetWhazzupStatus();
 
         QSet<Controller*> allControllers() const;
@@ -60,15 +63,20 @@ class Airport
         const GLuint& gndDisplayList();
         const GLuint& delDisplayList();
 
+        // the airport as first or last point of routes, owned by the airport
+        Waypoint* routeWaypoint();
+
         Metar metar;
         QString id, name, city, countryCode;
         bool showRoutes = false;
         bool active;
+        quint64 labelPriority = 0; // stable pseudo-random order of inactive airport labels, see NavData::loadAirports()
     private:
         void appGl(const QColor &middleColor, const QColor &marginColor, const QColor &borderColor, const GLfloat &borderLineWidth) const;
         void twrGl(const QColor &middleColor, const QColor &marginColor, const QColor &borderColor, const GLfloat &borderLineWidth) const;
 
         GLuint _appDisplayList = 0, _twrDisplayList = 0, _gndDisplayList = 0, _delDisplayList = 0;
+        Waypoint* _routeWaypoint = 0;
 };
 
 #endif
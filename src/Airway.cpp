@@ -16,81 +16,71 @@ Airway::Airway(const QString& name) {
     this->name = name;
 }
 
+Airway::Airway(const QString& name, const QList<Waypoint*>& waypoints)
+    : name(name), _waypoints(waypoints) {}
+
 void Airway::addSegment(Waypoint* from, Waypoint* to) {
-    Segment newSegment(from, to);
     // check if we already have this segment
-    for (int i = 0; i < _segments.size(); i++) {
-        if (_segments[i].from == newSegment.from && _segments[i].to == newSegment.to) {
-            return;
-        }
+    const QPair<Waypoint*, Waypoint*> key(from, to);
+    if (_segmentKeys.contains(key)) {
+        return;
     }
-    _segments.append(newSegment);
+    _segmentKeys.insert(key);
+    _segments.append(Segment(from, to));
 }
 
-Airway* Airway::createFromSegments() {
-    if (_segments.isEmpty()) {
-        return 0;
-    }
+/**
+ * Chains the segments into continuous airways, consuming them. Chains are
+ * extended greedily at both ends, so segments left over at branches start
+ * additional airways. Runs in O(segments) using a waypoint -> segments map.
+ */
+QList<Airway*> Airway::sort() {
+    QList<Airway*> result;
 
-    Airway* result = new Airway(name);
-    Segment seg = _segments.first();
-    _segments.removeFirst();
-    result->_waypoints.append(seg.from);
-    result->_waypoints.append(seg.to);
-
-    bool nothingRemoved = false;
-    while (!_segments.isEmpty() && !nothingRemoved) {
-        nothingRemoved = true;
-
-        for (int i = 0; i < _segments.size() && nothingRemoved; i++) {
-            Segment s = _segments[i];
-            Waypoint* p = result->_waypoints.last();
-
-            if (s.from == p) {
-                result->_waypoints.append(s.to);
-                _segments.removeAt(i);
-                nothingRemoved = false;
-                continue;
-            }
-            if (s.to == p) {
-                result->_waypoints.append(s.from);
-                _segments.removeAt(i);
-                nothingRemoved = false;
-                continue;
-            }
-
-            p = result->_waypoints.first();
-            if (s.from == p) {
-                result->_waypoints.prepend(s.to);
-                _segments.removeAt(i);
-                nothingRemoved = false;
-                continue;
-            }
-            if (s.to == p) {
-                result->_waypoints.prepend(s.from);
-                _segments.removeAt(i);
-                nothingRemoved = false;
-                continue;
-            }
-        }
+    QHash<Waypoint*, QVector<int> > adjacent;
+    adjacent.reserve(_segments.size() + 1);
+    for (int i = 0; i < _segments.size(); i++) {
+        adjacent[_segments[i].from].append(i);
+        adjacent[_segments[i].to].append(i);
     }
+    QVector<bool> used(_segments.size(), false);
+    // all segments before the cursor of a waypoint are used
+    QHash<Waypoint*, int> cursors;
+    cursors.reserve(adjacent.size());
+    auto nextUnused = [&](Waypoint* p) {
+        const QVector<int> &candidates = adjacent[p];
+        int &cursor = cursors[p];
+        while (cursor < candidates.size() && used[candidates[cursor]]) {
+            cursor++;
+        }
+        return cursor < candidates.size()? candidates[cursor]: -1;
+    };
 
-    return result;
-}
+    for (int first = 0; first < _segments.size(); first++) {
+        if (used[first]) {
+            continue;
+        }
+        used[first] = true;
+        Airway* awy = new Airway(name);
+        awy->_waypoints.append(_segments[first].from);
+        awy->_waypoints.append(_segments[first].to);
+
+        for (int i = nextUnused(awy->_waypoints.last()); i != -1; i = nextUnused(awy->_waypoints.last())) {
+            used[i] = true;
+            const Segment &s = _segments[i];
+            awy->_waypoints.append(s.from == awy->_waypoints.last()? s.to: s.from);
+        }
+        for (int i = nextUnused(awy->_waypoints.first()); i != -1; i = nextUnused(awy->_waypoints.first())) {
+            used[i] = true;
+            const Segment &s = _segments[i];
+            awy->_waypoints.prepend(s.from == awy->_waypoints.first()? s.to: s.from);
+        }
 
-QList<Airway*> Airway::sort() {
-    QList<Airway*> result;
-    if (_segments.isEmpty()) {
-        return result;
+        result.append(awy);
     }
-    Airway* awy = 0;
-    do {
-        awy = createFromSegments();
-        if (awy != 0) {
-            result.append(awy);
-        }
-    } while (awy != 0);
 
+    _segments.clear();
+    _segmentKeys.clear();
     return result;
 }
 
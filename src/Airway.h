@@ -6,6 +6,7 @@
 class Airway {
     public:
         Airway(const QString& name);
+        Airway(const QString& name, const QList<Waypoint*>& waypoints); // already sorted
         virtual ~Airway() {}
 
         QList<Waypoint*> waypoints() const;
@@ -28,9 +29,8 @@ class Airway {
         };
 
         QList<Segment> _segments;
+        QSet<QPair<Waypoint*, Waypoint*> > _segmentKeys;
         QList<Waypoint*> _waypoints;
-
-        Airway* createFromSegments();
 };
 
 #endif /* AIRWAY_H_ */
@@ -0,0 +1,1261 @@
+#include "Benchmark.h"
+
+#include "Airac.h"
+#include "BookedController.h"
+#include "BookingIndex.h"
+#include "GeoIndex.h"
+#include "GeoPoints.h"
+#include "LabelPlacer.h"
+#include "NavData.h"
+#include "NavDataCache.h"
+#include "OrderedSet.h"
+#include "Pilot.h"
+#include "RouteTokenizer.h"
+#include "SearchIndex.h"
+#include "SearchVisitor.h"
+#include "Settings.h"
+#include "WhazzupArchive.h"
+#include "WhazzupData.h"
+#include "src/mustache/Renderer.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+const QStringList Benchmark::names = {
+    "whazzup-stream", // WhazzupData parse using JsonPullReader
+    "whazzup-dom", // WhazzupData parse using QJsonDocument
+    "geo-index", // GeoIndex queries vs. linear scans on random points
+    "navdata-load", // NavData + Airac startup load, cold vs. NavDataCache hit
+    "airway-load", // Airac::readAirways on earth_awy.dat and Airway::sort scaling
+    "route-tokenizer", // RouteTokenizer checks, then throughput vs. the former QRegExp split
+    "label-placement", // LabelPlacer vs. linear overlap checks for N synthetic labels
+    "label-render", // pilot label templates: parsed per call vs. compiled vs. memoized
+    "route-refresh", // heap growth check: repeated Whazzup refreshes resolving all routes
+    "used-waypoints", // waypoints of all routes (show all routes): QList vs. OrderedSet dedup
+    "geodesy", // GeoPoints batch geodesy vs. scalar NavData functions: accuracy, then throughput
+    "warp", // predicted WhazzupData per warp step: one thread vs. all cores
+    "search", // search dock on airports and airlines: SearchVisitor vs. SearchIndex while typing
+    "bookings", // BookingIndex vs. linear scans on N synthetic bookings: warp time slices and scrub deltas
+    "whazzup-archive", // WhazzupArchive of the given Whazzup files: size vs. raw JSON, append and seek times
+};
+
+int Benchmark::run(const QString& name, const QStringList& args) {
+    if (name == "whazzup-stream" || name == "whazzup-dom") {
+        return whazzupParse(args, name == "whazzup-stream");
+    }
+    if (name == "geo-index") {
+        return geoIndex();
+    }
+    if (name == "navdata-load") {
+        return navdataLoad();
+    }
+    if (name == "airway-load") {
+        return airwayLoad(args);
+    }
+    if (name == "route-tokenizer") {
+        return routeTokenizer(args);
+    }
+    if (name == "label-placement") {
+        return labelPlacement(args);
+    }
+    if (name == "label-render") {
+        return labelRender(args);
+    }
+    if (name == "route-refresh") {
+        return routeRefresh(args);
+    }
+    if (name == "used-waypoints") {
+        return usedWaypoints(args);
+    }
+    if (name == "geodesy") {
+        return geodesy();
+    }
+    if (name == "warp") {
+        return warp(args);
+    }
+    if (name == "search") {
+        return search();
+    }
+    if (name == "bookings") {
+        return bookings(args);
+    }
+    if (name == "whazzup-archive") {
+        return whazzupArchive(args);
+    }
+
+    out() << "ERROR: unknown benchmark " << name << ", available: " << names.join(", ") << Qt::endl;
+    return 1;
+}
+
+QTextStream& Benchmark::out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QString Benchmark::formatMs(qint64 nsecs) {
+    return QString("%1ms").arg(nsecs / 1000000., 0, 'f', 2);
+}
+
+static qint64 procStatusKb(const QByteArray& field) {
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.startsWith(field + ":")) {
+            return line.mid(field.size() + 1).simplified().split(' ').value(0).toLongLong();
+        }
+    }
+    return -1;
+}
+
+qint64 Benchmark::currentRss() {
+    return procStatusKb("VmRSS");
+}
+
+qint64 Benchmark::peakRss() {
+    return procStatusKb("VmHWM");
+}
+
+// peak RSS is per process: compare whazzup-stream and whazzup-dom in separate runs
+int Benchmark::whazzupParse(const QStringList& files, bool streaming) {
+    if (files.isEmpty()) {
+        out() << "ERROR: need vatsim-data.json files, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 1;
+    }
+    const int iterations = 10;
+
+    // clients look up sectors, airports and airlines
+    NavData::instance()->load();
+
+    WhazzupData::useStreamingParser = streaming;
+    out() << "# WhazzupData parse (" << (streaming? "streaming": "QJsonDocument") << "), "
+          << iterations << " iterations" << Qt::endl;
+    const qint64 rssBefore = currentRss();
+
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            return 1;
+        }
+        QByteArray bytes = file.readAll();
+
+        QElapsedTimer timer;
+        qint64 min = std::numeric_limits<qint64>::max(), total = 0;
+        int clients = 0;
+        for (int i = 0; i < iterations; i++) {
+            timer.start();
+            WhazzupData data(&bytes, WhazzupData::WHAZZUP);
+            const qint64 elapsed = timer.nsecsElapsed();
+            min = qMin(min, elapsed);
+            total += elapsed;
+            clients = data.pilots.size() + data.bookedPilots.size() + data.controllers.size();
+        }
+        out() << fileName << ": " << bytes.size() / 1024 << "kB, " << clients << " clients, "
+              << "min " << formatMs(min) << ", avg " << formatMs(total / iterations) << Qt::endl;
+    }
+
+    out() << "RSS before " << rssBefore << "kB, peak " << peakRss() << "kB" << Qt::endl;
+    return 0;
+}
+
+int Benchmark::geoIndex() {
+    const int queries = 2000;
+    QRandomGenerator random(42);
+    auto randomLat = [&random]() {
+        return qRadiansToDegrees(qAsin(random.generateDouble() * 2. - 1.)); // uniform on the sphere
+    };
+    auto randomLon = [&random]() {
+        return random.generateDouble() * 360. - 180.;
+    };
+
+    out() << "# GeoIndex, " << queries << " queries per size" << Qt::endl;
+    out() << "points\tbuild\tnearest 3nm: linear / index\tradius 100nm: linear / index" << Qt::endl;
+    int failed = 0;
+    foreach (const int size, QList<int>({ 1000, 10000, 36000, 100000, 300000 })) {
+        QVector<QPair<double, double> > points;
+        points.reserve(size);
+        for (int i = 0; i < size; i++) {
+            points.append({ randomLat(), randomLon() });
+        }
+        QVector<QPair<double, double> > queryPoints;
+        for (int i = 0; i < queries; i++) {
+            queryPoints.append({ randomLat(), randomLon() });
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        GeoIndex<int> index;
+        for (int i = 0; i < size; i++) {
+            index.insert(points[i].first, points[i].second, i);
+        }
+        const qint64 buildNs = timer.nsecsElapsed();
+
+        // same semantics as the former NavData::airportAt()
+        int found = 0;
+        timer.start();
+        foreach (const auto &q, queryPoints) {
+            for (int i = 0; i < size; i++) {
+                if (NavData::distance(points[i].first, points[i].second, q.first, q.second) <= 3.) {
+                    found++;
+                    break;
+                }
+            }
+        }
+        const qint64 nearestLinearNs = timer.nsecsElapsed();
+        int foundIndex = 0;
+        timer.start();
+        foreach (const auto &q, queryPoints) {
+            if (index.nearest(q.first, q.second, 3., -1) != -1) {
+                foundIndex++;
+            }
+        }
+        const qint64 nearestIndexNs = timer.nsecsElapsed();
+
+        int inRadius = 0;
+        timer.start();
+        foreach (const auto &q, queryPoints) {
+            for (int i = 0; i < size; i++) {
+                if (NavData::distance(points[i].first, points[i].second, q.first, q.second) <= 100.) {
+                    inRadius++;
+                }
+            }
+        }
+        const qint64 radiusLinearNs = timer.nsecsElapsed();
+        int inRadiusIndex = 0;
+        timer.start();
+        foreach (const auto &q, queryPoints) {
+            inRadiusIndex += index.inRadius(q.first, q.second, 100.).size();
+        }
+        const qint64 radiusIndexNs = timer.nsecsElapsed();
+
+        const bool isMismatch = found != foundIndex || inRadius != inRadiusIndex;
+        if (isMismatch) {
+            failed++;
+        }
+        out() << size << "\t" << formatMs(buildNs) << "\t"
+              << formatMs(nearestLinearNs) << " / " << formatMs(nearestIndexNs) << "\t"
+              << formatMs(radiusLinearNs) << " / " << formatMs(radiusIndexNs)
+              << (isMismatch? "\tMISMATCH": "")
+              << Qt::endl;
+    }
+
+    // 180 and -180 are the same meridian, on either edge of a box
+    GeoIndex<int> antimeridian;
+    const QList<double> lons({ -180., -179.5, 179.5, 180. });
+    for (int i = 0; i < lons.size(); i++) {
+        antimeridian.insert(0., lons[i], i);
+    }
+    const bool isAntimeridianMismatch = antimeridian.inBox(-10., -180., 10., 180.).size() != 4
+        || antimeridian.inBox(-10., 170., 10., 180.).size() != 3
+        || antimeridian.inBox(-10., -180., 10., -170.).size() != 3
+        || antimeridian.inBox(-10., 175., 10., 185.).size() != 4
+        || antimeridian.inBox(-10., 0., 10., 360.).size() != 4;
+    if (isAntimeridianMismatch) {
+        failed++;
+    }
+    out() << "antimeridian boxes" << (isAntimeridianMismatch? "\tMISMATCH": "") << Qt::endl;
+    return failed == 0? 0: 1;
+}
+
+// loads are repeated on the same singletons, so earlier objects are leaked
+int Benchmark::navdataLoad() {
+    out() << "# NavData + Airac load, navdata "
+          << (Settings::useNavdata()? Settings::navdataDirectory(): "disabled in settings") << Qt::endl;
+    out() << "run\tNavData\tAirac\ttotal" << Qt::endl;
+
+    NavDataCache::removeAll();
+    foreach (const QString &run, QStringList({ "cold (parse + write cache)", "cache hit", "cache hit" })) {
+        QElapsedTimer timer;
+        timer.start();
+        NavData::instance()->load();
+        const qint64 navDataNs = timer.nsecsElapsed();
+        timer.start();
+        Airac::instance()->load();
+        const qint64 airacNs = timer.nsecsElapsed();
+
+        out() << run << "\t" << formatMs(navDataNs) << "\t" << formatMs(airacNs) << "\t"
+              << formatMs(navDataNs + airacNs) << Qt::endl;
+    }
+    out() << "airports " << NavData::instance()->airports.size()
+          << ", sectors " << NavData::instance()->sectors.size()
+          << ", fixes " << Airac::instance()->fixes.size()
+          << " (" << Airac::instance()->fixes.waypoints().size() << " as Waypoint objects)"
+          << ", navaids " << Airac::instance()->navaids.size()
+          << ", airways " << Airac::instance()->airways.size() << Qt::endl;
+    out() << "RSS " << currentRss() << "kB, peak " << peakRss() << "kB" << Qt::endl;
+    return 0;
+}
+
+int Benchmark::airwayLoad(const QStringList& args) {
+    const QString directory = args.value(0, Settings::navdataDirectory());
+    if (!QFile::exists(directory + "/earth_awy.dat")) {
+        out() << "ERROR: need an X-Plane 11 navdata directory containing earth_awy.dat" << Qt::endl;
+        return 1;
+    }
+    const int iterations = 5;
+
+    Airac* airac = Airac::instance();
+    airac->readFixes(directory);
+    airac->readNavaids(directory);
+
+    out() << "# Airac::readAirways " << directory << "/earth_awy.dat, " << iterations << " iterations" << Qt::endl;
+    QElapsedTimer timer;
+    qint64 min = std::numeric_limits<qint64>::max(), total = 0;
+    for (int i = 0; i < iterations; i++) {
+        timer.start();
+        airac->readAirways(directory); // leaks the airways of the previous iteration
+        const qint64 elapsed = timer.nsecsElapsed();
+        min = qMin(min, elapsed);
+        total += elapsed;
+    }
+    int count = 0, segments = 0, longest = 0;
+    foreach (const QList<Airway*> &al, airac->airways) {
+        foreach (const Airway* a, al) {
+            count++;
+            segments += a->waypoints().size() - 1;
+            longest = qMax(longest, a->waypoints().size() - 1);
+        }
+    }
+    out() << airac->airways.size() << " names, " << count << " airways, " << segments << " segments, "
+          << "longest " << longest << " segments" << Qt::endl;
+    out() << "min " << formatMs(min) << ", avg " << formatMs(total / iterations) << Qt::endl;
+
+    // a single airway fed with shuffled segments should scale linearly
+    out() << "# Airway::addSegment + sort, one airway, shuffled segments" << Qt::endl;
+    out() << "segments\ttime" << Qt::endl;
+    QRandomGenerator random(42);
+    int failed = 0;
+    foreach (const int size, QList<int>({ 100, 1000, 10000, 100000 })) {
+        QVector<Waypoint*> points;
+        for (int i = 0; i <= size; i++) {
+            points.append(new Waypoint(QString::number(i), 0., 0.));
+        }
+        QVector<int> order(size);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), random);
+
+        timer.start();
+        Airway airway("BENCH");
+        foreach (const int i, order) {
+            airway.addSegment(points[i], points[i + 1]);
+        }
+        const QList<Airway*> sorted = airway.sort();
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        const bool isMismatch = sorted.size() != 1 || sorted.first()->waypoints().size() != size + 1;
+        if (isMismatch) {
+            failed++;
+        }
+        out() << size << "\t" << formatMs(elapsed)
+              << (isMismatch? "\tMISMATCH": "")
+              << Qt::endl;
+        qDeleteAll(sorted);
+        qDeleteAll(points);
+    }
+    return failed == 0? 0: 1;
+}
+
+int Benchmark::routeTokenizer(const QStringList& files) {
+    typedef RouteTokenizer T;
+    const QList<QPair<QString, QList<T::Token> > > expectations = {
+        { "N0450F350 ABC DCT DEF/N0440F360 UL607 GHI", {
+              { T::SpeedLevel, "N0450F350" }, { T::Fix, "ABC" }, { T::Direct, "DCT" }, { T::Fix, "DEF" },
+              { T::SpeedLevel, "N0440F360" }, { T::Airway, "UL607" }, { T::Fix, "GHI" }
+          } },
+        { "m082f370 n906a j804r l9 kok1a", {
+              { T::SpeedLevel, "M082F370" }, { T::Airway, "N906A" }, { T::Airway, "J804R" },
+              { T::Airway, "L9" }, { T::Fix, "KOK1A" }
+          } },
+        { "ABC/K0900S1220 6J0 85TN", {
+              { T::Fix, "ABC" }, { T::SpeedLevel, "K0900S1220" }, { T::Fix, "6J0" }, { T::Fix, "85TN" }
+          } },
+        { "5530N02000W 40N020W 5530N 53N60 5250N/04000W 30N 050W", {
+              { T::Coordinate, "5530N02000W" }, { T::Coordinate, "40N020W" }, { T::Coordinate, "5530N" },
+              { T::Coordinate, "53N60" }, { T::Coordinate, "5250N04000W" }, { T::Coordinate, "30N050W" }
+          } },
+        { "59/20 -53/170 35/-30", {
+              { T::Coordinate, "59/20" }, { T::Coordinate, "-53/170" }, { T::Coordinate, "35/-30" }
+          } },
+        { "MARUN6F/25C ILS 07 ESSA/19R 30N", {
+              { T::Fix, "MARUN6F" }, { T::Other, "25C" }, { T::Fix, "ILS" }, { T::Other, "07" },
+              { T::Fix, "ESSA" }, { T::Other, "19R" }, { T::Other, "30N" }
+          } },
+        { "  +PIE,V441.LAL-ABC*X  ", {
+              { T::Fix, "PIE" }, { T::Airway, "V441" }, { T::Fix, "LAL" }, { T::Fix, "ABC" }
+          } },
+        { "", {} },
+    };
+
+    int failures = 0;
+    for (const auto &expectation: expectations) {
+        const QList<T::Token> tokens = RouteTokenizer::tokenize(expectation.first);
+        bool ok = tokens.size() == expectation.second.size();
+        for (int i = 0; ok && i < tokens.size(); i++) {
+            ok = tokens[i].type == expectation.second[i].type && tokens[i].text == expectation.second[i].text;
+        }
+        if (!ok) {
+            failures++;
+            QStringList got;
+            foreach (const T::Token &token, tokens) {
+                got.append(RouteTokenizer::typeName(token.type) + ":" + token.text);
+            }
+            out() << "FAIL \"" << expectation.first << "\": " << got.join(" ") << Qt::endl;
+        }
+    }
+    out() << "# RouteTokenizer checks: " << expectations.size() - failures << "/" << expectations.size() << " passed" << Qt::endl;
+    if (failures > 0) {
+        return 1;
+    }
+
+    if (files.isEmpty()) {
+        out() << "need vatsim-data.json files for the throughput test, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 0;
+    }
+    QStringList routes;
+    qint64 bytes = 0;
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            return 1;
+        }
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+        foreach (const QString &key, QStringList({ "pilots", "prefiles" })) {
+            foreach (const QJsonValue &client, document.object()[key].toArray()) {
+                const QString route = client.toObject()["flight_plan"].toObject()["route"].toString();
+                if (!route.isEmpty()) {
+                    routes.append(route);
+                    bytes += route.size();
+                }
+            }
+        }
+    }
+
+    const int iterations = 20;
+    QElapsedTimer timer;
+    int legacyParts = 0;
+    timer.start();
+    for (int i = 0; i < iterations; i++) {
+        foreach (const QString &route, routes) {
+            // the former Pilot::waypoints() split, regex compiled per call
+            legacyParts += route.toUpper().split(
+                QRegExp(
+                    "[\\s\\-+.,/]|"
+                    "\\b(?:[MNAFSMK]\\d{3,4}){2,}\\b|"
+                    "\\b\\d{2}\\D?\\b|"
+                    "DCT"
+                ),
+                Qt::SkipEmptyParts
+            ).size();
+        }
+    }
+    const qint64 legacyNs = timer.nsecsElapsed();
+
+    int tokens = 0;
+    timer.start();
+    for (int i = 0; i < iterations; i++) {
+        foreach (const QString &route, routes) {
+            tokens += RouteTokenizer::waypointTokens(route).size();
+        }
+    }
+    const qint64 tokenizerNs = timer.nsecsElapsed();
+
+    out() << "# " << routes.size() << " routes, " << bytes / 1024 << "k chars, " << iterations << " iterations" << Qt::endl;
+    out() << "QRegExp split:  " << formatMs(legacyNs / iterations) << " per pass, "
+          << legacyParts / iterations << " parts" << Qt::endl;
+    out() << "RouteTokenizer: " << formatMs(tokenizerNs / iterations) << " per pass, "
+          << tokens / iterations << " waypoint tokens, "
+          << QString::number(routes.size() * iterations * 1e9 / qMax<qint64>(tokenizerNs, 1), 'f', 0) << " routes/s"
+          << Qt::endl;
+    return 0;
+}
+
+// like GLWidget::renderLabels(): 2 frames, the second one keeping the positions of the first
+int Benchmark::labelPlacement(const QStringList& args) {
+    const QSize screen(1920, 1080);
+    QList<int> sizes({ 500, 2000, 5000, 20000 });
+    if (!args.isEmpty()) {
+        sizes = { args.first().toInt() };
+    }
+
+    out() << "# label placement on " << screen.width() << "x" << screen.height()
+          << ", above/right/below/left candidates" << Qt::endl;
+    out() << "labels	placed	frame 1: linear / grid	frame 2 (sticky): linear / grid" << Qt::endl;
+    int failed = 0;
+    foreach (const int size, sizes) {
+        QRandomGenerator random(42);
+        QVector<MapObject*> objects;
+        QVector<QRectF> labelRects;
+        for (int i = 0; i < size; i++) {
+            objects.append(new MapObject());
+            const QSizeF labelSize(40 + random.bounded(80), 14 + random.bounded(26));
+            const QPointF anchor(random.bounded(screen.width()), random.bounded(screen.height()));
+            labelRects.append(QRectF(anchor - QPointF(labelSize.width() / 2, labelSize.height() + 8), labelSize));
+        }
+        auto candidates = [](const QRectF& rect) {
+            const int distanceFromPos = 8;
+            return QVector<QRectF>({
+                rect,
+                rect.translated(rect.width() / 2 + distanceFromPos, rect.height() / 2 + distanceFromPos),
+                rect.translated(0, rect.height() + 2 * distanceFromPos),
+                rect.translated(-rect.width() / 2 - distanceFromPos, rect.height() / 2 + distanceFromPos),
+            });
+        };
+
+        // former implementation: scan all placed labels
+        struct Placed {
+            MapObject* object;
+            QRectF rect;
+        };
+        QVector<Placed> placedLinear;
+        auto frameLinear = [&]() {
+            for (int i = 0; i < size; i++) {
+                bool isPlaced = false;
+                for (int p = 0; p < placedLinear.size(); p++) {
+                    if (placedLinear[p].object == objects[i]) {
+                        const Placed previous = placedLinear.takeAt(p);
+                        placedLinear.append(previous);
+                        isPlaced = true;
+                        break;
+                    }
+                }
+                if (isPlaced) {
+                    continue;
+                }
+                foreach (const QRectF &candidate, candidates(labelRects[i])) {
+                    bool isFree = true;
+                    foreach (const Placed &p, placedLinear) {
+                        if (candidate.intersects(p.rect)) {
+                            isFree = false;
+                            break;
+                        }
+                    }
+                    if (isFree) {
+                        placedLinear.append({ objects[i], candidate });
+                        break;
+                    }
+                }
+            }
+        };
+
+        LabelPlacer placer;
+        auto frameGrid = [&]() {
+            for (int i = 0; i < size; i++) {
+                QRectF previous;
+                if (placer.take(objects[i], &previous)) {
+                    placer.place(objects[i], previous);
+                    continue;
+                }
+                foreach (const QRectF &candidate, candidates(labelRects[i])) {
+                    if (placer.isFree(candidate)) {
+                        placer.place(objects[i], candidate);
+                        break;
+                    }
+                }
+            }
+        };
+
+        QElapsedTimer timer;
+        timer.start();
+        frameLinear();
+        const qint64 linear1Ns = timer.nsecsElapsed();
+        timer.start();
+        frameLinear();
+        const qint64 linear2Ns = timer.nsecsElapsed();
+        timer.start();
+        frameGrid();
+        const qint64 grid1Ns = timer.nsecsElapsed();
+        timer.start();
+        frameGrid();
+        const qint64 grid2Ns = timer.nsecsElapsed();
+
+        bool isSame = placedLinear.size() == placer.size();
+        foreach (const Placed &p, placedLinear) {
+            isSame = isSame && placer.placements().value(p.object) == p.rect;
+        }
+        if (!isSame) {
+            failed++;
+        }
+
+        out() << size << "\t" << placer.size() << "\t"
+              << formatMs(linear1Ns) << " / " << formatMs(grid1Ns) << "\t"
+              << formatMs(linear2Ns) << " / " << formatMs(grid2Ns)
+              << (isSame? "": "\tMISMATCH") << Qt::endl;
+        qDeleteAll(objects);
+    }
+    return failed == 0? 0: 1;
+}
+
+// the 4 pilot label templates for all pilots of the files, like GLWidget::renderLabels() every frame
+int Benchmark::labelRender(const QStringList& files) {
+    if (files.isEmpty()) {
+        out() << "ERROR: need vatsim-data.json files, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 1;
+    }
+
+    // clients look up airports and airlines
+    NavData::instance()->load();
+
+    QList<WhazzupData*> datas;
+    QList<Pilot*> pilots;
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            qDeleteAll(datas);
+            return 1;
+        }
+        QByteArray bytes = file.readAll();
+        WhazzupData* data = new WhazzupData(&bytes, WhazzupData::WHAZZUP);
+        datas.append(data);
+        pilots += data->allPilots();
+    }
+    const QStringList templates = {
+        Settings::pilotPrimaryContent(),
+        Settings::pilotPrimaryContentHovered(),
+        Settings::pilotSecondaryContent(),
+        Settings::pilotSecondaryContentHovered(),
+    };
+    const int iterations = 10;
+    QElapsedTimer timer;
+
+    // the former MustacheQs::Renderer::render(): parses the template on every call
+    Mustache::Renderer parser;
+    parser.setTagMarkers("{", "}");
+    QStringList parsed;
+    timer.start();
+    for (int i = 0; i < iterations; i++) {
+        parsed.clear();
+        foreach (const Pilot* p, pilots) {
+            MustacheQs::Pilot::Context context(p);
+            foreach (const QString &tmpl, templates) {
+                parsed.append(parser.render(tmpl, &context));
+            }
+        }
+    }
+    const qint64 parsedNs = timer.nsecsElapsed();
+
+    const MustacheQs::Keys &keys = MustacheQs::Pilot::Context::keys();
+    QList<MustacheQs::Template> compiledTemplates;
+    foreach (const QString &tmpl, templates) {
+        compiledTemplates.append(MustacheQs::Template(parser.compile(tmpl, keys.partials), keys));
+    }
+    QStringList compiled;
+    timer.start();
+    for (int i = 0; i < iterations; i++) {
+        compiled.clear();
+        foreach (const Pilot* p, pilots) {
+            foreach (const MustacheQs::Template &compiledTemplate, compiledTemplates) {
+                compiled.append(compiledTemplate.render(p));
+            }
+        }
+    }
+    const qint64 compiledNs = timer.nsecsElapsed();
+
+    QStringList memoized;
+    qint64 firstPassNs = 0;
+    timer.start();
+    for (int i = 0; i < iterations; i++) {
+        memoized.clear();
+        foreach (Pilot* p, pilots) {
+            foreach (const QString &tmpl, templates) {
+                memoized.append(MustacheQs::Renderer::render(tmpl, p));
+            }
+        }
+        if (i == 0) {
+            firstPassNs = timer.restart();
+        }
+    }
+    const qint64 memoizedNs = timer.nsecsElapsed();
+
+    out() << "# " << pilots.size() << " pilots, " << templates.size() << " templates, "
+          << iterations << " iterations" << Qt::endl;
+    out() << "parsed per call: " << formatMs(parsedNs / iterations) << " per pass" << Qt::endl;
+    out() << "compiled:        " << formatMs(compiledNs / iterations) << " per pass"
+          << (compiled != parsed? "\tMISMATCH": "") << Qt::endl;
+    out() << "memoized:        " << formatMs(firstPassNs) << " first pass, "
+          << formatMs(memoizedNs / qMax(1, iterations - 1)) << " per cached pass"
+          << (memoized != parsed? "\tMISMATCH": "") << Qt::endl;
+
+    qDeleteAll(datas);
+    return (compiled == parsed && memoized == parsed)? 0: 1;
+}
+
+// like Whazzup refreshes followed by GLWidget::createPilotsList(). Fails if the heap grows after warmup.
+int Benchmark::routeRefresh(const QStringList& files) {
+    if (files.isEmpty()) {
+        out() << "ERROR: need vatsim-data.json files, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 1;
+    }
+    QList<QByteArray> contents;
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            return 1;
+        }
+        contents.append(file.readAll());
+    }
+
+    NavData::instance()->load();
+    Airac::instance()->load();
+
+    const int refreshes = 50, warmup = 5;
+    const qint64 maxGrowthKb = 4096;
+    WhazzupData live;
+    qint64 rssAfterWarmup = -1;
+    int unstable = 0, waypoints = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < refreshes; i++) {
+        foreach (const QByteArray &content, contents) {
+            QByteArray bytes(content);
+            const WhazzupData data(&bytes, WhazzupData::WHAZZUP);
+            live.updateFrom(data);
+        }
+        waypoints = 0;
+        foreach (Pilot* p, live.allPilots()) {
+            const QList<Waypoint*> route = p->routeWaypointsWithDepDest();
+            // a second call has to return the very same waypoints
+            if (p->routeWaypointsWithDepDest() != route) {
+                unstable++;
+            }
+            waypoints += route.size();
+        }
+        if (i == warmup - 1) {
+            rssAfterWarmup = currentRss();
+        }
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+    const qint64 growthKb = currentRss() - rssAfterWarmup;
+
+    out() << "# " << refreshes << " refreshes of " << files.size() << " files, "
+          << live.allPilots().size() << " pilots, " << waypoints << " route waypoints" << Qt::endl;
+    out() << "per refresh " << formatMs(elapsed / refreshes) << Qt::endl;
+    if (rssAfterWarmup < 0) {
+        out() << "RSS not available on this platform, heap growth not checked" << Qt::endl;
+    } else {
+        out() << "RSS after warmup " << rssAfterWarmup << "kB, growth since " << growthKb << "kB"
+              << (growthKb > maxGrowthKb? "\tFAIL": "") << Qt::endl;
+    }
+    if (unstable > 0) {
+        out() << "FAIL " << unstable << " routes were allocated again on a second call" << Qt::endl;
+    }
+    return (unstable > 0 || (rssAfterWarmup >= 0 && growthKb > maxGrowthKb))? 1: 0;
+}
+
+// the used waypoint collection of GLWidget::createPilotsList() with Settings::showRoutes()
+int Benchmark::usedWaypoints(const QStringList& files) {
+    if (files.isEmpty()) {
+        out() << "ERROR: need vatsim-data.json files, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 1;
+    }
+
+    NavData::instance()->load();
+    Airac::instance()->load();
+
+    QList<WhazzupData*> datas;
+    QList<QList<Waypoint*> > routes;
+    int routePoints = 0;
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            qDeleteAll(datas);
+            return 1;
+        }
+        QByteArray bytes = file.readAll();
+        WhazzupData* data = new WhazzupData(&bytes, WhazzupData::WHAZZUP);
+        datas.append(data);
+        foreach (Pilot* p, data->allPilots()) {
+            if (qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon)) {
+                continue;
+            }
+            routes.append(p->routeWaypointsWithDepDest());
+            routePoints += routes.last().size();
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<MapObject*> list;
+    foreach (const auto &route, routes) {
+        foreach (Waypoint* w, route) {
+            if (!list.contains(w)) {
+                list.append(w);
+            }
+        }
+    }
+    const qint64 listNs = timer.nsecsElapsed();
+
+    timer.start();
+    OrderedSet<MapObject*> set;
+    foreach (const auto &route, routes) {
+        foreach (Waypoint* w, route) {
+            set.insert(w);
+        }
+    }
+    const qint64 setNs = timer.nsecsElapsed();
+
+    out() << "# " << routes.size() << " routes, " << routePoints << " route points, "
+          << set.size() << " used waypoints" << Qt::endl;
+    out() << "QList::contains: " << formatMs(listNs) << Qt::endl;
+    out() << "OrderedSet:      " << formatMs(setNs)
+          << (set.values() != list? "\tMISMATCH": "") << Qt::endl;
+
+    qDeleteAll(datas);
+    return set.values() == list? 0: 1;
+}
+
+int Benchmark::geodesy() {
+    const int size = 100000, queries = 50;
+    QRandomGenerator random(42);
+    auto randomLat = [&random]() {
+        return qRadiansToDegrees(qAsin(random.generateDouble() * 2. - 1.)); // uniform on the sphere
+    };
+    auto randomLon = [&random]() {
+        return random.generateDouble() * 360. - 180.;
+    };
+
+    GeoPoints points, others;
+    QVector<double> fractions;
+    points.reserve(size);
+    others.reserve(size);
+    for (int i = 0; i < size; i++) {
+        points.append(randomLat(), randomLon());
+        others.append(randomLat(), randomLon());
+        fractions.append(random.generateDouble());
+    }
+    QVector<QPair<double, double> > queryPoints;
+    for (int i = 0; i < queries; i++) {
+        queryPoints.append({ randomLat(), randomLon() });
+    }
+
+    // accuracy. Courses are ill-conditioned next to the query point and its antipode.
+    int failed = 0;
+    double maxDistanceError = 0., maxCourseError = 0., maxFractionError = 0.;
+    int nearestMismatches = 0;
+    foreach (const auto &q, queryPoints) {
+        const QVector<double> distances = points.distancesTo(q.first, q.second);
+        const QVector<double> courses = points.coursesFrom(q.first, q.second);
+        int scalarNearest = 0;
+        double minDistance = NavData::distance(q.first, q.second, points.lat(0), points.lon(0));
+        for (int i = 0; i < size; i++) {
+            const double distance = NavData::distance(q.first, q.second, points.lat(i), points.lon(i));
+            maxDistanceError = qMax(maxDistanceError, qAbs(distance - distances[i]));
+            if (distance < minDistance) {
+                minDistance = distance;
+                scalarNearest = i;
+            }
+            if (distance > 1. && distance < 180. * 60. - 1.) {
+                const double course = NavData::courseTo(q.first, q.second, points.lat(i), points.lon(i));
+                const double error = qAbs(course - courses[i]);
+                maxCourseError = qMax(maxCourseError, qMin(error, 360. - error));
+            }
+        }
+        const int nearest = points.nearest(q.first, q.second);
+        if (
+            nearest != scalarNearest
+            && qAbs(distances[nearest] - minDistance) > 1e-6
+        ) {
+            nearestMismatches++;
+        }
+    }
+    const GeoPoints between = GeoPoints::fractions(points, others, fractions);
+    for (int i = 0; i < size; i++) {
+        if (NavData::distance(points.lat(i), points.lon(i), others.lat(i), others.lon(i)) > 180. * 60. - 1.) {
+            continue; // no unique great circle
+        }
+        const auto scalar = NavData::greatCircleFraction(
+            points.lat(i), points.lon(i), others.lat(i), others.lon(i), fractions[i]
+        );
+        maxFractionError = qMax(
+            maxFractionError,
+            NavData::distance(scalar.first, scalar.second, between.lat(i), between.lon(i))
+        );
+    }
+    out() << "# accuracy vs. scalar, " << queries << " x " << size << " points" << Qt::endl;
+    auto check = [&failed](double error, double tolerance) {
+        if (error > tolerance) {
+            failed++;
+            return "\tFAIL";
+        }
+        return "";
+    };
+    out() << "distance: max error " << maxDistanceError << "nm" << check(maxDistanceError, 1e-3) << Qt::endl;
+    out() << "course: max error " << maxCourseError << "deg" << check(maxCourseError, 1e-4) << Qt::endl;
+    out() << "fraction: max error " << maxFractionError << "nm" << check(maxFractionError, 1e-3) << Qt::endl;
+    out() << "nearest: " << nearestMismatches << " mismatches" << check(nearestMismatches, 0) << Qt::endl;
+
+    // throughput
+    QElapsedTimer timer;
+    double sink = 0.;
+    out() << "# throughput, " << queries << " x " << size << " points: scalar / batch" << Qt::endl;
+
+    timer.start();
+    foreach (const auto &q, queryPoints) {
+        for (int i = 0; i < size; i++) {
+            sink += NavData::distance(q.first, q.second, points.lat(i), points.lon(i));
+        }
+    }
+    const qint64 distanceScalarNs = timer.nsecsElapsed();
+    timer.start();
+    foreach (const auto &q, queryPoints) {
+        sink += points.distancesTo(q.first, q.second).last();
+    }
+    out() << "distance: " << formatMs(distanceScalarNs) << " / " << formatMs(timer.nsecsElapsed()) << Qt::endl;
+
+    // like the former Pilot::nextPointOnRoute(): distance() twice for closer points
+    timer.start();
+    foreach (const auto &q, queryPoints) {
+        double minDistance = NavData::distance(q.first, q.second, points.lat(0), points.lon(0));
+        int minPoint = 0;
+        for (int i = 1; i < size; i++) {
+            if (NavData::distance(q.first, q.second, points.lat(i), points.lon(i)) < minDistance) {
+                minDistance = NavData::distance(q.first, q.second, points.lat(i), points.lon(i));
+                minPoint = i;
+            }
+        }
+        sink += minPoint;
+    }
+    const qint64 nearestScalarNs = timer.nsecsElapsed();
+    timer.start();
+    foreach (const auto &q, queryPoints) {
+        sink += points.nearest(q.first, q.second);
+    }
+    out() << "nearest: " << formatMs(nearestScalarNs) << " / " << formatMs(timer.nsecsElapsed()) << Qt::endl;
+
+    timer.start();
+    foreach (const auto &q, queryPoints) {
+        for (int i = 0; i < size; i++) {
+            sink += NavData::courseTo(q.first, q.second, points.lat(i), points.lon(i));
+        }
+    }
+    const qint64 courseScalarNs = timer.nsecsElapsed();
+    timer.start();
+    foreach (const auto &q, queryPoints) {
+        sink += points.coursesFrom(q.first, q.second).last();
+    }
+    out() << "course: " << formatMs(courseScalarNs) << " / " << formatMs(timer.nsecsElapsed()) << Qt::endl;
+
+    timer.start();
+    for (int i = 0; i < size; i++) {
+        sink += NavData::greatCircleFraction(
+            points.lat(i), points.lon(i), others.lat(i), others.lon(i), fractions[i]
+        ).first;
+    }
+    const qint64 fractionScalarNs = timer.nsecsElapsed();
+    timer.start();
+    sink += GeoPoints::fractions(points, others, fractions).lat(size - 1);
+    out() << "fraction (" << size << " pairs): " << formatMs(fractionScalarNs) << " / " << formatMs(timer.nsecsElapsed())
+          << Qt::endl;
+
+    out() << "# checksum " << sink << Qt::endl;
+    return failed == 0? 0: 1;
+}
+
+int Benchmark::warp(const QStringList& files) {
+    if (files.isEmpty()) {
+        out() << "ERROR: need vatsim-data.json files, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 1;
+    }
+    const int steps = 30; // 1 minute each, like "run predict"
+
+    // predictions need the airports
+    NavData::instance()->load();
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    out() << "# predicted WhazzupData, " << steps << " steps of 1min, 1 / " << maxThreadCount << " threads" << Qt::endl;
+    out() << "file	clients	per step: 1 thread min / avg	" << maxThreadCount << " threads min / avg" << Qt::endl;
+    int failed = 0;
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            return 1;
+        }
+        QByteArray bytes = file.readAll();
+        const WhazzupData data(&bytes, WhazzupData::WHAZZUP);
+
+        QHash<QString, QPair<double, double> > serialPositions;
+        qint64 min[2], total[2];
+        bool isMismatch = false;
+        int clients = 0;
+        for (int run = 0; run < 2; run++) {
+            pool->setMaxThreadCount(run == 0? 1: maxThreadCount);
+            min[run] = std::numeric_limits<qint64>::max();
+            total[run] = 0;
+            QElapsedTimer timer;
+            for (int step = 1; step <= steps; step++) {
+                timer.start();
+                const WhazzupData predicted(data.whazzupTime.addSecs(step * 60), data);
+                const qint64 elapsed = timer.nsecsElapsed();
+                min[run] = qMin(min[run], elapsed);
+                total[run] += elapsed;
+                clients = predicted.pilots.size() + predicted.bookedPilots.size() + predicted.controllers.size();
+
+                foreach (const Pilot* p, predicted.pilots) {
+                    const QString key = QString("%1|%2").arg(step).arg(p->callsign);
+                    if (run == 0) {
+                        serialPositions.insert(key, { p->lat, p->lon });
+                    } else if (serialPositions.value(key) != QPair<double, double>(p->lat, p->lon)) {
+                        isMismatch = true;
+                    }
+                }
+            }
+        }
+        pool->setMaxThreadCount(maxThreadCount);
+
+        out() << fileName << "\t" << clients << "\t"
+              << formatMs(min[0]) << " / " << formatMs(total[0] / steps) << "\t"
+              << formatMs(min[1]) << " / " << formatMs(total[1] / steps)
+              << (isMismatch? "\tMISMATCH": "") << Qt::endl;
+        if (isMismatch) {
+            failed++;
+        }
+    }
+    return failed == 0? 0: 1;
+}
+
+int Benchmark::search() {
+    NavData::instance()->load();
+
+    // typing "frankfurt", then wildcards and several terms
+    QStringList terms;
+    for (int i = 1; i <= 9; i++) {
+        terms << QString("frankfurt").left(i);
+    }
+    terms << "ED*" << "EDDF EGLL, KJFK" << "DLH";
+
+    out() << "# search dock on " << NavData::instance()->airports.size() << " airports, "
+          << NavData::instance()->airlines.size() << " airlines" << Qt::endl;
+    out() << "term\tresults\tSearchVisitor\tSearchIndex" << Qt::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+    SearchIndex::instance()->search("x"); // builds the index
+    out() << "(index build)\t\t\t" << formatMs(timer.nsecsElapsed()) << Qt::endl;
+
+    int failed = 0;
+    foreach (const QString &term, terms) {
+        timer.start();
+        SearchVisitor visitor(term);
+        NavData::instance()->accept(&visitor);
+        const QList<MapObject*> visitorResult = visitor.result();
+        const qint64 visitorNs = timer.nsecsElapsed();
+
+        timer.start();
+        const QList<MapObject*> indexResult = SearchIndex::instance()->search(term);
+        const qint64 indexNs = timer.nsecsElapsed();
+
+        // airlines are new MapObjects on each search, so compare labels
+        QStringList visitorLabels, indexLabels;
+        foreach (const MapObject* o, visitorResult) {
+            visitorLabels << o->mapLabel();
+        }
+        foreach (const MapObject* o, indexResult) {
+            indexLabels << o->mapLabel();
+        }
+        visitorLabels.sort();
+        indexLabels.sort();
+
+        out() << term << "\t" << indexResult.size() << "\t" << formatMs(visitorNs) << "\t" << formatMs(indexNs)
+              << (visitorLabels != indexLabels? "\tMISMATCH": "") << Qt::endl;
+        if (visitorLabels != indexLabels) {
+            failed++;
+        }
+    }
+    return failed == 0? 0: 1;
+}
+
+int Benchmark::bookings(const QStringList& args) {
+    const int count = args.value(0, "20000").toInt();
+    const int steps = 24 * 60; // a day in 1 minute warp steps
+
+    // bookings of 30min to 4h over two weeks
+    QRandomGenerator random(42);
+    const QDateTime begin = QDateTime::currentDateTimeUtc();
+    QList<BookedController*> bookings;
+    for (int i = 0; i < count; i++) {
+        const QDateTime starts = begin.addSecs(random.bounded(14 * 24 * 60) * 60);
+        QJsonObject json;
+        json["callsign"] = QString("X%1_CTR").arg(i);
+        json["cid"] = i;
+        json["type"] = "booking";
+        json["start"] = starts.toString("yyyy-MM-dd HH:mm:ss");
+        json["end"] = starts.addSecs((30 + random.bounded(210)) * 60).toString("yyyy-MM-dd HH:mm:ss");
+        bookings.append(new BookedController(json));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    BookingIndex index;
+    index.build(bookings);
+    out() << "# " << count << " bookings, " << steps << " warp steps of 1min" << Qt::endl;
+    out() << "build\t" << formatMs(timer.nsecsElapsed()) << Qt::endl;
+
+    // time slices: linear scan like the former WhazzupData(predictTime, data)
+    const QDateTime sliceBegin = begin.addDays(7);
+    QVector<QSet<int> > linearSlices(steps);
+    timer.start();
+    for (int step = 0; step < steps; step++) {
+        const QDateTime t = sliceBegin.addSecs(step * 60);
+        for (int row = 0; row < bookings.size(); row++) {
+            if (bookings[row]->starts() <= t && bookings[row]->ends() >= t) {
+                linearSlices[step].insert(row);
+            }
+        }
+    }
+    const qint64 linearNs = timer.nsecsElapsed();
+
+    QVector<QSet<int> > indexSlices(steps);
+    timer.start();
+    for (int step = 0; step < steps; step++) {
+        foreach (const int row, index.at(sliceBegin.addSecs(step * 60))) {
+            indexSlices[step].insert(row);
+        }
+    }
+    const qint64 indexNs = timer.nsecsElapsed();
+    int failed = 0;
+    bool isMismatch = indexSlices != linearSlices;
+    if (isMismatch) {
+        failed++;
+    }
+    out() << "time slice\tlinear " << formatMs(linearNs / steps) << "\tindex " << formatMs(indexNs / steps)
+          << "\t(" << linearSlices[steps / 2].size() << " active)" << (isMismatch? "\tMISMATCH": "") << Qt::endl;
+
+    // scrubbing forward and back has to give the same sets
+    isMismatch = false;
+    QSet<int> active = indexSlices[0];
+    timer.start();
+    for (int step = 1; step < steps; step++) {
+        const BookingDelta delta = index.scrub(sliceBegin.addSecs((step - 1) * 60), sliceBegin.addSecs(step * 60));
+        foreach (const int row, delta.left) {
+            active.remove(row);
+        }
+        foreach (const int row, delta.entered) {
+            active.insert(row);
+        }
+        if (active != linearSlices[step]) {
+            isMismatch = true;
+        }
+    }
+    const qint64 scrubNs = timer.nsecsElapsed();
+    const BookingDelta back = index.scrub(sliceBegin.addSecs((steps - 1) * 60), sliceBegin);
+    foreach (const int row, back.left) {
+        active.remove(row);
+    }
+    foreach (const int row, back.entered) {
+        active.insert(row);
+    }
+    isMismatch = isMismatch || active != linearSlices[0];
+    if (isMismatch) {
+        failed++;
+    }
+    out() << "scrub delta\t\tindex " << formatMs(scrubNs / (steps - 1)) << (isMismatch? "\tMISMATCH": "") << Qt::endl;
+
+    // bookings dialog: 6 hours from now
+    const QDateTime from = begin.addDays(3), to = from.addSecs(6 * 3600);
+    int linearCount = 0;
+    timer.start();
+    foreach (const BookedController* bc, bookings) {
+        if (bc->starts() <= to && bc->ends() >= from) {
+            linearCount++;
+        }
+    }
+    const qint64 linearRangeNs = timer.nsecsElapsed();
+    timer.start();
+    const int indexCount = index.overlapping(from, to).size();
+    const qint64 indexRangeNs = timer.nsecsElapsed();
+    out() << "6h range\tlinear " << formatMs(linearRangeNs) << "\tindex " << formatMs(indexRangeNs)
+          << "\t(" << indexCount << " bookings)" << (linearCount != indexCount? "\tMISMATCH": "") << Qt::endl;
+
+    if (linearCount != indexCount) {
+        failed++;
+    }
+
+    qDeleteAll(bookings);
+    return failed == 0? 0: 1;
+}
+
+int Benchmark::whazzupArchive(const QStringList& files) {
+    if (files.isEmpty()) {
+        out() << "ERROR: need vatsim-data.json files, e.g. tests/fixtures/*/vatsim-data.json" << Qt::endl;
+        return 1;
+    }
+    QTemporaryDir directory;
+    WhazzupArchive archive(directory.filePath("benchmark.whazzups"));
+
+    // the files as consecutive snapshots, 2 minutes apart
+    const QDateTime begin = QDateTime::currentDateTimeUtc();
+    QList<QByteArray> documents;
+    qint64 rawBytes = 0, appendNs = 0;
+    QElapsedTimer timer;
+    foreach (const QString &fileName, files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            out() << "ERROR: could not open " << fileName << Qt::endl;
+            return 1;
+        }
+        documents.append(file.readAll());
+        rawBytes += documents.last().size();
+        timer.start();
+        if (!archive.append(begin.addSecs(120 * (documents.size() - 1)), documents.last())) {
+            out() << "ERROR: could not append " << fileName << Qt::endl;
+            return 1;
+        }
+        appendNs += timer.nsecsElapsed();
+    }
+    out() << "# " << documents.size() << " snapshots" << Qt::endl;
+    out() << "size\traw JSON " << rawBytes / 1024 << "kB\tarchive " << QFileInfo(archive.fileName()).size() / 1024 << "kB"
+          << Qt::endl;
+    out() << "append\t" << formatMs(appendNs / documents.size()) << " per snapshot" << Qt::endl;
+
+    // a new instance reads the time index from disk
+    timer.start();
+    WhazzupArchive reopened(archive.fileName());
+    const int size = reopened.size();
+    out() << "index\t" << formatMs(timer.nsecsElapsed()) << Qt::endl;
+
+    // seeking in random order, then stepping forward like "run predict"
+    QRandomGenerator random(42);
+    bool isMismatch = false;
+    qint64 seekNs = 0, stepNs = 0;
+    for (int run = 0; run < 2; run++) {
+        for (int n = 0; n < size; n++) {
+            const int i = run == 0? random.bounded(size): n;
+            const QDateTime whazzupTime = reopened.floor(begin.addSecs(120 * i + 60));
+            timer.start();
+            const QByteArray json = reopened.json(whazzupTime);
+            (run == 0? seekNs: stepNs) += timer.nsecsElapsed();
+            if (QJsonDocument::fromJson(json).object() != QJsonDocument::fromJson(documents[i]).object()) {
+                isMismatch = true;
+            }
+        }
+    }
+    out() << "read\trandom " << formatMs(seekNs / size) << "\tsequential " << formatMs(stepNs / size)
+          << (isMismatch? "\tMISMATCH": "") << Qt::endl;
+
+    // archived snapshots have to take the streaming parser, not its QJsonDocument fallback
+    bool isStreamMismatch = false;
+    for (int i = 0; i < size; i++) {
+        WhazzupData original, archived;
+        const bool isOriginalParsed = original.parseJsonStream(documents[i]);
+        const bool isArchivedParsed = archived.parseJsonStream(reopened.json(begin.addSecs(120 * i)));
+        if (
+            isOriginalParsed != isArchivedParsed || original.whazzupTime != archived.whazzupTime
+            || original.pilots.size() != archived.pilots.size()
+            || original.bookedPilots.size() != archived.bookedPilots.size()
+            || original.controllers.size() != archived.controllers.size()
+        ) {
+            isStreamMismatch = true;
+        }
+    }
+    out() << "stream\tparseJsonStream round trip" << (isStreamMismatch? "\tMISMATCH": "") << Qt::endl;
+    return (isMismatch || isStreamMismatch)? 1: 0;
+}
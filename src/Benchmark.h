@@ -0,0 +1,39 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <QtCore>
+
+/**
+ * Developer micro benchmarks, run from the command line:
+ *   QuteScoop --benchmark <name> [files...]
+ * Results are written to stdout.
+ */
+class Benchmark {
+    public:
+        static const QStringList names;
+        static int run(const QString& name, const QStringList& args);
+
+        // kB, -1 if not available on this platform
+        static qint64 currentRss();
+        static qint64 peakRss();
+    private:
+        static int whazzupParse(const QStringList& files, bool streaming);
+        static int geoIndex();
+        static int navdataLoad();
+        static int airwayLoad(const QStringList& args);
+        static int routeTokenizer(const QStringList& files);
+        static int labelPlacement(const QStringList& args);
+        static int labelRender(const QStringList& files);
+        static int routeRefresh(const QStringList& files);
+        static int usedWaypoints(const QStringList& files);
+        static int geodesy();
+        static int warp(const QStringList& files);
+        static int search();
+        static int bookings(const QStringList& args);
+        static int whazzupArchive(const QStringList& files);
+
+        static QTextStream& out();
+        static QString formatMs(qint64 nsecs);
+};
+
+#endif /*BENCHMARK_H_*/
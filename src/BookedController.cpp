@@ -1,5 +1,6 @@
 #include "BookedController.h"
-#include "Settings.h"
+
+#include "Friends.h"
 
 #include <QJsonObject>
 
@@ -55,7 +56,7 @@ QString BookedController::facilityString() const {
 }
 
 const QString BookedController::realName() const {
-    auto& _alias = Settings::clientAlias(userId);
+    const QString _alias = Friends::instance()->alias(userId);
     if (!_alias.isEmpty()) {
         return _alias;
     }
@@ -63,7 +64,7 @@ const QString BookedController::realName() const {
 }
 
 bool BookedController::isFriend() const {
-    return Settings::friends().contains(userId);
+    return Friends::instance()->contains(userId);
 }
 
 QDateTime BookedController::starts() const {
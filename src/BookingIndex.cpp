@@ -0,0 +1,147 @@
+#include "BookingIndex.h"
+
+#include "BookedController.h"
+
+#include <limits>
+
+void BookingIndex::build(const QList<BookedController*>& bookings) {
+    clear();
+    _byStart.reserve(bookings.size());
+    for (int row = 0; row < bookings.size(); row++) {
+        const BookedController* bc = bookings[row];
+        if (!bc->starts().isValid() || !bc->ends().isValid()) {
+            continue;
+        }
+        _byStart.append({ bc->starts().toMSecsSinceEpoch(), bc->ends().toMSecsSinceEpoch(), row });
+    }
+    std::stable_sort(
+        _byStart.begin(),
+        _byStart.end(),
+        [](const Interval& a, const Interval& b) {
+            return a.starts < b.starts;
+        }
+    );
+
+    _byEnd = _byStart;
+    std::stable_sort(
+        _byEnd.begin(),
+        _byEnd.end(),
+        [](const Interval& a, const Interval& b) {
+            return a.ends < b.ends;
+        }
+    );
+
+    if (!_byStart.isEmpty()) {
+        _maxEnds.resize(4 * _byStart.size());
+        buildNode(0, 0, _byStart.size());
+    }
+}
+
+void BookingIndex::clear() {
+    _byStart.clear();
+    _byEnd.clear();
+    _maxEnds.clear();
+}
+
+int BookingIndex::size() const {
+    return _byStart.size();
+}
+
+void BookingIndex::buildNode(int node, int lo, int hi) {
+    if (hi - lo == 1) {
+        _maxEnds[node] = _byStart[lo].ends;
+        return;
+    }
+    const int mid = (lo + hi) / 2;
+    buildNode(2 * node + 1, lo, mid);
+    buildNode(2 * node + 2, mid, hi);
+    _maxEnds[node] = qMax(_maxEnds[2 * node + 1], _maxEnds[2 * node + 2]);
+}
+
+void BookingIndex::collect(int node, int lo, int hi, int last, qint64 from, QVector<int>& result) const {
+    // skip subtrees that start too late or end too early
+    if (lo >= last || _maxEnds[node] < from) {
+        return;
+    }
+    if (hi - lo == 1) {
+        result.append(_byStart[lo].row);
+        return;
+    }
+    const int mid = (lo + hi) / 2;
+    collect(2 * node + 1, lo, mid, last, from, result);
+    collect(2 * node + 2, mid, hi, last, from, result);
+}
+
+int BookingIndex::lowerStart(qint64 msecs) const {
+    return std::lower_bound(
+        _byStart.constBegin(),
+        _byStart.constEnd(),
+        msecs,
+        [](const Interval& a, qint64 msecs) {
+            return a.starts < msecs;
+        }
+    ) - _byStart.constBegin();
+}
+
+int BookingIndex::lowerEnd(qint64 msecs) const {
+    return std::lower_bound(
+        _byEnd.constBegin(),
+        _byEnd.constEnd(),
+        msecs,
+        [](const Interval& a, qint64 msecs) {
+            return a.ends < msecs;
+        }
+    ) - _byEnd.constBegin();
+}
+
+QVector<int> BookingIndex::at(const QDateTime& dateTime) const {
+    if (!dateTime.isValid()) {
+        return QVector<int>();
+    }
+    return overlapping(dateTime, dateTime);
+}
+
+QVector<int> BookingIndex::overlapping(const QDateTime& from, const QDateTime& to) const {
+    QVector<int> result;
+    if (_byStart.isEmpty() || !from.isValid()) {
+        return result;
+    }
+    const int last = to.isValid()
+        ? lowerStart(to.toMSecsSinceEpoch() + 1)
+        : _byStart.size();
+    collect(0, 0, _byStart.size(), last, from.toMSecsSinceEpoch(), result);
+    return result;
+}
+
+BookingDelta BookingIndex::scrub(const QDateTime& from, const QDateTime& to) const {
+    BookingDelta delta;
+    if (!from.isValid() || !to.isValid()) {
+        delta.entered = at(to);
+        delta.left = at(from);
+        return delta;
+    }
+    if (to < from) {
+        const BookingDelta reverse = scrub(to, from);
+        delta.entered = reverse.left;
+        delta.left = reverse.entered;
+        return delta;
+    }
+
+    const qint64 fromMsecs = from.toMSecsSinceEpoch();
+    const qint64 toMsecs = to.toMSecsSinceEpoch();
+    // entered: starts in (from, to] and still there at to
+    const int lastStart = lowerStart(toMsecs + 1);
+    for (int i = lowerStart(fromMsecs + 1); i < lastStart; i++) {
+        if (_byStart[i].ends >= toMsecs) {
+            delta.entered.append(_byStart[i].row);
+        }
+    }
+    // left: ends in [from, to) and was there at from
+    const int lastEnd = lowerEnd(toMsecs);
+    for (int i = lowerEnd(fromMsecs); i < lastEnd; i++) {
+        if (_byEnd[i].starts <= fromMsecs) {
+            delta.left.append(_byEnd[i].row);
+        }
+    }
+    return delta;
+}
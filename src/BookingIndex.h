@@ -0,0 +1,48 @@
+#ifndef BOOKINGINDEX_H_
+#define BOOKINGINDEX_H_
+
+#include <QtCore>
+
+class BookedController;
+
+// bookings entering and leaving between two points in time, as rows of the indexed list
+struct BookingDelta {
+    QVector<int> entered, left;
+};
+
+/**
+ * Time intervals of a list of bookings: sorted by start with the maximum end
+ * of each subtree (a static interval tree), and sorted by end. Queries return
+ * rows of the list the index was built from, in order of their start, in
+ * O(log n + results). As only rows are stored, an index stays valid for
+ * copies of the list. Bookings without a valid start or end are not indexed.
+ */
+class BookingIndex {
+    public:
+        void build(const QList<BookedController*>& bookings);
+        void clear();
+        int size() const;
+
+        // bookings with starts() <= dateTime <= ends()
+        QVector<int> at(const QDateTime& dateTime) const;
+        // bookings with starts() <= to and ends() >= from; an invalid to means open end
+        QVector<int> overlapping(const QDateTime& from, const QDateTime& to) const;
+        // difference between at(from) and at(to), for stepping through time
+        BookingDelta scrub(const QDateTime& from, const QDateTime& to) const;
+    private:
+        struct Interval {
+            qint64 starts, ends; // msecs since epoch
+            int row;
+        };
+
+        void buildNode(int node, int lo, int hi);
+        void collect(int node, int lo, int hi, int last, qint64 from, QVector<int>& result) const;
+        // first index of _byStart / _byEnd after all intervals starting / ending before msecs
+        int lowerStart(qint64 msecs) const;
+        int lowerEnd(qint64 msecs) const;
+
+        QVector<Interval> _byStart, _byEnd;
+        QVector<qint64> _maxEnds; // per tree node over _byStart
+};
+
+#endif /*BOOKINGINDEX_H_*/
@@ -1,6 +1,6 @@
 #include "Client.h"
 
-#include "Settings.h"
+#include "Friends.h"
 #include "Whazzup.h"
 
 #include <QInputDialog>
@@ -33,16 +33,41 @@ QString Client::livestreamString(const QString& str) {
 Client::Client(const QJsonObject& json, const WhazzupData*)
     : callsign(""), userId(""), homeBase(""), server(""), rating(-99) {
     callsign = json["callsign"].toString();
-    if (callsign.isNull()) {
-        callsign = "";
-    }
-
     userId = QString::number(json["cid"].toInt());
     server = json["server"].toString();
     rating = json["rating"].toInt();
     timeConnected = QDateTime::fromString(json["logon_time"].toString(), Qt::ISODate);
 
     m_nameOrCid = json["name"].toString();
+    normalizeFields();
+}
+
+Client::Client()
+    : callsign(""), userId(""), homeBase(""), server(""), rating(0) {}
+
+bool Client::readField(const QLatin1String& key, JsonPullReader& reader) {
+    if (key == QLatin1String("callsign")) {
+        callsign = reader.readString();
+    } else if (key == QLatin1String("cid")) {
+        userId = QString::number(reader.readInt());
+    } else if (key == QLatin1String("server")) {
+        server = reader.readString();
+    } else if (key == QLatin1String("rating")) {
+        rating = reader.readInt();
+    } else if (key == QLatin1String("logon_time")) {
+        timeConnected = QDateTime::fromString(reader.readString(), Qt::ISODate);
+    } else if (key == QLatin1String("name")) {
+        m_nameOrCid = reader.readString();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void Client::normalizeFields() {
+    if (callsign.isNull()) {
+        callsign = "";
+    }
     if (m_nameOrCid.isNull()) {
         m_nameOrCid = "";
     }
@@ -96,11 +121,11 @@ bool Client::showAliasDialog(QWidget* parent) const {
         QString("Edit alias"),
         QString("Set the alias for %1 [empty to unset]:").arg(nameOrCid()),
         QLineEdit::Normal,
-        Settings::clientAlias(userId),
+        Friends::instance()->alias(userId),
         &ok
     );
     if (ok) {
-        Settings::setClientAlias(userId, alias);
+        Friends::instance()->setAlias(userId, alias);
     }
     return ok;
 }
@@ -123,11 +148,11 @@ QString Client::livestreamString() const {
 }
 
 bool Client::isFriend() const {
-    return Settings::friends().contains(userId);
+    return Friends::instance()->contains(userId);
 }
 
 const QString Client::realName() const {
-    auto& _alias = Settings::clientAlias(userId);
+    const QString _alias = Friends::instance()->alias(userId);
     if (!_alias.isEmpty() && _alias != m_nameOrCid) {
         return _alias + " | " + m_nameOrCid;
     }
@@ -149,7 +174,7 @@ const QString Client::aliasOrName() const {
 }
 
 const QString Client::aliasOrNameOrCid() const {
-    auto& _alias = Settings::clientAlias(userId);
+    const QString _alias = Friends::instance()->alias(userId);
     if (!_alias.isEmpty()) {
         return _alias;
     }
@@ -1,6 +1,7 @@
 #ifndef CLIENT_H_
 #define CLIENT_H_
 
+#include "JsonPullReader.h"
 #include "WhazzupData.h"
 
 #include <QJsonDocument>
@@ -36,6 +37,11 @@ class Client {
         bool hasValidID() const;
 
     protected:
+        // streaming construction: derived classes feed their object's keys through readField()
+        Client();
+        bool readField(const QLatin1String& key, JsonPullReader& reader);
+        void normalizeFields();
+
         QString m_nameOrCid;
 };
 
@@ -23,11 +23,7 @@ Controller::Controller(const QJsonObject& json, const WhazzupData* whazzup)
       visualRange(0), sector(0) {
 
     frequency = json["frequency"].toString();
-    Q_ASSERT(!frequency.isNull());
     facilityType = json["facility"].toInt();
-    if (callsign.right(4) == "_FSS") {
-        facilityType = 7; // workaround as VATSIM reports 1 for _FSS
-    }
     visualRange = json["visual_range"].toInt();
 
     atisMessage = "";
@@ -43,6 +39,53 @@ Controller::Controller(const QJsonObject& json, const WhazzupData* whazzup)
         atisCode = json["atis_code"].isNull()? "": json["atis_code"].toString();
     }
 
+    initDerivedFields(whazzup);
+}
+
+Controller::Controller(JsonPullReader& reader, const WhazzupData* whazzup)
+    : MapObject(), Client(),
+      frequency(""),
+      atisMessage(""), atisCode(""), facilityType(0),
+      visualRange(0), sector(0) {
+    QLatin1String key;
+    if (reader.beginObject()) {
+        while (reader.nextKey(key)) {
+            if (Client::readField(key, reader)) {
+                continue;
+            }
+            if (key == QLatin1String("frequency")) {
+                frequency = reader.readString();
+            } else if (key == QLatin1String("facility")) {
+                facilityType = reader.readInt();
+            } else if (key == QLatin1String("visual_range")) {
+                visualRange = reader.readInt();
+            } else if (key == QLatin1String("text_atis")) {
+                if (reader.beginArray()) {
+                    while (reader.nextElement()) {
+                        atisMessage += reader.readString() + "\n";
+                    }
+                }
+            } else if (key == QLatin1String("atis_code")) {
+                atisCode = reader.readString();
+                if (atisCode.isNull()) {
+                    atisCode = "";
+                }
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+    Client::normalizeFields();
+
+    initDerivedFields(whazzup);
+}
+
+void Controller::initDerivedFields(const WhazzupData* whazzup) {
+    Q_ASSERT(!frequency.isNull());
+    if (callsign.right(4) == "_FSS") {
+        facilityType = 7; // workaround as VATSIM reports 1 for _FSS
+    }
+
     // do some magic for Controller Info like "online until"...
     QRegExp rxOnlineUntil = QRegExp(
         "(open|close|online|offline|till|until)(\\W*\\w*\\W*){0,4}\\b(\\d{1,2}):?(\\d{2})\\W?(z|utc)?",
@@ -358,3 +401,19 @@ bool Controller::isATC() const {
 
     return facilityType > 0 && !frequency.isEmpty() && frequency != "199.998";
 }
+
+bool Controller::hasChangedFrom(const Controller& other) const {
+    return atisMessage != other.atisMessage
+        || atisCode != other.atisCode
+        || frequency != other.frequency
+        || facilityType != other.facilityType
+        || visualRange != other.visualRange
+        || lat != other.lat || lon != other.lon
+        || sector != other.sector
+        || assumeOnlineUntil != other.assumeOnlineUntil
+        || rating != other.rating
+        || server != other.server
+        || timeConnected != other.timeConnected
+        || m_nameOrCid != other.m_nameOrCid
+        || homeBase != other.homeBase;
+}
@@ -18,6 +18,7 @@ class Controller
         static const QRegularExpression cpdlcRegExp;
 
         Controller(const QJsonObject& json, const WhazzupData* whazzup);
+        Controller(JsonPullReader& reader, const WhazzupData* whazzup);
         virtual ~Controller();
 
         virtual QString rank() const override;
@@ -55,6 +56,8 @@ class Controller
         QSet<Airport*> airports(bool withAdditionalMatches = true) const;
         QList<Airport*> airportsSorted() const;
 
+        bool hasChangedFrom(const Controller& other) const; // used by WhazzupData::updateFrom()
+
         const QString cpdlcString(const QString& prepend = "", bool alwaysWithIdentifier = true) const;
 
         QString frequency, atisMessage, atisCode;
@@ -62,6 +65,8 @@ class Controller
         QDateTime assumeOnlineUntil;
 
         Sector* sector;
+    private:
+        void initDerivedFields(const WhazzupData* whazzup);
 };
 
 #endif /*CONTROLLER_H_*/
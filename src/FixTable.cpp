@@ -0,0 +1,95 @@
+#include "FixTable.h"
+
+int FixTable::append(const QString &id, const QString &regionCode, float lat, float lon) {
+    const int row = _ids.size();
+
+    auto region = _regionIndexes.constFind(regionCode);
+    if (region == _regionIndexes.constEnd()) {
+        region = _regionIndexes.insert(regionCode, _regionCodes.size());
+        _regionCodes.append(regionCode);
+    }
+
+    auto first = _firstRows.find(id);
+    if (first == _firstRows.end()) {
+        first = _firstRows.insert(id, -1);
+    }
+    _ids.append(first.key());
+    _nextRows.append(first.value());
+    first.value() = row;
+
+    _regions.append(region.value());
+    _lats.append(lat);
+    _lons.append(lon);
+    return row;
+}
+
+void FixTable::clear() {
+    _ids.clear();
+    _regions.clear();
+    _lats.clear();
+    _lons.clear();
+    _nextRows.clear();
+    _firstRows.clear();
+    _regionCodes.clear();
+    _regionIndexes.clear();
+    _waypoints.clear();
+}
+
+void FixTable::deleteWaypoints() {
+    qDeleteAll(_waypoints);
+    _waypoints.clear();
+}
+
+int FixTable::size() const {
+    return _ids.size();
+}
+
+bool FixTable::contains(const QString &id) const {
+    return _firstRows.contains(id);
+}
+
+int FixTable::firstRow(const QString &id) const {
+    return _firstRows.value(id, -1);
+}
+
+int FixTable::nextRow(int row) const {
+    return _nextRows[row];
+}
+
+int FixTable::row(const QString &id, const QString &regionCode) const {
+    for (int row = firstRow(id); row != -1; row = nextRow(row)) {
+        if (_regionCodes[_regions[row]] == regionCode) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+QString FixTable::id(int row) const {
+    return _ids[row];
+}
+
+QString FixTable::regionCode(int row) const {
+    return _regionCodes[_regions[row]];
+}
+
+float FixTable::lat(int row) const {
+    return _lats[row];
+}
+
+float FixTable::lon(int row) const {
+    return _lons[row];
+}
+
+Waypoint* FixTable::waypoint(int row) const {
+    Waypoint* &w = _waypoints[row];
+    if (w == 0) {
+        w = new Waypoint(_ids[row], _lats[row], _lons[row]);
+        w->regionCode = regionCode(row);
+    }
+    return w;
+}
+
+const QHash<int, Waypoint*>& FixTable::waypoints() const {
+    return _waypoints;
+}
@@ -0,0 +1,48 @@
+#ifndef FIXTABLE_H_
+#define FIXTABLE_H_
+
+#include "Waypoint.h"
+
+#include <QtCore>
+
+/**
+ * AIRAC fixes as a structure of arrays, addressed by row: ids, interned
+ * region codes and float positions. Rows with the same id are chained, so
+ * lookups by id need a single hash entry per id. Waypoint objects are only
+ * created for rows that get used (airways, routes, labels) and are not
+ * deleted by clear(), since routes might still point to them.
+ * Only used from the GUI thread.
+ */
+class FixTable {
+    public:
+        int append(const QString& id, const QString& regionCode, float lat, float lon); // returns the row
+        void clear();
+        void deleteWaypoints();
+
+        int size() const; // rows
+        bool contains(const QString& id) const;
+        // rows with the same id: for (int row = firstRow(id); row != -1; row = nextRow(row))
+        int firstRow(const QString& id) const;
+        int nextRow(int row) const;
+        int row(const QString& id, const QString& regionCode) const; // -1 if not found
+
+        QString id(int row) const;
+        QString regionCode(int row) const;
+        float lat(int row) const;
+        float lon(int row) const;
+
+        // created on first use, owned by the table
+        Waypoint* waypoint(int row) const;
+        const QHash<int, Waypoint*>& waypoints() const; // by row
+    private:
+        QVector<QString> _ids; // sharing the data of the _firstRows keys
+        QVector<quint16> _regions;
+        QVector<float> _lats, _lons;
+        QVector<int> _nextRows; // -1 at the end of a chain
+        QHash<QString, int> _firstRows;
+        QStringList _regionCodes;
+        QHash<QString, quint16> _regionIndexes;
+        mutable QHash<int, Waypoint*> _waypoints;
+};
+
+#endif /*FIXTABLE_H_*/
@@ -0,0 +1,64 @@
+#include "Friends.h"
+
+#include "Settings.h"
+#include "src/mustache/Renderer.h"
+
+Friends* friendsInstance = 0;
+Friends* Friends::instance() {
+    if (friendsInstance == 0) {
+        friendsInstance = new Friends();
+    }
+    return friendsInstance;
+}
+
+Friends::Friends() {
+    const QStringList ids = Settings::friends();
+    _ids = QSet<QString>(ids.begin(), ids.end());
+    _aliases = Settings::clientAliases();
+}
+
+bool Friends::contains(const QString& userId) const {
+    return _ids.contains(userId);
+}
+
+const QSet<QString>& Friends::ids() const {
+    return _ids;
+}
+
+void Friends::add(const QString& userId) {
+    if (_ids.contains(userId)) {
+        return;
+    }
+    _ids.insert(userId);
+    Settings::addFriend(userId);
+    // labels might show friends differently
+    MustacheQs::Renderer::invalidateAll();
+    emit friendsChanged();
+}
+
+void Friends::remove(const QString& userId) {
+    if (!_ids.remove(userId)) {
+        return;
+    }
+    Settings::removeFriend(userId);
+    MustacheQs::Renderer::invalidateAll();
+    emit friendsChanged();
+}
+
+QString Friends::alias(const QString& userId) const {
+    return _aliases.value(userId);
+}
+
+void Friends::setAlias(const QString& userId, const QString& alias) {
+    if (_aliases.value(userId) == alias) {
+        return;
+    }
+    if (alias.isEmpty()) {
+        _aliases.remove(userId);
+    } else {
+        _aliases.insert(userId, alias);
+    }
+    Settings::setClientAlias(userId, alias);
+    MustacheQs::Renderer::invalidateAll();
+    emit aliasesChanged();
+}
@@ -0,0 +1,35 @@
+#ifndef FRIENDS_H_
+#define FRIENDS_H_
+
+#include <QtCore>
+
+/**
+ * Friend list and client aliases, loaded once from the settings and written
+ * through on change. Lookups are used per client while drawing.
+ */
+class Friends
+    : public QObject {
+    Q_OBJECT
+    public:
+        static Friends* instance();
+
+        bool contains(const QString& userId) const;
+        const QSet<QString>& ids() const;
+        void add(const QString& userId);
+        void remove(const QString& userId);
+
+        QString alias(const QString& userId) const;
+        // an empty alias unsets it
+        void setAlias(const QString& userId, const QString& alias = QString());
+    signals:
+        // only emitted if the list really changed
+        void friendsChanged();
+        void aliasesChanged();
+    private:
+        Friends();
+
+        QSet<QString> _ids;
+        QHash<QString, QString> _aliases; // by user ID
+};
+
+#endif /*FRIENDS_H_*/
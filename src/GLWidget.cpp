@@ -4,6 +4,7 @@
 #include "dialogs/AirportDetails.h"
 #include "dialogs/PlanFlightDialog.h"
 #include "dialogs/PilotDetails.h"
+#include "Friends.h"
 #include "GuiMessage.h"
 #include "LineReader.h"
 #include "NavData.h"
@@ -20,12 +21,9 @@ GLWidget::GLWidget(QGLFormat fmt, QWidget* parent)
       m_isMapMoving(false), m_isMapZooming(false), m_isMapRectSelecting(false),
       _lightsGenerated(false),
       _earthTex(0), _fadeOutTex(0),
-      _earthList(0), _coastlinesList(0), _countriesList(0), _gridlinesList(0),
-      _pilotsList(0), _activeAirportsList(0), _inactiveAirportsList(0),
-      _usedWaypointsList(0), _sectorPolygonsList(0), _sectorPolygonBorderLinesList(0),
-      _congestionsList(0),
-      _staticSectorPolygonsList(0), _staticSectorPolygonBorderLinesList(0),
-      _hoveredSectorPolygonsList(0), _hoveredSectorPolygonBorderLinesList(0),
+      _earthList(0), _routesList(0), _activeAirportsList(0), _inactiveAirportsList(0),
+      _usedWaypointsList(0), _congestionsList(0), _hoveredAirportControllersList(0),
+      _appList(0), _twrList(0), _gndDelList(0),
       _pilotLabelZoomTreshold(1.5),
       _activeAirportLabelZoomTreshold(2.), _inactiveAirportLabelZoomTreshold(.12),
       _controllerLabelZoomTreshold(2.5),
@@ -38,6 +36,7 @@ GLWidget::GLWidget(QGLFormat fmt, QWidget* parent)
     restorePosition(9, true);
 
     clientSelection = new ClientSelectionWidget();
+    m_glyphAtlas = new GlyphAtlas(this);
 
     m_updateTimer = new QTimer(this);
     connect(m_updateTimer, &QTimer::timeout, this, QOverload<>::of(&QWidget::update));
@@ -46,19 +45,18 @@ GLWidget::GLWidget(QGLFormat fmt, QWidget* parent)
     m_hoverDebounceTimer = new QTimer(this);
     connect(m_hoverDebounceTimer, &QTimer::timeout, this, &GLWidget::updateHoverState);
     configureHoverDebounce();
+
+    connect(Friends::instance(), &Friends::friendsChanged, this, &GLWidget::friendsChanged);
 }
 
 GLWidget::~GLWidget() {
-    glDeleteLists(_earthList, 1); glDeleteLists(_gridlinesList, 1);
-    glDeleteLists(_coastlinesList, 1); glDeleteLists(_countriesList, 1);
-    glDeleteLists(_usedWaypointsList, 1); glDeleteLists(_pilotsList, 1);
+    makeCurrent(); // the vertex buffers are released with the members
+    glDeleteLists(_earthList, 1);
+    glDeleteLists(_usedWaypointsList, 1); glDeleteLists(_routesList, 1);
     glDeleteLists(_activeAirportsList, 1); glDeleteLists(_inactiveAirportsList, 1);
     glDeleteLists(_congestionsList, 1);
-    glDeleteLists(_sectorPolygonsList, 1); glDeleteLists(_sectorPolygonBorderLinesList, 1);
-    glDeleteLists(_staticSectorPolygonsList, 1);
-    glDeleteLists(_staticSectorPolygonBorderLinesList, 1);
-    glDeleteLists(_hoveredSectorPolygonsList, 1);
-    glDeleteLists(_hoveredSectorPolygonBorderLinesList, 1);
+    glDeleteLists(_hoveredAirportControllersList, 1);
+    glDeleteLists(_appList, 1); glDeleteLists(_twrList, 1); glDeleteLists(_gndDelList, 1);
 
     if (glIsTexture(_earthTex) == GL_TRUE) {
         deleteTexture(_earthTex);
@@ -69,6 +67,7 @@ GLWidget::~GLWidget() {
     }
 
     gluDeleteQuadric(_earthQuad);
+    delete m_glyphAtlas;
 
     delete clientSelection;
 }
@@ -82,8 +81,14 @@ void GLWidget::setMapPosition(double lat, double lon, double newZoom) {
 }
 
 void GLWidget::invalidatePilots() {
-    m_isPilotsListDirty = true;
+    m_isPilotBatchesDirty = true;
     m_isPilotMapObjectsDirty = true;
+    invalidateRoutes();
+}
+
+// routes depend on the hover state, dots and leader lines don't
+void GLWidget::invalidateRoutes() {
+    m_isPilotsListDirty = true;
     m_isUsedWaypointMapObjectsDirty = true;
     update();
 }
@@ -97,6 +102,7 @@ void GLWidget::invalidateAirports() {
 
 void GLWidget::invalidateControllers() {
     m_isControllerListsDirty = true;
+    m_isHoveredControllersListsDirty = true;
     m_isControllerMapObjectsDirty = true;
     update();
 }
@@ -122,7 +128,7 @@ void GLWidget::handleRotation(QMouseEvent*) {
     _zRot = Helpers::modPositive(_zRot + dx + 180., 360.) - 180.;
     _lastPos = currentPos;
 
-    m_fontRectangles.clear();
+    m_labelPlacer.clear();
     update();
 }
 
@@ -185,7 +191,7 @@ void GLWidget::resetZoom() {
     // gluPerspective(_zoom, _aspectRatio, 8, 10); // just for reference, if you want to try it
     glMatrixMode(GL_MODELVIEW);
 
-    m_fontRectangles.clear();
+    m_labelPlacer.clear();
 }
 
 /**
@@ -281,38 +287,15 @@ const QPair<double, double> GLWidget::sunZenith(const QDateTime &dateTime) const
 void GLWidget::createPilotsList() {
     qDebug();
 
-    if (glIsList(_pilotsList) != GL_TRUE) {
-        _pilotsList = glGenLists(1);
+    if (glIsList(_routesList) != GL_TRUE) {
+        _routesList = glGenLists(1);
     }
 
-    glNewList(_pilotsList, GL_COMPILE);
-
-    QList<Pilot*> pilots = Whazzup::instance()->whazzupData().pilots.values();
-
-    // leader lines
-    if (Settings::timelineSeconds() > 0 && !qFuzzyIsNull(Settings::timeLineStrength())) {
-        glLineWidth(Settings::timeLineStrength());
-        glBegin(GL_LINES);
-        qglColor(Settings::leaderLineColor());
-        foreach (const Pilot* p, pilots) {
-            if (p->groundspeed < 30) {
-                continue;
-            }
-
-            if (qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon)) {
-                continue;
-            }
-
-            VERTEX(p->lat, p->lon);
-            QPair<double, double> pos = p->positionInFuture(Settings::timelineSeconds());
-            VERTEX(pos.first, pos.second);
-        }
-        glEnd();
-    }
+    glNewList(_routesList, GL_COMPILE);
 
     // flight paths, also for booked flights
     if (m_isUsedWaypointMapObjectsDirty) {
-        m_usedWaypointMapObjects.clear();
+        m_usedWaypoints.clear();
 
         foreach (Pilot* p, Whazzup::instance()->whazzupData().allPilots()) {
             if (qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon)) {
@@ -349,9 +332,7 @@ void GLWidget::createPilotsList() {
             // Dep -> plane
             if (isShowDepToPlaneRoute) {
                 for (int i = 0; i < next; i++) {
-                    if (!m_usedWaypointMapObjects.contains(waypoints[i])) {
-                        m_usedWaypointMapObjects.append(waypoints[i]);
-                    }
+                    m_usedWaypoints.insert(waypoints[i]);
                     points.append(DoublePair(waypoints[i]->lat, waypoints[i]->lon));
                 }
 
@@ -363,7 +344,7 @@ void GLWidget::createPilotsList() {
                 qglColor(Settings::depLineColor());
                 glLineWidth(Settings::depLineStrength());
                 glBegin(GL_LINE_STRIP);
-                NavData::plotGreatCirclePoints(points);
+                NavData::plotGreatCirclePoints(points, false, CacheFirstSegment | CacheInnerSegments);
                 points.clear();
                 glEnd();
                 if (Settings::depLineDashed()) {
@@ -384,14 +365,14 @@ void GLWidget::createPilotsList() {
             double distanceFromPlane = 0;
             int i = next;
             if (isShowPlaneToImmediateRoute) {
+                QSet<DoublePair> pointsSet(points.begin(), points.end());
                 for (; i < waypoints.size(); i++) {
                     double distance = NavData::distance(lastPoint.first, lastPoint.second, waypoints[i]->lat, waypoints[i]->lon);
                     if (distanceFromPlane + distance < destImmediateNm) {
-                        if (!m_usedWaypointMapObjects.contains(waypoints[i])) {
-                            m_usedWaypointMapObjects.append(waypoints[i]);
-                        }
+                        m_usedWaypoints.insert(waypoints[i]);
                         const auto _p = DoublePair(waypoints[i]->lat, waypoints[i]->lon);
-                        if (!points.contains(_p)) { // very cautious for duplicates here
+                        if (!pointsSet.contains(_p)) { // very cautious for duplicates here
+                            pointsSet.insert(_p);
                             points.append(_p);
                         }
                         distanceFromPlane += distance;
@@ -399,12 +380,13 @@ void GLWidget::createPilotsList() {
                         continue;
                     }
 
-                    if (!points.contains(lastPoint)) {
+                    if (!pointsSet.contains(lastPoint)) {
+                        pointsSet.insert(lastPoint);
                         points.append(lastPoint);
                     }
                     const float neededFraction = (destImmediateNm - distanceFromPlane) / qMax(distance, 1.);
                     const auto absoluteLast = NavData::greatCircleFraction(lastPoint.first, lastPoint.second, waypoints[i]->lat, waypoints[i]->lon, neededFraction);
-                    if (!points.contains(absoluteLast)) {
+                    if (!pointsSet.contains(absoluteLast)) {
                         points.append(absoluteLast);
                     }
                     break;
@@ -418,7 +400,7 @@ void GLWidget::createPilotsList() {
                 qglColor(Settings::destImmediateLineColor());
                 glLineWidth(Settings::destImmediateLineStrength());
                 glBegin(GL_LINE_STRIP);
-                NavData::plotGreatCirclePoints(points);
+                NavData::plotGreatCirclePoints(points, false, CacheInnerSegments);
                 glEnd();
                 glPopAttrib();
 
@@ -434,7 +416,7 @@ void GLWidget::createPilotsList() {
                     }
                     glLineWidth(Settings::destLineStrength());
                     glBegin(GL_LINE_STRIP);
-                    NavData::plotGreatCirclePoints(points, true);
+                    NavData::plotGreatCirclePoints(points, true, CacheInnerSegments);
                     glEnd();
                     if (Settings::destLineDashed()) {
                         glLineStipple(1, 0xFFFF);
@@ -452,9 +434,7 @@ void GLWidget::createPilotsList() {
                 points.takeFirst();
             }
             for (; i < waypoints.size(); i++) {
-                if (!m_usedWaypointMapObjects.contains(waypoints[i])) {
-                    m_usedWaypointMapObjects.append(waypoints[i]);
-                }
+                m_usedWaypoints.insert(waypoints[i]);
                 points.append(DoublePair(waypoints[i]->lat, waypoints[i]->lon));
             }
             glPushAttrib(GL_ENABLE_BIT);
@@ -464,7 +444,7 @@ void GLWidget::createPilotsList() {
             }
             glLineWidth(Settings::destLineStrength());
             glBegin(GL_LINE_STRIP);
-            NavData::plotGreatCirclePoints(points);
+            NavData::plotGreatCirclePoints(points, false, CacheInnerSegments | CacheLastSegment);
             glEnd();
             if (Settings::destLineDashed()) {
                 glLineStipple(1, 0xFFFF);
@@ -474,37 +454,6 @@ void GLWidget::createPilotsList() {
         m_isUsedWaypointMapObjectsDirty = false;
     }
 
-    // aircraft dots
-    if (!qFuzzyIsNull(Settings::pilotDotSize())) {
-        glPointSize(Settings::pilotDotSize());
-        qglColor(Settings::pilotDotColor());
-        glBegin(GL_POINTS);
-        foreach (const Pilot* p, pilots) {
-            if (qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon)) {
-                continue;
-            }
-            if (!p->isFriend()) {
-                VERTEX(p->lat, p->lon);
-            }
-        }
-        glEnd();
-
-        // friends
-        qglColor(Settings::friendsPilotDotColor());
-        glPointSize(Settings::pilotDotSize() * 1.3);
-        glBegin(GL_POINTS);
-        foreach (const Pilot* p, pilots) {
-            if (qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon)) {
-                continue;
-            }
-
-            if (p->isFriend()) {
-                VERTEX(p->lat, p->lon);
-            }
-        }
-        glEnd();
-    }
-
     // planned route from Flightplan Dialog (does not really belong to pilots lists, but is convenient here)
     // @todo
     if (PlanFlightDialog::instance(false) != 0) {
@@ -526,7 +475,7 @@ void GLWidget::createPilotsList() {
         qglColor(Settings::waypointsDotColor());
         glPointSize(Settings::waypointsDotSize());
         glBegin(GL_POINTS);
-        foreach (const auto wp, m_usedWaypointMapObjects) {
+        foreach (const auto wp, m_usedWaypoints.values()) {
             VERTEX(wp->lat, wp->lon);
         }
         glEnd();
@@ -536,6 +485,65 @@ void GLWidget::createPilotsList() {
     qDebug() << "-- finished";
 }
 
+/**
+ * Brings the pilot dot and leader line buffers up to date. Only the pilots
+ * queued by newWhazzupData() are rewritten, unless a setting changed.
+ */
+void GLWidget::updatePilotBatches() {
+    const QHash<QString, Pilot*> &pilots = Whazzup::instance()->whazzupData().pilots;
+
+    if (m_isPilotBatchesDirty) {
+        m_pilotDotsBatch.clear();
+        m_leaderLinesBatch.clear();
+        for (auto it = pilots.constBegin(); it != pilots.constEnd(); ++it) {
+            updatePilotVertices(it.key(), it.value());
+        }
+    } else {
+        foreach (const QString &callsign, m_pendingPilotCallsigns) {
+            updatePilotVertices(callsign, pilots.value(callsign, 0));
+        }
+    }
+    qDebug() << "updated" << (m_isPilotBatchesDirty? pilots.size(): m_pendingPilotCallsigns.size())
+             << "of" << m_pilotDotsBatch.size() << "pilots";
+    m_pendingPilotCallsigns.clear();
+    m_isPilotBatchesDirty = false;
+
+    // friends are few, so we just rebuild them
+    m_friendPilotDotsBatch.clear();
+    foreach (const QString &callsign, m_friendPilotCallsigns) {
+        const Pilot* p = pilots.value(callsign, 0);
+        if (p != 0 && !(qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon))) {
+            m_friendPilotDotsBatch.append(p->lat, p->lon);
+        }
+    }
+
+    m_pilotDotsBatch.upload();
+    m_leaderLinesBatch.upload();
+    m_friendPilotDotsBatch.upload();
+}
+
+void GLWidget::updatePilotVertices(const QString &callsign, const Pilot* p) {
+    const bool isPositioned = p != 0 && !(qFuzzyIsNull(p->lat) && qFuzzyIsNull(p->lon));
+
+    if (isPositioned && !m_friendPilotCallsigns.contains(callsign)) {
+        const GLfloat dot[] = { SX(p->lat, p->lon), SY(p->lat, p->lon), SZ(p->lat, p->lon) };
+        m_pilotDotsBatch.set(callsign, dot);
+    } else {
+        m_pilotDotsBatch.remove(callsign);
+    }
+
+    if (isPositioned && p->groundspeed >= 30 && Settings::timelineSeconds() > 0) {
+        const QPair<double, double> pos = p->positionInFuture(Settings::timelineSeconds());
+        const GLfloat line[] = {
+            SX(p->lat, p->lon), SY(p->lat, p->lon), SZ(p->lat, p->lon),
+            SX(pos.first, pos.second), SY(pos.first, pos.second), SZ(pos.first, pos.second)
+        };
+        m_leaderLinesBatch.set(callsign, line);
+    } else {
+        m_leaderLinesBatch.remove(callsign);
+    }
+}
+
 void GLWidget::createAirportsList() {
     qDebug();
     if (glIsList(_activeAirportsList) != GL_TRUE) {
@@ -689,64 +697,99 @@ void GLWidget::createAirportsList() {
         glPopAttrib();
     }
     glEndList();
-    qDebug() << "-- finished";
-}
-
-void GLWidget::createControllerLists() {
-    qDebug();
-
-    // FIR polygons
-    if (glIsList(_sectorPolygonsList) != GL_TRUE) {
-        _sectorPolygonsList = glGenLists(1);
-    }
-
-    auto _sectorsToDraw = Whazzup::instance()->whazzupData().controllersWithSectors();
 
+    // staffed airports: one list per facility type calling the airports' lists
+    const QSet<Airport*> &atcAirports = NavData::instance()->atcAirports;
     // make sure all the lists are there to avoid nested glNewList calls
-    foreach (const Controller* c, _sectorsToDraw) {
-        if (c->sector != 0) {
-            c->sector->glPolygon();
+    foreach (Airport* a, atcAirports) {
+        if (!a->appDeps.isEmpty()) {
+            a->appDisplayList();
+        }
+        if (!a->twrs.isEmpty()) {
+            a->twrDisplayList();
+        }
+        if (!a->dels.isEmpty()) {
+            a->delDisplayList();
+        }
+        if (!a->gnds.isEmpty()) {
+            a->gndDisplayList();
         }
     }
 
-    // create a list of lists
-    glNewList(_sectorPolygonsList, GL_COMPILE);
-    foreach (const Controller* c, _sectorsToDraw) {
-        if (c->sector != 0) {
-            glCallList(c->sector->glPolygon());
+    if (glIsList(_appList) != GL_TRUE) {
+        _appList = glGenLists(1);
+    }
+    glNewList(_appList, GL_COMPILE);
+    foreach (Airport* a, atcAirports) {
+        if (!a->appDeps.isEmpty()) {
+            glCallList(a->appDisplayList());
         }
     }
     glEndList();
 
-    // FIR borders
-    if (glIsList(_sectorPolygonBorderLinesList) != GL_TRUE) {
-        _sectorPolygonBorderLinesList = glGenLists(1);
+    if (glIsList(_twrList) != GL_TRUE) {
+        _twrList = glGenLists(1);
     }
+    glNewList(_twrList, GL_COMPILE);
+    foreach (Airport* a, atcAirports) {
+        if (!a->twrs.isEmpty()) {
+            glCallList(a->twrDisplayList());
+        }
+    }
+    glEndList();
 
-    if (!qFuzzyIsNull(Settings::firBorderLineStrength())) {
-        // first, make sure all lists are there
-        foreach (const Controller* c, _sectorsToDraw) {
-            if (c->sector != 0) {
-                c->sector->glBorderLine();
-            }
+    if (glIsList(_gndDelList) != GL_TRUE) {
+        _gndDelList = glGenLists(1);
+    }
+    glNewList(_gndDelList, GL_COMPILE);
+    foreach (Airport* a, atcAirports) {
+        if (!a->dels.isEmpty()) {
+            glCallList(a->delDisplayList());
         }
-        glNewList(_sectorPolygonBorderLinesList, GL_COMPILE);
-        foreach (const Controller* c, _sectorsToDraw) {
-            if (c->sector != 0) {
-                glCallList(c->sector->glBorderLine());
-            }
+        if (!a->gnds.isEmpty()) {
+            glCallList(a->gndDisplayList());
         }
-        glEndList();
     }
+    glEndList();
+    qDebug() << "-- finished";
+}
+
+void GLWidget::createControllerLists() {
+    qDebug();
+
+    // FIR polygons and borders. The sectors keep their vertices, so this only
+    // concatenates them.
+    m_sectorPolygonsBatch.clear();
+    m_sectorBorderLinesBatch.clear();
+    foreach (const Controller* c, Whazzup::instance()->whazzupData().controllersWithSectors()) {
+        if (c->sector != 0) {
+            m_sectorPolygonsBatch.append(c->sector->polygonVertices());
+            m_sectorBorderLinesBatch.append(c->sector->borderLineVertices());
+        }
+    }
+    m_sectorPolygonsBatch.upload();
+    m_sectorBorderLinesBatch.upload();
     qDebug() << "-- finished";
 }
 
 
 void GLWidget::createHoveredControllersLists(const QSet<Controller*>& controllers) {
-    // make sure all the lists are there to avoid nested glNewList calls
+    // sectors: same geometry as in createControllerLists(), drawn with the highlight colors
+    m_hoveredSectorPolygonsBatch.clear();
+    m_hoveredSectorBorderLinesBatch.clear();
+    foreach (Controller* c, controllers) {
+        if (c->sector != 0) {
+            m_hoveredSectorPolygonsBatch.append(c->sector->polygonVertices());
+            m_hoveredSectorBorderLinesBatch.append(c->sector->borderLineVertices());
+        }
+    }
+    m_hoveredSectorPolygonsBatch.upload();
+    m_hoveredSectorBorderLinesBatch.upload();
+
+    // airport controllers: make sure all the lists are there to avoid nested glNewList calls
     foreach (Controller* c, controllers) {
         if (c->sector != 0) {
-            c->sector->glPolygonHighlighted();
+            continue;
         } else if (c->isAppDep()) {
             foreach (const auto _a, c->airports()) {
                 _a->appDisplayList();
@@ -767,13 +810,13 @@ void GLWidget::createHoveredControllersLists(const QSet<Controller*>& controller
     }
 
     // create a list of lists
-    if (glIsList(_hoveredSectorPolygonsList) != GL_TRUE) {
-        _hoveredSectorPolygonsList = glGenLists(1);
+    if (glIsList(_hoveredAirportControllersList) != GL_TRUE) {
+        _hoveredAirportControllersList = glGenLists(1);
     }
-    glNewList(_hoveredSectorPolygonsList, GL_COMPILE);
+    glNewList(_hoveredAirportControllersList, GL_COMPILE);
     foreach (Controller* c, controllers) {
         if (c->sector != 0) {
-            glCallList(c->sector->glPolygonHighlighted());
+            continue;
         } else if (c->isAppDep()) {
             foreach (const auto _a, c->airports()) {
                 glCallList(_a->appDisplayList());
@@ -793,28 +836,6 @@ void GLWidget::createHoveredControllersLists(const QSet<Controller*>& controller
         }
     }
     glEndList();
-
-
-    // FIR borders
-    if (glIsList(_hoveredSectorPolygonBorderLinesList) != GL_TRUE) {
-        _hoveredSectorPolygonBorderLinesList = glGenLists(1);
-    }
-
-    if (!qFuzzyIsNull(Settings::firHighlightedBorderLineStrength())) {
-        // first, make sure all lists are there
-        foreach (Controller* c, controllers) {
-            if (c->sector != 0) {
-                c->sector->glBorderLineHighlighted();
-            }
-        }
-        glNewList(_hoveredSectorPolygonBorderLinesList, GL_COMPILE);
-        foreach (Controller* c, controllers) {
-            if (c->sector != 0) {
-                glCallList(c->sector->glBorderLineHighlighted());
-            }
-        }
-        glEndList();
-    }
 }
 
 void GLWidget::createStaticLists() {
@@ -877,118 +898,70 @@ void GLWidget::createStaticLists() {
 
     // grid
     qDebug() << "gridLines";
-    _gridlinesList = glGenLists(1);
-    glNewList(_gridlinesList, GL_COMPILE);
+    m_gridlinesBatch.clear();
     if (!qFuzzyIsNull(Settings::gridLineStrength())) {
         // meridians
-        qglColor(Settings::gridLineColor());
-        glLineWidth(Settings::gridLineStrength());
         for (int lon = 0; lon < 180; lon += Settings::earthGridEach()) {
-            glBegin(GL_LINE_LOOP);
+            QList<QPair<double, double> > line;
             for (int lat = 0; lat < 360; lat += Settings::glCirclePointEach()) {
-                VERTEX(lat, lon);
+                line.append(QPair<double, double>(lat, lon));
             }
-            glEnd();
+            m_gridlinesBatch.appendLineStrip(line, true);
         }
         // parallels
         for (int lat = -90 + Settings::earthGridEach(); lat < 90; lat += Settings::earthGridEach()) {
-            glBegin(GL_LINE_LOOP);
+            QList<QPair<double, double> > line;
             for (
                 int lon = -180; lon < 180;
                 lon += qCeil(Settings::glCirclePointEach() / qCos(lat * Pi180))
             ) {
-                VERTEX(lat, lon);
+                line.append(QPair<double, double>(lat, lon));
             }
-            glEnd();
+            m_gridlinesBatch.appendLineStrip(line, true);
         }
     }
-    glEndList();
+    m_gridlinesBatch.upload();
 
     // coastlines
     qDebug() << "coastLines";
-    _coastlinesList = glGenLists(1);
-    glNewList(_coastlinesList, GL_COMPILE);
+    m_coastlinesBatch.clear();
     if (!qFuzzyIsNull(Settings::coastLineStrength())) {
-        qglColor(Settings::coastLineColor());
-        glLineWidth(Settings::coastLineStrength());
         LineReader lineReader(Settings::dataDirectory("data/coastline.dat"));
         QList<QPair<double, double> > line = lineReader.readLine();
         while (!line.isEmpty()) {
-            glBegin(GL_LINE_STRIP);
-            for (int i = 0; i < line.size(); i++) {
-                VERTEX(line[i].first, line[i].second);
-            }
-            glEnd();
+            m_coastlinesBatch.appendLineStrip(line);
             line = lineReader.readLine();
         }
     }
-    glEndList();
+    m_coastlinesBatch.upload();
 
     // countries
     qDebug() << "countries";
-    _countriesList = glGenLists(1);
-    glNewList(_countriesList, GL_COMPILE);
+    m_countriesBatch.clear();
     if (!qFuzzyIsNull(Settings::countryLineStrength())) {
-        qglColor(Settings::countryLineColor());
-        glLineWidth(Settings::countryLineStrength());
         LineReader countries = LineReader(Settings::dataDirectory("data/countries.dat"));
         QList<QPair<double, double> > line = countries.readLine();
         while (!line.isEmpty()) {
-            glBegin(GL_LINE_STRIP);
-            for (int i = 0; i < line.size(); i++) {
-                VERTEX(line[i].first, line[i].second);
-            }
-            glEnd();
+            m_countriesBatch.appendLineStrip(line);
             line = countries.readLine();
         }
     }
-    glEndList();
+    m_countriesBatch.upload();
+    qDebug() << "static batches:" << m_gridlinesBatch.vertexCount() << m_coastlinesBatch.vertexCount()
+             << m_countriesBatch.vertexCount() << "vertices";
 }
 
 void GLWidget::createStaticSectorLists() {
-    //Polygon
-    if (glIsList(_staticSectorPolygonsList) != GL_TRUE) {
-        _staticSectorPolygonsList = glGenLists(1);
-    }
-
-    // make sure all the lists are there to avoid nested glNewList calls
+    m_staticSectorPolygonsBatch.clear();
+    m_staticSectorBorderLinesBatch.clear();
     foreach (Sector* sector, m_staticSectors) {
         if (sector != 0) {
-            sector->glPolygon();
-        }
-    }
-
-    // create a list of lists
-    glNewList(_staticSectorPolygonsList, GL_COMPILE);
-    foreach (Sector* sector, m_staticSectors) {
-        if (sector != 0) {
-            glCallList(sector->glPolygon());
-        }
-    }
-    glEndList();
-
-
-    // FIR borders
-    if (glIsList(_staticSectorPolygonBorderLinesList) != GL_TRUE) {
-        _staticSectorPolygonBorderLinesList = glGenLists(1);
-    }
-
-    if (!qFuzzyIsNull(Settings::firBorderLineStrength())) {
-        // first, make sure all lists are there
-        foreach (Sector* sector, m_staticSectors) {
-            if (sector != 0) {
-                sector->glBorderLine();
-            }
-        }
-
-        glNewList(_staticSectorPolygonBorderLinesList, GL_COMPILE);
-        foreach (Sector* sector, m_staticSectors) {
-            if (sector != 0) {
-                glCallList(sector->glBorderLine());
-            }
+            m_staticSectorPolygonsBatch.append(sector->polygonVertices());
+            m_staticSectorBorderLinesBatch.append(sector->borderLineVertices());
         }
-        glEndList();
     }
+    m_staticSectorPolygonsBatch.upload();
+    m_staticSectorBorderLinesBatch.upload();
 }
 
 /**
@@ -1182,6 +1155,9 @@ void GLWidget::paintGL() {
     qint64 started = QDateTime::currentMSecsSinceEpoch(); // for method execution time calculation.
 
     // create lists (if necessary)
+    if (m_isPilotBatchesDirty || !m_pendingPilotCallsigns.isEmpty()) {
+        updatePilotBatches();
+    }
     if (m_isPilotsListDirty) {
         createPilotsList();
         m_isPilotsListDirty = false;
@@ -1198,7 +1174,10 @@ void GLWidget::paintGL() {
         createStaticSectorLists();
         m_isStaticSectorListsDirty = false;
     }
-    createHoveredControllersLists(m_hoveredControllers);
+    if (m_isHoveredControllersListsDirty) {
+        createHoveredControllersLists(m_hoveredControllers);
+        m_isHoveredControllersListsDirty = false;
+    }
 
     // blank out the screen (buffered, of course)
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -1255,9 +1234,21 @@ void GLWidget::paintGL() {
         glDisable(GL_TEXTURE_2D);
     }
 
-    glCallList(_coastlinesList);
-    glCallList(_countriesList);
-    glCallList(_gridlinesList);
+    if (!qFuzzyIsNull(Settings::coastLineStrength())) {
+        qglColor(Settings::coastLineColor());
+        glLineWidth(Settings::coastLineStrength());
+        m_coastlinesBatch.draw();
+    }
+    if (!qFuzzyIsNull(Settings::countryLineStrength())) {
+        qglColor(Settings::countryLineColor());
+        glLineWidth(Settings::countryLineStrength());
+        m_countriesBatch.draw();
+    }
+    if (!qFuzzyIsNull(Settings::gridLineStrength())) {
+        qglColor(Settings::gridLineColor());
+        glLineWidth(Settings::gridLineStrength());
+        m_gridlinesBatch.draw();
+    }
 
     if (Settings::showUsedWaypoints() && _zoom < _usedWaypointsLabelZoomThreshold * .1) {
         glCallList(_usedWaypointsList);
@@ -1265,8 +1256,13 @@ void GLWidget::paintGL() {
 
     // render sectors
     if (Settings::showCTR()) {
-        glCallList(_sectorPolygonsList);
-        glCallList(_sectorPolygonBorderLinesList);
+        qglColor(Settings::firFillColor());
+        m_sectorPolygonsBatch.draw();
+        if (!qFuzzyIsNull(Settings::firBorderLineStrength())) {
+            qglColor(Settings::firBorderLineColor());
+            glLineWidth(Settings::firBorderLineStrength());
+            m_sectorBorderLinesBatch.draw();
+        }
     }
 
     if (Settings::showAirportCongestion()) {
@@ -1275,45 +1271,48 @@ void GLWidget::paintGL() {
 
     // render hovered sectors
     if (m_hoveredControllers.size() > 0) {
-        glCallList(_hoveredSectorPolygonsList);
-        glCallList(_hoveredSectorPolygonBorderLinesList);
+        qglColor(Settings::firHighlightedFillColor());
+        m_hoveredSectorPolygonsBatch.draw();
+        glCallList(_hoveredAirportControllersList);
+        if (!qFuzzyIsNull(Settings::firHighlightedBorderLineStrength())) {
+            qglColor(Settings::firHighlightedBorderLineColor());
+            glLineWidth(Settings::firHighlightedBorderLineStrength());
+            m_hoveredSectorBorderLinesBatch.draw();
+        }
     }
 
     // render sectors independently from Whazzup
     if (m_staticSectors.size() > 0) {
-        glCallList(_staticSectorPolygonsList);
-        glCallList(_staticSectorPolygonBorderLinesList);
+        qglColor(Settings::firFillColor());
+        m_staticSectorPolygonsBatch.draw();
+        if (!qFuzzyIsNull(Settings::firBorderLineStrength())) {
+            qglColor(Settings::firBorderLineColor());
+            glLineWidth(Settings::firBorderLineStrength());
+            m_staticSectorBorderLinesBatch.draw();
+        }
     }
 
-    QList<Airport*> airportList = NavData::instance()->airports.values();
-    // render Approach
+    // render Approach, Tower, Ground/Delivery
+    // glCallList() only queues the commands: to time the GPU work as well,
+    // the pass is bracketed with glFinish() when the timing is shown
+    const bool isTimingAtc = Settings::showFps();
+    if (isTimingAtc) {
+        glFinish();
+    }
+    QElapsedTimer atcTimer;
+    atcTimer.start();
     if (Settings::showAPP()) {
-        foreach (Airport* a, airportList) {
-            if (!a->appDeps.isEmpty()) {
-                glCallList(a->appDisplayList());
-            }
-        }
+        glCallList(_appList);
     }
-
-    // render Tower
     if (Settings::showTWR()) {
-        foreach (Airport* a, airportList) {
-            if (!a->twrs.isEmpty()) {
-                glCallList(a->twrDisplayList());
-            }
-        }
+        glCallList(_twrList);
     }
-
-    // render Ground/Delivery
     if (Settings::showGND()) {
-        foreach (Airport* a, airportList) {
-            if (!a->dels.isEmpty()) {
-                glCallList(a->delDisplayList());
-            }
-            if (!a->gnds.isEmpty()) {
-                glCallList(a->gndDisplayList());
-            }
-        }
+        glCallList(_gndDelList);
+    }
+    if (isTimingAtc) {
+        glFinish();
+        m_atcRenderNs = atcTimer.nsecsElapsed();
     }
 
     glCallList(_activeAirportsList);
@@ -1323,7 +1322,21 @@ void GLWidget::paintGL() {
     }
 
     // render pilots
-    glCallList(_pilotsList);
+    if (Settings::timelineSeconds() > 0 && !qFuzzyIsNull(Settings::timeLineStrength())) {
+        glLineWidth(Settings::timeLineStrength());
+        qglColor(Settings::leaderLineColor());
+        m_leaderLinesBatch.draw();
+    }
+    glCallList(_routesList);
+    if (!qFuzzyIsNull(Settings::pilotDotSize())) {
+        glPointSize(Settings::pilotDotSize());
+        qglColor(Settings::pilotDotColor());
+        m_pilotDotsBatch.draw();
+
+        qglColor(Settings::friendsPilotDotColor());
+        glPointSize(Settings::pilotDotSize() * 1.3);
+        m_friendPilotDotsBatch.draw();
+    }
 
 
     // highlight friends
@@ -1375,8 +1388,10 @@ void GLWidget::paintGL() {
         renderText(
             0,
             height() - 2,
-            QString("%1 fps (%2 ms) %3").arg(_fps, 0, 'f', 0)
+            QString("%1 fps (%2 ms, ATC %3 ms for %4 airports) %5").arg(_fps, 0, 'f', 0)
             .arg(_ms, 0, 'i', 0)
+            .arg(m_atcRenderNs / 1000000., 0, 'f', 3)
+            .arg(NavData::instance()->atcAirports.size())
             .arg(_frameToggle? '*': ' '),
             Settings::firFont()
         );
@@ -1422,18 +1437,14 @@ void GLWidget::mouseMoveEvent(QMouseEvent* event) {
     bool _hoveredObjectsDirty = false;
     foreach (const auto &o, _tmpHoveredObjects) {
         if (!m_newHoveredObjects.contains(o)) {
-            foreach (const auto &fr, m_fontRectangles) {
-                if (fr.object == o) {
-                    m_fontRectangles.remove(fr);
-                    m_hoveredObjects.removeOne(o);
-                    _hoveredObjectsDirty = true;
-                    break;
-                }
+            if (m_labelPlacer.take(o)) {
+                m_hoveredObjects.removeOne(o);
+                _hoveredObjectsDirty = true;
             }
         }
     }
     if (_hoveredObjectsDirty) {
-        invalidatePilots(); // for hovered objects' routes
+        invalidateRoutes(); // for hovered objects' routes
         update();
     }
 
@@ -1492,6 +1503,7 @@ void GLWidget::mouseMoveEvent(QMouseEvent* event) {
 
         if (_newHoveredControllers != m_hoveredControllers) {
             m_hoveredControllers = _newHoveredControllers;
+            m_isHoveredControllersListsDirty = true;
 
             invalidateControllers();
             update();
@@ -1616,7 +1628,7 @@ void GLWidget::rightClick(const QPoint& pos) {
         if (PilotDetails::instance(false) != 0) { // can have an effect on the state of
             PilotDetails::instance()->refresh(); // ...PilotDetails::cbPlotRoutes
         }
-        invalidatePilots();
+        invalidateRoutes();
     } else if (pilot != 0) {
         // display flight path for pilot
         GuiMessages::message(
@@ -1627,7 +1639,7 @@ void GLWidget::rightClick(const QPoint& pos) {
         if (PilotDetails::instance(false) != 0) {
             PilotDetails::instance()->refresh();
         }
-        invalidatePilots();
+        invalidateRoutes();
     }
 }
 
@@ -1748,16 +1760,6 @@ void GLWidget::renderLabels() {
             }
         }
 
-        m_inactiveAirportMapObjectsByLatLng.clear();
-        if (Settings::showInactiveAirports()) {
-            foreach (const auto a, NavData::instance()->airports) {
-                if (!a->active) {
-                    QPair<int, int> _tile(a->lat, a->lon);
-                    m_inactiveAirportMapObjectsByLatLng.insert(_tile, a);
-                }
-            }
-        }
-
         m_isAirportsMapObjectsDirty = false;
     }
 
@@ -1765,23 +1767,19 @@ void GLWidget::renderLabels() {
     QList<MapObject*> _inactiveAirportMapObjectsFiltered;
     if (Settings::showInactiveAirports() && _zoom <= _inactiveAirportLabelZoomTreshold) {
         auto _extent = shownLatLonExtent();
+        QList<QPair<int, int> > _tiles;
         for (int _lat = floor(_extent.first.first); _lat <= ceil(_extent.second.first); _lat++) {
             for (int _lon = floor(_extent.first.second); _lon <= ceil(_extent.second.second); _lon++) {
-                _inactiveAirportMapObjectsFiltered += m_inactiveAirportMapObjectsByLatLng.values(
-                    QPair<int, int>(_lat, _lon)
-                );
+                _tiles.append(QPair<int, int>(_lat, _lon));
             }
         }
 
-        // produce a random, but stable distribution
-        std::sort(
-            _inactiveAirportMapObjectsFiltered.begin(),
-            _inactiveAirportMapObjectsFiltered.end(),
-            [](MapObject* a, MapObject* b) {
-                return QCryptographicHash::hash(((Airport*) a)->id.toLatin1(), QCryptographicHash::Md5)
-                    > QCryptographicHash::hash(((Airport*) b)->id.toLatin1(), QCryptographicHash::Md5);
+        // a random, but stable distribution: the tiles are presorted by NavData
+        foreach (const auto a, NavData::instance()->airportsInTiles(_tiles)) {
+            if (!a->active) {
+                _inactiveAirportMapObjectsFiltered.append(a);
             }
-        );
+        }
     }
 
     // pilot labels
@@ -1815,23 +1813,25 @@ void GLWidget::renderLabels() {
     // - we build that list in createPilotsList() now
 
     /**
-     * remove vanished MapObjects from m_fontRectangles to keep positions as sticky as possible
+     * remove vanished MapObjects from m_labelPlacer to keep positions as sticky as possible
      */
-    const QList<MapObject*> allMapObjects =
-        m_controllerMapObjects // big hover area makes it difficult to hover other labels
-        + planFlightWaypointMapObjects
-        + m_activeAirportMapObjects
-        + m_pilotMapObjects
-        + m_usedWaypointMapObjects
-        + _inactiveAirportMapObjectsFiltered // that might hit performance
-    ;
-
-    // update our list of stable positions
-    foreach (const auto &fr, m_fontRectangles) {
-        if (!allMapObjects.contains(fr.object)) {
-            m_fontRectangles.remove(fr);
+    QSet<MapObject*> allMapObjects;
+    allMapObjects.reserve(
+        m_controllerMapObjects.size() + planFlightWaypointMapObjects.size() + m_activeAirportMapObjects.size()
+        + m_pilotMapObjects.size() + m_usedWaypoints.size() + _inactiveAirportMapObjectsFiltered.size()
+    );
+    auto insertAll = [&allMapObjects](const QList<MapObject*>& objects) {
+        foreach (const auto o, objects) {
+            allMapObjects.insert(o);
         }
-    }
+    };
+    insertAll(m_controllerMapObjects);
+    insertAll(planFlightWaypointMapObjects);
+    insertAll(m_activeAirportMapObjects);
+    insertAll(m_pilotMapObjects);
+    insertAll(m_usedWaypoints.values());
+    insertAll(_inactiveAirportMapObjectsFiltered);
+    m_labelPlacer.retain(allMapObjects);
 
     /**
      * Render labels
@@ -1850,18 +1850,16 @@ void GLWidget::renderLabels() {
     );
 
     // static sectors - render directly, no questions asked
-    qglColor(Settings::friendsHighlightColor()); // just something different from normal sectors
     foreach (const Sector* sector, m_staticSectors) {
         QPair<double, double> center = sector->getCenter();
-        if (center.first > -180.) {
-            double lat = center.first;
-            double lon = center.second;
-            renderText(
-                SX(lat, lon),
-                SY(lat, lon),
-                SZ(lat, lon),
+        int x, y;
+        if (center.first > -180. && latLon2local(center.first, center.second, &x, &y)) {
+            m_glyphAtlas->addText(
+                x,
+                y,
                 sector->icao,
-                Settings::firFont()
+                Settings::firFont(),
+                Settings::friendsHighlightColor() // just something different from normal sectors
             );
         }
     }
@@ -1899,7 +1897,7 @@ void GLWidget::renderLabels() {
     // waypoints used in shown routes
     if (Settings::showUsedWaypoints()) {
         renderLabels(
-            m_usedWaypointMapObjects,
+            m_usedWaypoints.values(),
             _usedWaypointsLabelZoomThreshold,
             Settings::waypointsFont(),
             Settings::waypointsFontColor(),
@@ -1922,6 +1920,9 @@ void GLWidget::renderLabels() {
         );
     }
 
+    // all text so far in one go, below the hovered labels' backdrops
+    m_glyphAtlas->draw(width(), height());
+
     // last (but always rendered): hovered objects
     foreach (const auto renderLabelCommand, m_prioritizedLabels) {
         renderLabels(
@@ -1937,6 +1938,7 @@ void GLWidget::renderLabels() {
         );
     }
     m_prioritizedLabels.clear();
+    m_glyphAtlas->draw(width(), height());
 }
 
 void GLWidget::renderLabels(
@@ -1955,9 +1957,6 @@ void GLWidget::renderLabels(
         return;
     }
 
-    QFontMetricsF fontMetrics(font, this);
-    QFontMetricsF fontMetricsSecondary(secondaryFont, this);
-
     foreach (MapObject* o, objects) {
         int x, y;
         if (!latLon2local(o->lat, o->lon, &x, &y)) {
@@ -2001,18 +2000,14 @@ void GLWidget::renderLabels(
 
         FontRectangle useRect;
         // look if we have previously drawn that label
-        foreach (const auto &fr, m_fontRectangles) {
-            if (fr.object == o) {
-                useRect = fr;
-                m_fontRectangles.remove(fr);
-                break;
-            }
+        if (m_labelPlacer.take(o, &useRect.rect)) {
+            useRect.object = o;
         }
 
         if (
             !isHovered
             && useRect.object == 0
-            && m_fontRectangles.size() + m_prioritizedLabels.size() >= Settings::maxLabels()
+            && m_labelPlacer.size() + m_prioritizedLabels.size() >= Settings::maxLabels()
         ) {
             if (isFastBail) {
                 return;
@@ -2028,8 +2023,7 @@ void GLWidget::renderLabels(
 
         const QString &firstLine = isHovered? o->mapLabelHovered(): o->mapLabel();
 
-        // tightBoundingRect() might be slow on Windows according to docs
-        QRectF firstLineRect = fontMetrics.tightBoundingRect(firstLine);
+        QRectF firstLineRect = m_glyphAtlas->tightBoundingRect(font, firstLine);
         float firstLineOffset = -firstLineRect.top();
         firstLineRect.moveTop(0);
         QRectF rect(firstLineRect); // complete boundingRect
@@ -2047,7 +2041,7 @@ void GLWidget::renderLabels(
         QList<QRectF> secondaryRects;
         float secondaryLinesOffset = 0.;
         for (int iLine = 0; iLine < secondaryLines.size(); iLine++) {
-            auto _rect = fontMetricsSecondary.tightBoundingRect(secondaryLines[iLine]);
+            auto _rect = m_glyphAtlas->tightBoundingRect(secondaryFont, secondaryLines[iLine]);
             secondaryLinesOffset = -_rect.top();
             _rect.moveTop(rect.bottom());
             secondaryRects.insert(iLine, _rect);
@@ -2112,7 +2106,7 @@ void GLWidget::renderLabels(
             };
 
             for (unsigned short i = 0; i <= tryNOtherPositions && i < rects.count(); i++) {
-                if (shouldDrawLabel(rects[i])) {
+                if (m_labelPlacer.isFree(rects[i])) {
                     useRect.rect = rects[i];
                     useRect.object = o;
                     // we have not drawn that object before
@@ -2168,22 +2162,22 @@ void GLWidget::renderLabels(
                     // draw text shadow
                     if (isHovered) {
                         const auto shadowColor = Helpers::shadowColorForBg(bgColor);
-                        qglColor(shadowColor);
-                        renderText(
+                        m_glyphAtlas->addText(
                             useRect.rect.left() + (useRect.rect.width() - firstLineRect.width()) / 2 + 1,
                             useRect.rect.top() + backdropMargin.top() + firstLineRect.top() + firstLineOffset + 1,
                             firstLine,
-                            font
+                            font,
+                            shadowColor
                         );
 
                         const auto shadowSecondaryColor = Helpers::shadowColorForBg(bgColor);
-                        qglColor(shadowSecondaryColor);
                         for (int iLine = 0; iLine < secondaryLines.size(); iLine++) {
-                            renderText(
+                            m_glyphAtlas->addText(
                                 useRect.rect.left() + (useRect.rect.width() - secondaryRects[iLine].width()) / 2 + 1,
                                 useRect.rect.top() + backdropMargin.top() + secondaryRects[iLine].top() + secondaryLinesOffset + 1,
                                 secondaryLines[iLine],
-                                secondaryFont
+                                secondaryFont,
+                                shadowSecondaryColor
                             );
                         }
                     }
@@ -2223,36 +2217,27 @@ void GLWidget::renderLabels(
             }
         }
 
-        qglColor(thisColor);
-        renderText(
+        m_glyphAtlas->addText(
             useRect.rect.left() + (useRect.rect.width() - firstLineRect.width()) / 2,
             useRect.rect.top() + backdropMargin.top() + firstLineRect.top() + firstLineOffset,
             firstLine,
-            font
+            font,
+            thisColor
         );
-        qglColor(thisSecondaryColor);
         for (int iLine = 0; iLine < secondaryLines.size(); iLine++) {
-            renderText(
+            m_glyphAtlas->addText(
                 useRect.rect.left() + (useRect.rect.width() - secondaryRects[iLine].width()) / 2,
                 useRect.rect.top() + backdropMargin.top() + secondaryRects[iLine].top() + secondaryLinesOffset,
                 secondaryLines[iLine],
-                secondaryFont
+                secondaryFont,
+                thisSecondaryColor
             );
         }
 
-        m_fontRectangles.insert(useRect);
+        m_labelPlacer.place(useRect.object, useRect.rect);
     }
 }
 
-bool GLWidget::shouldDrawLabel(const QRectF &rect) {
-    foreach (const FontRectangle &fr, m_fontRectangles) {
-        if (rect.intersects(fr.rect)) {
-            return false;
-        }
-    }
-    return true;
-}
-
 QList<GLWidget::FontRectangle> GLWidget::fontRectanglesPrioritized() const {
     auto priorityFor = [](const FontRectangle& fr) ->char {
             if (qobject_cast<Airport*>(fr.object) != nullptr) {
@@ -2269,7 +2254,11 @@ QList<GLWidget::FontRectangle> GLWidget::fontRectanglesPrioritized() const {
     ;
 
     QMultiMap<char, GLWidget::FontRectangle> sorted;
-    foreach (const auto &fr, m_fontRectangles) {
+    const QHash<MapObject*, QRectF> &placements = m_labelPlacer.placements();
+    for (auto it = placements.constBegin(); it != placements.constEnd(); ++it) {
+        FontRectangle fr;
+        fr.rect = it.value();
+        fr.object = it.key();
         sorted.insert(priorityFor(fr), fr);
     }
 
@@ -2369,16 +2358,11 @@ void GLWidget::updateHoverState() {
     // remove from fontRectangles when not hovered any more
     foreach (const auto &o, m_hoveredObjects) {
         if (!m_newHoveredObjects.contains(o)) {
-            foreach (const auto &fr, m_fontRectangles) {
-                if (fr.object == o) {
-                    m_fontRectangles.remove(fr);
-                    break;
-                }
-            }
+            m_labelPlacer.remove(o);
         }
     }
     m_hoveredObjects = m_newHoveredObjects;
-    invalidatePilots(); // for hovered objects' routes
+    invalidateRoutes(); // for hovered objects' routes
     update();
 }
 
@@ -2398,10 +2382,11 @@ QList<MapObject*> GLWidget::objectsAt(int x, int y, double radiusSimple) const {
     double radiusDegQuad = Nm2Deg((qFuzzyIsNull(radiusSimple)? 30. * _zoom: radiusSimple));
     radiusDegQuad *= radiusDegQuad;
 
-    foreach (Airport* a, NavData::instance()->airports.values()) {
+    const double radiusDeg = qSqrt(radiusDegQuad);
+    foreach (Airport* a, NavData::instance()->airportsIndex.inBox(lat - radiusDeg, lon - radiusDeg, lat + radiusDeg, lon + radiusDeg)) {
         if (a->active) {
             double x = a->lat - lat;
-            double y = a->lon - lon;
+            double y = GeoGrid::normalizedLon(a->lon - lon);
             if (x * x + y * y < radiusDegQuad) {
                 if (!result.contains(a)) {
                     result.append(a);
@@ -2434,9 +2419,9 @@ QList<MapObject*> GLWidget::objectsAt(int x, int y, double radiusSimple) const {
 //        }
 //    }
 
-    foreach (Pilot* p, Whazzup::instance()->whazzupData().pilots.values()) {
+    foreach (Pilot* p, m_pilotsIndex.inBox(lat - radiusDeg, lon - radiusDeg, lat + radiusDeg, lon + radiusDeg)) {
         double x = p->lat - lat;
-        double y = p->lon - lon;
+        double y = GeoGrid::normalizedLon(p->lon - lon);
         if (x * x + y * y < radiusDegQuad) {
             if (!result.contains(p)) {
                 result.append(p);
@@ -2600,18 +2585,59 @@ void GLWidget::newWhazzupData(bool isNew) {
     qDebug() << "isNew =" << isNew;
     if (isNew) {
         // update airports
-        NavData::instance()->updateData(Whazzup::instance()->whazzupData());
+        NavData::instance()->updateData(Whazzup::instance()->whazzupData(), Whazzup::instance()->airportActivity());
 
         m_hoveredObjects.clear();
-        m_fontRectangles.clear();
-        invalidatePilots();
-        invalidateControllers();
+        m_labelPlacer.clear();
+        const WhazzupDelta &delta = Whazzup::instance()->lastDelta();
+        if (delta.hasPilotChanges()) {
+            m_isPilotMapObjectsDirty = true;
+            invalidateRoutes();
+        }
+        if (delta.isFullUpdate) {
+            m_isPilotBatchesDirty = true;
+        } else {
+            m_pendingPilotCallsigns += delta.pilotsAdded;
+            m_pendingPilotCallsigns += delta.pilotsMoved;
+            m_pendingPilotCallsigns += delta.pilotsRemoved;
+        }
+        updateFriendPilots();
+        if (delta.hasControllerChanges()) {
+            invalidateControllers();
+        }
         invalidateAirports();
-        m_friendPositions = Whazzup::instance()->whazzupData().friendsLatLon();
+
+        m_pilotsIndex.clear();
+        foreach (Pilot* p, Whazzup::instance()->whazzupData().pilots) {
+            m_pilotsIndex.insert(p->lat, p->lon, p);
+        }
     }
     qDebug() << "-- finished";
 }
 
+void GLWidget::updateFriendPilots() {
+    // pilots that became or stopped being a friend move between the dot batches
+    QSet<QString> friendPilotCallsigns;
+    foreach (const Pilot* p, Whazzup::instance()->whazzupData().pilots) {
+        if (p->isFriend()) {
+            friendPilotCallsigns.insert(p->callsign);
+        }
+    }
+    m_pendingPilotCallsigns += QSet<QString>(friendPilotCallsigns).subtract(m_friendPilotCallsigns);
+    m_pendingPilotCallsigns += QSet<QString>(m_friendPilotCallsigns).subtract(friendPilotCallsigns);
+    m_friendPilotCallsigns = friendPilotCallsigns;
+    m_friendPositions = Whazzup::instance()->whazzupData().friendsLatLon();
+}
+
+void GLWidget::friendsChanged() {
+    updateFriendPilots();
+    // friends are labelled first and highlighted at their airports
+    m_isPilotMapObjectsDirty = true;
+    m_labelPlacer.clear();
+    invalidateAirports();
+    update();
+}
+
 void GLWidget::configureUpdateTimer() {
     const bool isRunFullFps = Settings::highlightFriends() && Settings::animateFriendsHighlight();
 
@@ -3,8 +3,13 @@
 
 #include "ClientSelectionWidget.h"
 #include "Controller.h"
+#include "GeoIndex.h"
+#include "GlyphAtlas.h"
+#include "LabelPlacer.h"
 #include "MapObject.h"
+#include "OrderedSet.h"
 #include "Sector.h"
+#include "VertexBatch.h"
 #include "src/helpers.h"
 
 #include <qglobal.h>
@@ -78,7 +83,11 @@ class GLWidget
 
         const QPair<double, double> sunZenith(const QDateTime &dt) const;
 
+        void invalidateRoutes();
         void createPilotsList();
+        void updatePilotBatches();
+        void updateFriendPilots(); // friend pilot dots and positions
+        void updatePilotVertices(const QString& callsign, const Pilot* p);
         void createAirportsList();
         void createControllerLists();
         void createStaticLists();
@@ -92,26 +101,33 @@ class GLWidget
         QPoint _lastPos, _mouseDownPos;
         bool m_isMapMoving, m_isMapZooming, m_isMapRectSelecting, _lightsGenerated;
         bool m_isPilotsListDirty = true, m_isAirportsListDirty = true, m_isControllerListsDirty = true, m_isStaticSectorListsDirty = true,
+            m_isHoveredControllersListsDirty = true, m_isPilotBatchesDirty = true,
             m_isAirportsMapObjectsDirty = true, m_isControllerMapObjectsDirty = true, m_isPilotMapObjectsDirty = true, m_isUsedWaypointMapObjectsDirty = true;
         GLUquadricObj* _earthQuad;
         GLuint _earthTex, _fadeOutTex,
-            _earthList, _coastlinesList, _countriesList, _gridlinesList,
-            _pilotsList, _activeAirportsList, _inactiveAirportsList,
-            _usedWaypointsList, _plannedRouteList,
-            _sectorPolygonsList, _sectorPolygonBorderLinesList, _congestionsList,
-            _staticSectorPolygonsList, _staticSectorPolygonBorderLinesList,
-            _hoveredSectorPolygonsList, _hoveredSectorPolygonBorderLinesList;
+            _earthList, _routesList, _activeAirportsList, _inactiveAirportsList,
+            _usedWaypointsList, _congestionsList, _hoveredAirportControllersList,
+            _appList, _twrList, _gndDelList;
+        VertexBatch m_coastlinesBatch { GL_LINES }, m_countriesBatch { GL_LINES }, m_gridlinesBatch { GL_LINES },
+            m_sectorPolygonsBatch { GL_TRIANGLES }, m_sectorBorderLinesBatch { GL_LINES },
+            m_staticSectorPolygonsBatch { GL_TRIANGLES }, m_staticSectorBorderLinesBatch { GL_LINES },
+            m_hoveredSectorPolygonsBatch { GL_TRIANGLES }, m_hoveredSectorBorderLinesBatch { GL_LINES },
+            m_friendPilotDotsBatch { GL_POINTS, QOpenGLBuffer::DynamicDraw };
+        // updated from the Whazzup delta: only pilots that changed get rewritten
+        KeyedVertexBatch m_pilotDotsBatch { GL_POINTS, 1 }, m_leaderLinesBatch { GL_LINES, 2 };
+        QSet<QString> m_pendingPilotCallsigns, m_friendPilotCallsigns;
         QSet<Controller*> m_hoveredControllers;
         double _pilotLabelZoomTreshold, _activeAirportLabelZoomTreshold, _inactiveAirportLabelZoomTreshold,
             _controllerLabelZoomTreshold, _usedWaypointsLabelZoomThreshold,
             _xRot, _yRot, _zRot, _zoom, _aspectRatio;
+        qint64 m_atcRenderNs = 0; // shown with Settings::showFps()
         QTimer* m_updateTimer;
         QTimer* m_hoverDebounceTimer;
         QList< QPair<double, double> > m_friendPositions;
+        GeoIndex<Pilot*> m_pilotsIndex;
         QList<MapObject*> m_hoveredObjects, m_newHoveredObjects;
-        QMultiHash<QPair<int, int>, MapObject*> m_inactiveAirportMapObjectsByLatLng;
-        QList<MapObject*> m_activeAirportMapObjects, m_controllerMapObjects, m_pilotMapObjects,
-            m_usedWaypointMapObjects;
+        QList<MapObject*> m_activeAirportMapObjects, m_controllerMapObjects, m_pilotMapObjects;
+        OrderedSet<MapObject*> m_usedWaypoints;
 
         void renderLabels();
         void renderLabels(
@@ -125,7 +141,6 @@ class GLWidget
             const unsigned short tryNOtherPositions = 3,
             const bool isHoverRenderPass = false
         );
-        bool shouldDrawLabel(const QRectF &rect);
         struct RenderLabelsCommand {
             QList<MapObject*> objects;
             double zoomTreshold;
@@ -138,7 +153,8 @@ class GLWidget
         };
         QList<RenderLabelsCommand> m_prioritizedLabels;
         QList<FontRectangle>fontRectanglesPrioritized() const;
-        QSet<FontRectangle> m_fontRectangles;
+        LabelPlacer m_labelPlacer;
+        GlyphAtlas* m_glyphAtlas;
 
         void drawTestTextures();
         void drawBillboardScreenSize(GLfloat lat, GLfloat lon, const QSize& size);
@@ -148,15 +164,7 @@ class GLWidget
 
     private slots:
         void updateHoverState();
+        void friendsChanged();
 };
 
-inline bool operator==(const GLWidget::FontRectangle &e1, const GLWidget::FontRectangle &e2) {
-    return e1.object == e2.object
-        && e1.rect == e2.rect;
-}
-
-inline uint qHash(const GLWidget::FontRectangle &key, uint seed) {
-    return qHash(key.object, seed);
-}
-
 #endif
@@ -0,0 +1,79 @@
+#include "GeoIndex.h"
+
+#include "helpers.h"
+#include "NavData.h"
+
+GeoGrid::GeoGrid(double cellSizeDeg)
+    : _cellSize(cellSizeDeg),
+      _rows(qCeil(180. / cellSizeDeg)),
+      _cols(qCeil(360. / cellSizeDeg)) {}
+
+int GeoGrid::cellCount() const {
+    return _rows * _cols;
+}
+
+double GeoGrid::normalizedLon(double lon) {
+    if (lon >= -180. && lon < 180.) {
+        return lon;
+    }
+    return Helpers::modPositive(lon + 180., 360.) - 180.;
+}
+
+bool GeoGrid::spansAllLongitudes(double west, double east) {
+    return east - west >= 360.;
+}
+
+int GeoGrid::cellAt(double lat, double lon) const {
+    const int row = qBound(0, (int) ((lat + 90.) / _cellSize), _rows - 1);
+    const int col = qBound(0, (int) ((normalizedLon(lon) + 180.) / _cellSize), _cols - 1);
+    return row * _cols + col;
+}
+
+QVector<int> GeoGrid::cellsInBox(double south, double west, double north, double east) const {
+    QVector<int> result;
+    const int rowFrom = qBound(0, (int) ((qMax(south, -90.) + 90.) / _cellSize), _rows - 1);
+    const int rowTo = qBound(0, (int) ((qMin(north, 90.) + 90.) / _cellSize), _rows - 1);
+    int colFrom = qBound(0, (int) ((normalizedLon(west) + 180.) / _cellSize), _cols - 1);
+    int colTo = qBound(0, (int) ((normalizedLon(east) + 180.) / _cellSize), _cols - 1);
+    if (
+        spansAllLongitudes(west, east)
+        || (normalizedLon(west) > normalizedLon(east) && colFrom <= colTo) // wraps within one column
+    ) {
+        colFrom = 0;
+        colTo = _cols - 1;
+    }
+
+    for (int row = rowFrom; row <= rowTo; row++) {
+        if (colFrom <= colTo) {
+            for (int col = colFrom; col <= colTo; col++) {
+                result.append(row * _cols + col);
+            }
+        } else { // across the antimeridian
+            for (int col = colFrom; col < _cols; col++) {
+                result.append(row * _cols + col);
+            }
+            for (int col = 0; col <= colTo; col++) {
+                result.append(row * _cols + col);
+            }
+        }
+    }
+    return result;
+}
+
+QVector<int> GeoGrid::cellsInRadius(double lat, double lon, double radiusNm) const {
+    const double dLat = radiusNm / 60.;
+    const double south = lat - dLat, north = lat + dLat;
+    if (south <= -90. || north >= 90.) { // includes a pole: all longitudes
+        return cellsInBox(south, -180., north, 180.);
+    }
+    // longitude degrees are shortest at the box edge closest to a pole
+    const double dLon = dLat / qCos(qMax(qAbs(south), qAbs(north)) * Pi180);
+    if (dLon >= 180.) {
+        return cellsInBox(south, -180., north, 180.);
+    }
+    return cellsInBox(south, lon - dLon, north, lon + dLon);
+}
+
+double GeoGrid::distance(double lat1, double lon1, double lat2, double lon2) {
+    return NavData::distance(lat1, lon1, lat2, lon2);
+}
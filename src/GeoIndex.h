@@ -0,0 +1,109 @@
+#ifndef GEOINDEX_H_
+#define GEOINDEX_H_
+
+#include <QtCore>
+
+// latitude/longitude grid math shared by all GeoIndex instances
+class GeoGrid {
+    public:
+        GeoGrid(double cellSizeDeg);
+
+        int cellCount() const;
+        int cellAt(double lat, double lon) const;
+        // west > east wraps across the antimeridian, east - west >= 360 is all longitudes
+        QVector<int> cellsInBox(double south, double west, double north, double east) const;
+        QVector<int> cellsInRadius(double lat, double lon, double radiusNm) const;
+
+        static double normalizedLon(double lon);
+        // e.g. -180 to 180, which would otherwise normalize to the single longitude -180
+        static bool spansAllLongitudes(double west, double east);
+        static double distance(double lat1, double lon1, double lat2, double lon2);
+    protected:
+        double _cellSize;
+        int _rows, _cols;
+};
+
+/**
+ * Bucketed lat/lon grid for radius and bounding box queries.
+ * Values are stored by copy, so use pointers for objects.
+ */
+template <typename T>
+class GeoIndex
+    : public GeoGrid {
+    public:
+        GeoIndex(double cellSizeDeg = 1.)
+            : GeoGrid(cellSizeDeg), _cells(cellCount()), _size(0) {}
+
+        void clear() {
+            for (int i = 0; i < _cells.size(); i++) {
+                _cells[i].clear();
+            }
+            _size = 0;
+        }
+
+        void insert(double lat, double lon, const T& value) {
+            _cells[cellAt(lat, lon)].append({ lat, normalizedLon(lon), value });
+            _size++;
+        }
+
+        int size() const {
+            return _size;
+        }
+
+        QList<T> inBox(double south, double west, double north, double east) const {
+            QList<T> result;
+            const bool isAllLons = spansAllLongitudes(west, east);
+            const QVector<int> cells = cellsInBox(south, west, north, east);
+            // 180 becomes -180, like the stored longitudes, so an east edge of 180 wraps
+            west = normalizedLon(west);
+            east = normalizedLon(east);
+            const bool wraps = west > east;
+            foreach (const int cell, cells) {
+                foreach (const Entry &e, _cells[cell]) {
+                    if (
+                        e.lat >= south && e.lat <= north
+                        && (isAllLons || (wraps? (e.lon >= west || e.lon <= east): (e.lon >= west && e.lon <= east)))
+                    ) {
+                        result.append(e.value);
+                    }
+                }
+            }
+            return result;
+        }
+
+        QList<T> inRadius(double lat, double lon, double radiusNm) const {
+            QList<T> result;
+            foreach (const int cell, cellsInRadius(lat, lon, radiusNm)) {
+                foreach (const Entry &e, _cells[cell]) {
+                    if (distance(lat, lon, e.lat, e.lon) <= radiusNm) {
+                        result.append(e.value);
+                    }
+                }
+            }
+            return result;
+        }
+
+        T nearest(double lat, double lon, double maxDistNm, const T& notFound = T()) const {
+            T result = notFound;
+            double minDist = maxDistNm;
+            foreach (const int cell, cellsInRadius(lat, lon, maxDistNm)) {
+                foreach (const Entry &e, _cells[cell]) {
+                    const double d = distance(lat, lon, e.lat, e.lon);
+                    if (d <= minDist) {
+                        result = e.value;
+                        minDist = d;
+                    }
+                }
+            }
+            return result;
+        }
+    private:
+        struct Entry {
+            double lat, lon;
+            T value;
+        };
+        QVector<QVector<Entry> > _cells;
+        int _size;
+};
+
+#endif /*GEOINDEX_H_*/
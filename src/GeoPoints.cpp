@@ -0,0 +1,118 @@
+#include "GeoPoints.h"
+
+#include "helpers.h"
+
+#include <cmath>
+
+void GeoPoints::reserve(int size) {
+    _lat.reserve(size);
+    _lon.reserve(size);
+    _x.reserve(size);
+    _y.reserve(size);
+    _z.reserve(size);
+}
+
+void GeoPoints::append(double lat, double lon) {
+    const double cosLat = qCos(lat * Pi180);
+    _lat.append(lat);
+    _lon.append(lon);
+    _x.append(cosLat * qCos(lon * Pi180));
+    _y.append(cosLat * qSin(lon * Pi180));
+    _z.append(qSin(lat * Pi180));
+}
+
+void GeoPoints::clear() {
+    _lat.clear();
+    _lon.clear();
+    _x.clear();
+    _y.clear();
+    _z.clear();
+}
+
+int GeoPoints::size() const {
+    return _lat.size();
+}
+
+double GeoPoints::lat(int i) const {
+    return _lat[i];
+}
+
+double GeoPoints::lon(int i) const {
+    return _lon[i];
+}
+
+QVector<double> GeoPoints::distancesTo(double lat, double lon) const {
+    const double cosLat = qCos(lat * Pi180);
+    const double x = cosLat * qCos(lon * Pi180), y = cosLat * qSin(lon * Pi180), z = qSin(lat * Pi180);
+    const int n = size();
+    const double* px = _x.constData();
+    const double* py = _y.constData();
+    const double* pz = _z.constData();
+
+    QVector<double> result(n);
+    double* r = result.data();
+    // cosine of the central angle, then the angle: two separate loops keep the first one vectorizable
+    for (int i = 0; i < n; i++) {
+        r[i] = qBound(-1., x * px[i] + y * py[i] + z * pz[i], 1.);
+    }
+    for (int i = 0; i < n; i++) {
+        r[i] = std::acos(r[i]) * 60. / Pi180;
+    }
+    return result;
+}
+
+int GeoPoints::nearest(double lat, double lon) const {
+    // the nearest point has the largest dot product: no acos needed
+    const double cosLat = qCos(lat * Pi180);
+    const double x = cosLat * qCos(lon * Pi180), y = cosLat * qSin(lon * Pi180), z = qSin(lat * Pi180);
+    int result = -1;
+    double maxDot = -2.;
+    for (int i = 0; i < size(); i++) {
+        const double dot = x * _x[i] + y * _y[i] + z * _z[i];
+        if (dot > maxDot) {
+            maxDot = dot;
+            result = i;
+        }
+    }
+    return result;
+}
+
+QVector<double> GeoPoints::coursesFrom(double lat, double lon) const {
+    const double sinLat = qSin(lat * Pi180), cosLat = qCos(lat * Pi180);
+    const double sinLon = qSin(lon * Pi180), cosLon = qCos(lon * Pi180);
+    const int n = size();
+
+    QVector<double> result(n);
+    double* r = result.data();
+    for (int i = 0; i < n; i++) {
+        // cos(lat2) * sin(lon2 - lon1) and cos(lat2) * cos(lon2 - lon1)
+        const double sinDLon = _y[i] * cosLon - _x[i] * sinLon;
+        const double cosDLon = _x[i] * cosLon + _y[i] * sinLon;
+        const double course = std::atan2(sinDLon, cosLat * _z[i] - sinLat * cosDLon) / Pi180;
+        r[i] = course < 0.? course + 360.: course;
+    }
+    return result;
+}
+
+GeoPoints GeoPoints::fractions(const GeoPoints &from, const GeoPoints &to, const QVector<double> &fractions) {
+    const int n = qMin(qMin(from.size(), to.size()), fractions.size());
+    GeoPoints result;
+    result.reserve(n);
+    for (int i = 0; i < n; i++) {
+        if (qFuzzyCompare(from._lat[i], to._lat[i]) && qFuzzyCompare(from._lon[i], to._lon[i])) {
+            result.append(from._lat[i], from._lon[i]);
+            continue;
+        }
+        const double d = std::acos(qBound(
+            -1., from._x[i] * to._x[i] + from._y[i] * to._y[i] + from._z[i] * to._z[i], 1.
+        ));
+        const double sinD = std::sin(d);
+        const double a = std::sin((1. - fractions[i]) * d) / sinD;
+        const double b = std::sin(fractions[i] * d) / sinD;
+        const double x = a * from._x[i] + b * to._x[i];
+        const double y = a * from._y[i] + b * to._y[i];
+        const double z = a * from._z[i] + b * to._z[i];
+        result.append(std::atan2(z, std::sqrt(x * x + y * y)) / Pi180, std::atan2(y, x) / Pi180);
+    }
+    return result;
+}
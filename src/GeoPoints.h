@@ -0,0 +1,34 @@
+#ifndef GEOPOINTS_H_
+#define GEOPOINTS_H_
+
+#include <QtCore>
+
+/**
+ * Lat/lon points as structure of arrays, with their unit vectors (x towards
+ * 0N 0E, z towards the north pole) precomputed on append(). Batch versions of
+ * the NavData geodesy functions work on these: distances and courses come
+ * down to dot products of the contiguous x, y, z arrays, without sin/cos per
+ * point. Results match the scalar NavData functions up to rounding.
+ */
+class GeoPoints {
+    public:
+        void reserve(int size);
+        void append(double lat, double lon);
+        void clear();
+        int size() const;
+        double lat(int i) const;
+        double lon(int i) const;
+
+        // nm from lat/lon to each point, like NavData::distance()
+        QVector<double> distancesTo(double lat, double lon) const;
+        // index of the point nearest to lat/lon (first one on ties), -1 if empty
+        int nearest(double lat, double lon) const;
+        // true course in degrees from lat/lon to each point, like NavData::courseTo()
+        QVector<double> coursesFrom(double lat, double lon) const;
+        // like NavData::greatCircleFraction() from each point of from to the point with the same index of to
+        static GeoPoints fractions(const GeoPoints& from, const GeoPoints& to, const QVector<double>& fractions);
+    private:
+        QVector<double> _lat, _lon, _x, _y, _z;
+};
+
+#endif /*GEOPOINTS_H_*/
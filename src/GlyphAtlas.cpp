@@ -0,0 +1,216 @@
+#include "GlyphAtlas.h"
+
+GlyphAtlas::GlyphAtlas(QPaintDevice* device)
+    : _device(device), _image(512, 512, QImage::Format_Alpha8) {
+    _image.fill(0);
+}
+
+GlyphAtlas::~GlyphAtlas() {
+    if (_texture != 0) {
+        glDeleteTextures(1, &_texture);
+    }
+    qDeleteAll(_fonts);
+}
+
+int GlyphAtlas::glyphCount() const {
+    return _glyphCount;
+}
+
+GlyphAtlas::FontData* GlyphAtlas::fontData(const QFont& font) {
+    const QString key = font.key();
+    FontData* data = _fonts.value(key, 0);
+    if (data == 0) {
+        data = new FontData(font, _device);
+        _fonts.insert(key, data);
+    }
+    return data;
+}
+
+QRectF GlyphAtlas::tightBoundingRect(const QFont& font, const QString& text) {
+    FontData* data = fontData(font);
+    const QRectF* cached = data->tightBoundingRects.object(text);
+    if (cached != 0) {
+        return *cached;
+    }
+    // tightBoundingRect() might be slow on Windows according to docs
+    const QRectF rect = data->metrics.tightBoundingRect(text);
+    data->tightBoundingRects.insert(text, new QRectF(rect));
+    return rect;
+}
+
+GlyphAtlas::Glyph GlyphAtlas::glyph(FontData* data, uint codePoint) {
+    const auto it = data->glyphs.constFind(codePoint);
+    if (it != data->glyphs.constEnd()) {
+        return it.value();
+    }
+
+    const QString character = QString::fromUcs4(&codePoint, 1);
+    Glyph result;
+    result.advance = data->metrics.horizontalAdvance(character);
+    const QRectF bounds = data->metrics.boundingRect(character);
+    if (!bounds.isEmpty()) { // not for spaces
+        const QRect rect = bounds.toAlignedRect().adjusted(-1, -1, 1, 1);
+
+        // fill the atlas row by row, growing it downwards
+        if (_cursor.x() + rect.width() > _image.width()) {
+            _cursor = QPoint(0, _cursor.y() + _rowHeight);
+            _rowHeight = 0;
+        }
+        while (_cursor.y() + rect.height() > _image.height() && _image.height() < 4096) {
+            QImage bigger(_image.width(), _image.height() * 2, QImage::Format_Alpha8);
+            bigger.fill(0);
+            for (int y = 0; y < _image.height(); y++) {
+                memcpy(bigger.scanLine(y), _image.constScanLine(y), _image.width());
+            }
+            _image = bigger;
+        }
+
+        if (_cursor.y() + rect.height() > _image.height() || rect.width() > _image.width()) {
+            qWarning() << "GlyphAtlas: no space left for" << character << data->font;
+        } else {
+            QImage glyphImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+            glyphImage.setDotsPerMeterX(qRound(_device->logicalDpiX() / .0254));
+            glyphImage.setDotsPerMeterY(qRound(_device->logicalDpiY() / .0254));
+            glyphImage.fill(Qt::transparent);
+            QPainter painter(&glyphImage);
+            painter.setFont(data->font);
+            painter.setPen(Qt::white);
+            painter.drawText(QPointF(-rect.left(), -rect.top()), character);
+            painter.end();
+
+            for (int y = 0; y < rect.height(); y++) {
+                const QRgb* source = reinterpret_cast<const QRgb*>(glyphImage.constScanLine(y));
+                uchar* target = _image.scanLine(_cursor.y() + y) + _cursor.x();
+                for (int x = 0; x < rect.width(); x++) {
+                    target[x] = qAlpha(source[x]);
+                }
+            }
+
+            result.atlasRect = QRect(_cursor, rect.size());
+            result.offset = rect.topLeft();
+            _cursor.rx() += rect.width();
+            _rowHeight = qMax(_rowHeight, rect.height());
+            _isImageDirty = true;
+            _glyphCount++;
+        }
+    }
+
+    data->glyphs.insert(codePoint, result);
+    return result;
+}
+
+void GlyphAtlas::addText(double x, double y, const QString& text, const QFont& font, const QColor& color) {
+    if (color.alpha() == 0 || text.isEmpty()) {
+        return;
+    }
+    FontData* data = fontData(font);
+    const GLubyte rgba[] = {
+        (GLubyte) color.red(), (GLubyte) color.green(), (GLubyte) color.blue(), (GLubyte) color.alpha()
+    };
+
+    double penX = x;
+    for (int i = 0; i < text.size(); i++) {
+        uint codePoint = text[i].unicode();
+        if (text[i].isHighSurrogate() && i + 1 < text.size() && text[i + 1].isLowSurrogate()) {
+            codePoint = QChar::surrogateToUcs4(text[i], text[i + 1]);
+            i++;
+        }
+        const Glyph g = glyph(data, codePoint);
+        if (!g.atlasRect.isEmpty()) {
+            const GLfloat left = qRound(penX + g.offset.x());
+            const GLfloat top = qRound(y + g.offset.y());
+            const GLfloat right = left + g.atlasRect.width();
+            const GLfloat bottom = top + g.atlasRect.height();
+            _positions << left << top << right << top << right << bottom << left << bottom;
+
+            const GLfloat s0 = g.atlasRect.left(), t0 = g.atlasRect.top();
+            const GLfloat s1 = s0 + g.atlasRect.width(), t1 = t0 + g.atlasRect.height();
+            _texCoords << s0 << t0 << s1 << t0 << s1 << t1 << s0 << t1;
+
+            for (int vertex = 0; vertex < 4; vertex++) {
+                _colors << rgba[0] << rgba[1] << rgba[2] << rgba[3];
+            }
+        }
+        penX += g.advance;
+    }
+}
+
+void GlyphAtlas::draw(int width, int height) {
+    if (_positions.isEmpty()) {
+        return;
+    }
+
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT | GL_TRANSFORM_BIT);
+
+    if (_texture == 0) {
+        glGenTextures(1, &_texture);
+        glBindTexture(GL_TEXTURE_2D, _texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    if (_isImageDirty) {
+        // rows of the atlas are not padded: its width is a multiple of 4
+        if (_textureSize != _image.size()) {
+            glTexImage2D(
+                GL_TEXTURE_2D, 0, GL_ALPHA, _image.width(), _image.height(), 0,
+                GL_ALPHA, GL_UNSIGNED_BYTE, _image.constBits()
+            );
+            _textureSize = _image.size();
+        } else {
+            glTexSubImage2D(
+                GL_TEXTURE_2D, 0, 0, 0, _image.width(), _image.height(),
+                GL_ALPHA, GL_UNSIGNED_BYTE, _image.constBits()
+            );
+        }
+        _isImageDirty = false;
+    }
+
+    glDisable(GL_LIGHTING);
+    glDisable(GL_FOG);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_TEXTURE_1D);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // window coordinates, y pointing down. Texture coordinates are in atlas pixels.
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, width, height, 0, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode(GL_TEXTURE);
+    glPushMatrix();
+    glLoadIdentity();
+    glScalef(1. / _image.width(), 1. / _image.height(), 1.);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, _positions.constData());
+    glTexCoordPointer(2, GL_FLOAT, 0, _texCoords.constData());
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, _colors.constData());
+    glDrawArrays(GL_QUADS, 0, _positions.size() / 2);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glPopMatrix(); // texture
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+
+    glPopAttrib();
+
+    // keeps the capacity for the next frame
+    _positions.resize(0);
+    _texCoords.resize(0);
+    _colors.resize(0);
+}
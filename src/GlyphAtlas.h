@@ -0,0 +1,61 @@
+#ifndef GLYPHATLAS_H_
+#define GLYPHATLAS_H_
+
+#include <QtCore>
+#include <QtGui>
+#include <QtOpenGL>
+
+/**
+ * Bitmap glyph atlas shared by all label fonts, plus the text quads queued
+ * for the current frame. Glyphs are rasterized once into a single texture,
+ * so queued text of any font is drawn with one glDrawArrays() in draw().
+ * Positions are window coordinates of the baseline start, like
+ * QGLWidget::renderText(x, y, ...).
+ */
+class GlyphAtlas {
+    public:
+        // device: used for the font metrics (DPI)
+        GlyphAtlas(QPaintDevice* device);
+        ~GlyphAtlas();
+
+        // memoized QFontMetricsF::tightBoundingRect()
+        QRectF tightBoundingRect(const QFont& font, const QString& text);
+
+        void addText(double x, double y, const QString& text, const QFont& font, const QColor& color);
+        // draws and clears the queued text. Needs the GL context to be current.
+        void draw(int width, int height);
+
+        int glyphCount() const;
+    private:
+        struct Glyph {
+            QRect atlasRect; // pixels
+            QPointF offset; // of the top left corner from the baseline start
+            qreal advance;
+        };
+        struct FontData {
+            FontData(const QFont& font, QPaintDevice* device)
+                : font(font), metrics(font, device) {}
+            QFont font;
+            QFontMetricsF metrics;
+            QHash<uint, Glyph> glyphs; // by code point
+            QCache<QString, QRectF> tightBoundingRects { 20000 };
+        };
+
+        FontData* fontData(const QFont& font);
+        Glyph glyph(FontData* data, uint codePoint);
+
+        QPaintDevice* _device;
+        QHash<QString, FontData*> _fonts; // by QFont::key()
+        QImage _image;
+        QPoint _cursor;
+        int _rowHeight = 0, _glyphCount = 0;
+        bool _isImageDirty = true;
+        GLuint _texture = 0;
+        QSize _textureSize;
+
+        // queued quads: 4 vertices each
+        QVector<GLfloat> _positions, _texCoords; // x, y; s, t in atlas pixels
+        QVector<GLubyte> _colors; // r, g, b, a
+};
+
+#endif /*GLYPHATLAS_H_*/
@@ -0,0 +1,72 @@
+#include "GreatCircleCache.h"
+
+#include "helpers.h"
+#include "NavData.h"
+
+GreatCircleCache* greatCircleCacheInstance = 0;
+GreatCircleCache* GreatCircleCache::instance() {
+    if (greatCircleCacheInstance == 0) {
+        greatCircleCacheInstance = new GreatCircleCache();
+    }
+    return greatCircleCacheInstance;
+}
+
+// the cost of an entry is its number of floats: max. 16MB
+GreatCircleCache::GreatCircleCache()
+    : _cache(4 * 1024 * 1024) {}
+
+bool GreatCircleCache::Key::operator==(const Key &other) const {
+    return lat1 == other.lat1 && lon1 == other.lon1
+        && lat2 == other.lat2 && lon2 == other.lon2
+        && intervalNm == other.intervalNm;
+}
+
+uint qHash(const GreatCircleCache::Key &key, uint seed) {
+    seed = qHash(key.lat1, seed) ^ (seed << 1);
+    seed = qHash(key.lon1, seed) ^ (seed << 1);
+    seed = qHash(key.lat2, seed) ^ (seed << 1);
+    seed = qHash(key.lon2, seed) ^ (seed << 1);
+    return qHash(key.intervalNm, seed);
+}
+
+QVector<GLfloat> GreatCircleCache::tessellate(double lat1, double lon1, double lat2, double lon2, double intervalNm) {
+    const auto points = NavData::greatCirclePoints(lat1, lon1, lat2, lon2, intervalNm);
+    QVector<GLfloat> result;
+    result.reserve(points.size() * 3);
+    foreach (const auto &p, points) {
+        result << SX(p.first, p.second) << SY(p.first, p.second) << SZ(p.first, p.second);
+    }
+    return result;
+}
+
+QVector<GLfloat> GreatCircleCache::segment(double lat1, double lon1, double lat2, double lon2, double intervalNm) {
+    const Key key { lat1, lon1, lat2, lon2, intervalNm };
+    const QVector<GLfloat>* cached = _cache.object(key);
+    if (cached != 0) {
+        _hits++;
+        return *cached;
+    }
+    _misses++;
+
+    const QVector<GLfloat> result = tessellate(lat1, lon1, lat2, lon2, intervalNm);
+    _cache.insert(key, new QVector<GLfloat>(result), result.size());
+    return result;
+}
+
+void GreatCircleCache::clear() {
+    _cache.clear();
+    _hits = 0;
+    _misses = 0;
+}
+
+int GreatCircleCache::size() const {
+    return _cache.size();
+}
+
+quint64 GreatCircleCache::hits() const {
+    return _hits;
+}
+
+quint64 GreatCircleCache::misses() const {
+    return _misses;
+}
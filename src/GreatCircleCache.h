@@ -0,0 +1,39 @@
+#ifndef GREATCIRCLECACHE_H_
+#define GREATCIRCLECACHE_H_
+
+#include <QtCore>
+#include <QtOpenGL>
+
+/**
+ * Cache of tessellated great-circle segments as used by
+ * NavData::plotGreatCirclePoints(). A segment is stored as contiguous x, y, z
+ * vertices on the unit sphere (without its end point), keyed on its end
+ * points and the tessellation interval. Route segments between fixed
+ * waypoints survive Whazzup updates this way. Cleared when the AIRAC data gets
+ * reloaded. Only used from the GUI thread.
+ */
+class GreatCircleCache {
+    public:
+        static GreatCircleCache* instance();
+        static QVector<GLfloat> tessellate(double lat1, double lon1, double lat2, double lon2, double intervalNm);
+
+        QVector<GLfloat> segment(double lat1, double lon1, double lat2, double lon2, double intervalNm);
+        void clear();
+
+        int size() const;
+        quint64 hits() const;
+        quint64 misses() const;
+    private:
+        GreatCircleCache();
+
+        struct Key {
+            double lat1, lon1, lat2, lon2, intervalNm;
+            bool operator==(const Key& other) const;
+        };
+        friend uint qHash(const GreatCircleCache::Key& key, uint seed);
+
+        QCache<Key, QVector<GLfloat> > _cache;
+        quint64 _hits = 0, _misses = 0;
+};
+
+#endif /*GREATCIRCLECACHE_H_*/
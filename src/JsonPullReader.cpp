@@ -0,0 +1,336 @@
+#include "JsonPullReader.h"
+
+#include <limits>
+
+JsonPullReader::JsonPullReader(const QByteArray& bytes)
+    : _data(bytes.constData()), _size(bytes.size()), _pos(0) {}
+
+bool JsonPullReader::hasError() const {
+    return !_error.isNull();
+}
+
+QString JsonPullReader::errorString() const {
+    return _error;
+}
+
+void JsonPullReader::setError(const QString& message) {
+    if (hasError()) {
+        return;
+    }
+    _error = QString("%1 at offset %2").arg(message).arg(_pos);
+    _pos = _size; // stop all further reading
+}
+
+void JsonPullReader::skipWhitespace() {
+    while (_pos < _size) {
+        const char c = _data[_pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            return;
+        }
+        _pos++;
+    }
+}
+
+bool JsonPullReader::expect(char c) {
+    skipWhitespace();
+    if (_pos < _size && _data[_pos] == c) {
+        _pos++;
+        return true;
+    }
+    setError(QString("expected '%1'").arg(c));
+    return false;
+}
+
+JsonPullReader::TokenType JsonPullReader::peek() {
+    skipWhitespace();
+    if (_pos >= _size) {
+        return Invalid;
+    }
+    switch (_data[_pos]) {
+        case '{': return BeginObject;
+        case '}': return EndObject;
+        case '[': return BeginArray;
+        case ']': return EndArray;
+        case '"': return String;
+        case 't':
+        case 'f': return Bool;
+        case 'n': return Null;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9': return Number;
+    }
+    return Invalid;
+}
+
+bool JsonPullReader::beginObject() {
+    if (peek() != BeginObject) {
+        skipValue();
+        return false;
+    }
+    _pos++;
+    return true;
+}
+
+bool JsonPullReader::beginArray() {
+    if (peek() != BeginArray) {
+        skipValue();
+        return false;
+    }
+    _pos++;
+    return true;
+}
+
+bool JsonPullReader::nextKey(QLatin1String& key) {
+    skipWhitespace();
+    if (_pos >= _size) {
+        setError("unexpected end of object");
+        return false;
+    }
+    if (_data[_pos] == ',') {
+        _pos++;
+        skipWhitespace();
+    }
+    if (_pos < _size && _data[_pos] == '}') {
+        _pos++;
+        return false;
+    }
+
+    const char* begin;
+    int length;
+    bool hasEscapes;
+    if (!scanString(&begin, &length, &hasEscapes) || !expect(':')) {
+        return false;
+    }
+    if (hasEscapes) {
+        _keyBuffer = unescape(begin, length).toLatin1();
+        key = QLatin1String(_keyBuffer.constData(), _keyBuffer.size());
+    } else {
+        key = QLatin1String(begin, length);
+    }
+    return true;
+}
+
+bool JsonPullReader::nextElement() {
+    skipWhitespace();
+    if (_pos >= _size) {
+        setError("unexpected end of array");
+        return false;
+    }
+    if (_data[_pos] == ',') {
+        _pos++;
+        skipWhitespace();
+    }
+    if (_pos < _size && _data[_pos] == ']') {
+        _pos++;
+        return false;
+    }
+    return !hasError();
+}
+
+bool JsonPullReader::scanString(const char** begin, int* length, bool* hasEscapes) {
+    if (!expect('"')) {
+        return false;
+    }
+    *begin = _data + _pos;
+    *hasEscapes = false;
+    while (_pos < _size) {
+        const char c = _data[_pos];
+        if (c == '"') {
+            *length = static_cast<int>(_data + _pos - *begin);
+            _pos++;
+            return true;
+        }
+        if (c == '\\') {
+            *hasEscapes = true;
+            _pos++;
+        }
+        _pos++;
+    }
+    setError("unterminated string");
+    return false;
+}
+
+bool JsonPullReader::scanNumber(const char** begin, int* length, bool* isInteger) {
+    skipWhitespace();
+    *begin = _data + _pos;
+    *isInteger = true;
+    if (_pos < _size && _data[_pos] == '-') {
+        _pos++;
+    }
+    while (_pos < _size) {
+        const char c = _data[_pos];
+        if (c >= '0' && c <= '9') {
+            _pos++;
+        } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+            *isInteger = false;
+            _pos++;
+        } else {
+            break;
+        }
+    }
+    *length = static_cast<int>(_data + _pos - *begin);
+    if (*length == 0 || (*length == 1 && **begin == '-')) {
+        setError("invalid number");
+        return false;
+    }
+    return true;
+}
+
+bool JsonPullReader::scanLiteral(const char* literal) {
+    skipWhitespace();
+    const int length = static_cast<int>(qstrlen(literal));
+    if (_size - _pos >= length && qstrncmp(_data + _pos, literal, length) == 0) {
+        _pos += length;
+        return true;
+    }
+    setError("invalid literal");
+    return false;
+}
+
+QString JsonPullReader::unescape(const char* begin, int length) const {
+    QString result;
+    result.reserve(length);
+    const char* end = begin + length;
+    const char* runStart = begin;
+    for (const char* p = begin; p < end; p++) {
+        if (*p != '\\') {
+            continue;
+        }
+        result += QString::fromUtf8(runStart, static_cast<int>(p - runStart));
+        p++;
+        if (p >= end) {
+            break;
+        }
+        switch (*p) {
+            case 'b': result += QChar('\b'); break;
+            case 'f': result += QChar('\f'); break;
+            case 'n': result += QChar('\n'); break;
+            case 'r': result += QChar('\r'); break;
+            case 't': result += QChar('\t'); break;
+            case 'u':
+                if (end - p > 4) {
+                    bool ok;
+                    const ushort codeUnit = QByteArray::fromRawData(p + 1, 4).toUShort(&ok, 16);
+                    if (ok) {
+                        // surrogate pairs arrive as two consecutive escapes and combine in UTF-16
+                        result += QChar(codeUnit);
+                    }
+                    p += 4;
+                }
+                break;
+            default: result += QChar::fromLatin1(*p); // '"', '\\', '/'
+        }
+        runStart = p + 1;
+    }
+    result += QString::fromUtf8(runStart, static_cast<int>(end - runStart));
+    return result;
+}
+
+QString JsonPullReader::readString() {
+    if (peek() != String) {
+        skipValue();
+        return QString();
+    }
+    const char* begin;
+    int length;
+    bool hasEscapes;
+    if (!scanString(&begin, &length, &hasEscapes)) {
+        return QString();
+    }
+    return hasEscapes? unescape(begin, length): QString::fromUtf8(begin, length);
+}
+
+double JsonPullReader::readDouble() {
+    if (peek() != Number) {
+        skipValue();
+        return 0.;
+    }
+    const char* begin;
+    int length;
+    bool isInteger;
+    if (!scanNumber(&begin, &length, &isInteger)) {
+        return 0.;
+    }
+    if (isInteger && length < 16) {
+        // fast path for the common case, exact in double precision
+        const bool negative = *begin == '-';
+        qint64 value = 0;
+        for (const char* p = negative? begin + 1: begin; p < begin + length; p++) {
+            value = value * 10 + (*p - '0');
+        }
+        return negative? -value: value;
+    }
+    bool ok;
+    const double value = QByteArray::fromRawData(begin, length).toDouble(&ok);
+    if (!ok) {
+        setError("invalid number");
+        return 0.;
+    }
+    return value;
+}
+
+int JsonPullReader::readInt() {
+    // same semantics as QJsonValue::toInt()
+    const double value = readDouble();
+    if (value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max()
+        && static_cast<int>(value) == value) {
+        return static_cast<int>(value);
+    }
+    return 0;
+}
+
+bool JsonPullReader::readBool() {
+    if (peek() != Bool) {
+        skipValue();
+        return false;
+    }
+    if (_data[_pos] == 't') {
+        return scanLiteral("true");
+    }
+    scanLiteral("false");
+    return false;
+}
+
+void JsonPullReader::skipValue() {
+    switch (peek()) {
+        case BeginObject: {
+            _pos++;
+            QLatin1String key;
+            while (nextKey(key)) {
+                skipValue();
+            }
+            break;
+        }
+        case BeginArray:
+            _pos++;
+            while (nextElement()) {
+                skipValue();
+            }
+            break;
+        case String: {
+            const char* begin;
+            int length;
+            bool hasEscapes;
+            scanString(&begin, &length, &hasEscapes);
+            break;
+        }
+        case Number: {
+            const char* begin;
+            int length;
+            bool isInteger;
+            scanNumber(&begin, &length, &isInteger);
+            break;
+        }
+        case Bool:
+            readBool();
+            break;
+        case Null:
+            scanLiteral("null");
+            break;
+        case EndObject:
+        case EndArray:
+        case Invalid:
+            setError("unexpected token");
+            break;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef JSONPULLREADER_H_
+#define JSONPULLREADER_H_
+
+#include <QtCore>
+
+/**
+ * Minimal pull tokenizer over raw JSON bytes.
+ *
+ * Values are read in document order without materializing a DOM.
+ * The read* methods mirror the QJsonValue::to* conversions: on a type
+ * mismatch the value is skipped and a default is returned.
+ * Any syntax error puts the reader into an error state in which all
+ * methods return immediately.
+ */
+class JsonPullReader {
+    public:
+        enum TokenType { Invalid, BeginObject, EndObject, BeginArray, EndArray, String, Number, Bool, Null };
+
+        JsonPullReader(const QByteArray& bytes);
+
+        TokenType peek();
+
+        // enter the next value if it is an object/array, skip it otherwise
+        bool beginObject();
+        bool beginArray();
+        // advance inside the current object/array, false (and leave it) when at its end
+        bool nextKey(QLatin1String& key);
+        bool nextElement();
+
+        QString readString();
+        double readDouble();
+        int readInt();
+        bool readBool();
+        void skipValue();
+
+        bool hasError() const;
+        QString errorString() const;
+    private:
+        void skipWhitespace();
+        bool expect(char c);
+        bool scanString(const char** begin, int* length, bool* hasEscapes);
+        bool scanNumber(const char** begin, int* length, bool* isInteger);
+        bool scanLiteral(const char* literal);
+        QString unescape(const char* begin, int length) const;
+        void setError(const QString& message);
+
+        const char* _data;
+        int _size, _pos;
+        QByteArray _keyBuffer;
+        QString _error;
+};
+
+#endif /*JSONPULLREADER_H_*/
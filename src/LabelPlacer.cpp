@@ -0,0 +1,108 @@
+#include "LabelPlacer.h"
+
+LabelPlacer::LabelPlacer(int cellSize)
+    : _cellSize(cellSize) {}
+
+void LabelPlacer::clear() {
+    _rects.clear();
+    _cells.clear();
+}
+
+int LabelPlacer::size() const {
+    return _rects.size();
+}
+
+QRect LabelPlacer::cellRange(const QRectF& rect) const {
+    return QRect(
+        QPoint(qFloor(rect.left() / _cellSize), qFloor(rect.top() / _cellSize)),
+        QPoint(qFloor(rect.right() / _cellSize), qFloor(rect.bottom() / _cellSize))
+    );
+}
+
+quint64 LabelPlacer::cellKey(int x, int y) {
+    return (quint64) (quint32) x << 32 | (quint32) y;
+}
+
+bool LabelPlacer::isFree(const QRectF& rect) const {
+    const QRect range = cellRange(rect);
+    for (int x = range.left(); x <= range.right(); x++) {
+        for (int y = range.top(); y <= range.bottom(); y++) {
+            const auto cell = _cells.constFind(cellKey(x, y));
+            if (cell == _cells.constEnd()) {
+                continue;
+            }
+            foreach (const Entry &e, cell.value()) {
+                if (rect.intersects(e.rect)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void LabelPlacer::place(MapObject* object, const QRectF& rect) {
+    remove(object);
+    _rects.insert(object, rect);
+    const QRect range = cellRange(rect);
+    for (int x = range.left(); x <= range.right(); x++) {
+        for (int y = range.top(); y <= range.bottom(); y++) {
+            _cells[cellKey(x, y)].append({ object, rect });
+        }
+    }
+}
+
+bool LabelPlacer::take(MapObject* object, QRectF* rect) {
+    const auto it = _rects.find(object);
+    if (it == _rects.end()) {
+        return false;
+    }
+    if (rect != 0) {
+        *rect = it.value();
+    }
+    removeFromCells(object, it.value());
+    _rects.erase(it);
+    return true;
+}
+
+void LabelPlacer::remove(MapObject* object) {
+    take(object);
+}
+
+void LabelPlacer::retain(const QSet<MapObject*>& objects) {
+    for (auto it = _rects.begin(); it != _rects.end();) {
+        if (objects.contains(it.key())) {
+            ++it;
+        } else {
+            removeFromCells(it.key(), it.value());
+            it = _rects.erase(it);
+        }
+    }
+}
+
+const QHash<MapObject*, QRectF>& LabelPlacer::placements() const {
+    return _rects;
+}
+
+void LabelPlacer::removeFromCells(MapObject* object, const QRectF& rect) {
+    const QRect range = cellRange(rect);
+    for (int x = range.left(); x <= range.right(); x++) {
+        for (int y = range.top(); y <= range.bottom(); y++) {
+            auto cell = _cells.find(cellKey(x, y));
+            if (cell == _cells.end()) {
+                continue;
+            }
+            QVector<Entry> &entries = cell.value();
+            for (int i = 0; i < entries.size(); i++) {
+                if (entries[i].object == object) {
+                    entries[i] = entries.last();
+                    entries.removeLast();
+                    break;
+                }
+            }
+            if (entries.isEmpty()) {
+                _cells.erase(cell);
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef LABELPLACER_H_
+#define LABELPLACER_H_
+
+#include "MapObject.h"
+
+#include <QtCore>
+
+/**
+ * Screen-space bookkeeping of the map labels drawn so far.
+ * Placed rectangles are bucketed in a grid of square cells, so testing a
+ * candidate rectangle only looks at labels in the cells it touches.
+ * Every object has at most one rectangle, which is kept between frames to
+ * keep label positions sticky.
+ */
+class LabelPlacer {
+    public:
+        LabelPlacer(int cellSize = 64);
+
+        void clear();
+        int size() const;
+
+        // true if rect does not intersect any placed label
+        bool isFree(const QRectF& rect) const;
+        // replaces an earlier placement of the object
+        void place(MapObject* object, const QRectF& rect);
+        // removes the object's placement. Returns false if it had none.
+        bool take(MapObject* object, QRectF* rect = 0);
+        void remove(MapObject* object);
+        // removes all placements of objects not in objects
+        void retain(const QSet<MapObject*>& objects);
+
+        const QHash<MapObject*, QRectF>& placements() const;
+    private:
+        struct Entry {
+            MapObject* object;
+            QRectF rect;
+        };
+        // cells touched by rect
+        QRect cellRange(const QRectF& rect) const;
+        // x in the high, y in the low 32 bits
+        static quint64 cellKey(int x, int y);
+        void removeFromCells(MapObject* object, const QRectF& rect);
+
+        int _cellSize;
+        QHash<MapObject*, QRectF> _rects;
+        QHash<quint64, QVector<Entry> > _cells; // by cellKey()
+};
+
+#endif /*LABELPLACER_H_*/
@@ -324,8 +324,10 @@ void Launcher::loadNavdata() {
     qDebug() << "Launcher:loadNavdata()";
     GuiMessages::status("Loading Navdata", "loadnavdata");
 
+    QElapsedTimer timer;
+    timer.start();
     NavData::instance()->load();
     Airac::instance()->load();
     GuiMessages::remove("loadnavdata");
-    qDebug() << "Launcher:loadNavdata() finished";
+    qDebug() << "Launcher:loadNavdata() finished in" << timer.elapsed() << "ms";
 }
@@ -63,6 +63,17 @@ NavAid::NavAid(const QStringList&stringList) {
     _name = _name.trimmed();
 }
 
+NavAid::NavAid(QDataStream& in) {
+    qint32 type, freq;
+    in >> id >> regionCode >> lat >> lon >> type >> freq >> _hdg >> _name;
+    _type = (Type) type;
+    _freq = freq;
+}
+
+void NavAid::writeTo(QDataStream& out) const {
+    out << id << regionCode << lat << lon << (qint32) _type << (qint32) _freq << _hdg << _name;
+}
+
 QString NavAid::typeStr(Type type) {
     return typeStrings.value(type, QString());
 }
@@ -26,6 +26,9 @@ class NavAid
         static const QHash<Type, QString> typeStrings;
 
         NavAid(const QStringList& stringList);
+        NavAid(QDataStream& in); // see writeTo()
+
+        void writeTo(QDataStream& out) const;
 
         virtual QString toolTip() const override;
         virtual QString mapLabelHovered() const override;
@@ -38,7 +41,7 @@ class NavAid
     private:
         Type _type;
         int _freq;
-        float _hdg;
+        float _hdg = 0.;
         QString _name;
 };
 
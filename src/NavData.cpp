@@ -2,11 +2,19 @@
 
 #include "Airport.h"
 #include "FileReader.h"
+#include "GreatCircleCache.h"
 #include "helpers.h"
+#include "NavDataCache.h"
+#include "RouteTokenizer.h"
 #include "SectorReader.h"
 #include "Settings.h"
+#include "src/mustache/Renderer.h"
 
+#include <QCryptographicHash>
 #include <QRegExp>
+#include <QtEndian>
+
+#include <algorithm>
 
 NavData* navDataInstance = 0;
 NavData* NavData::instance(bool createIfNoInstance) {
@@ -28,21 +36,133 @@ NavData::~NavData() {
 }
 
 void NavData::load() {
-    loadCountryCodes(Settings::dataDirectory("data/countrycodes.dat"));
-    loadAirports(Settings::dataDirectory("data/airports.dat"));
-    loadControllerAirportsMapping(Settings::dataDirectory("data/controllerAirportsMapping.dat"));
-    loadSectors();
-    loadAirlineCodes(Settings::dataDirectory("data/airlines.dat"));
+    QElapsedTimer timer;
+    timer.start();
+    {
+        // waits for Whazzup processing that reads airports, sectors and airlines
+        QWriteLocker locker(&m_reloadLock);
+        loadCountryCodes(Settings::dataDirectory("data/countrycodes.dat"));
+        loadAirports(Settings::dataDirectory("data/airports.dat"));
+        loadControllerAirportsMapping(Settings::dataDirectory("data/controllerAirportsMapping.dat"));
+        loadSectors();
+        loadAirlineCodes(Settings::dataDirectory("data/airlines.dat"));
+        m_generation++;
+    }
+    qDebug() << "NavData loaded in" << timer.elapsed() << "ms";
     emit loaded();
 }
 
+QReadWriteLock* NavData::reloadLock() {
+    return &m_reloadLock;
+}
+
+int NavData::generation() const {
+    return m_generation;
+}
+
 void NavData::loadAirports(const QString& filename) {
     airports.clear();
+    airportsIndex.clear();
+    airportTiles.clear();
     activeAirports.clear();
-    FileReader fr(filename);
+    atcAirports.clear();
 
     auto countMissingCountry = 0;
 
+    // airports are checked against the country codes when parsed
+    NavDataCache cache("airports", { filename, Settings::dataDirectory("data/countrycodes.dat") });
+    const bool fromCache = cache.read(
+        [this, &countMissingCountry](QDataStream& in) {
+            qint32 size;
+            in >> size;
+            for (qint32 i = 0; i < size && in.status() == QDataStream::Ok; i++) {
+                Airport* airport = new Airport(in);
+                if (airport->countryCode.isEmpty()) {
+                    ++countMissingCountry;
+                }
+                airports.insert(airport->id, airport);
+                airportsIndex.insert(airport->lat, airport->lon, airport);
+            }
+            return true;
+        }
+    );
+    if (!fromCache) {
+        // drop what a failed cache read might have left
+        qDeleteAll(airports);
+        airports.clear();
+        airportsIndex.clear();
+        countMissingCountry = 0;
+        readAirports(filename, countMissingCountry);
+        cache.write(
+            [this](QDataStream& out) {
+                out << (qint32) airports.size();
+                foreach (const Airport* a, airports) {
+                    a->writeTo(out);
+                }
+            }
+        );
+    }
+
+    if (countMissingCountry != 0) {
+        qWarning() << countMissingCountry << "airports are missing a country code. Please help by adding them in data/airports.dat.";
+    }
+
+    // a random, but stable distribution of the labels when there is no room for all of them
+    foreach (Airport* a, airports) {
+        a->labelPriority = qFromBigEndian<quint64>(
+            QCryptographicHash::hash(a->id.toLatin1(), QCryptographicHash::Md5).constData()
+        );
+        airportTiles[QPair<int, int>(a->lat, a->lon)].append(a);
+    }
+    for (auto it = airportTiles.begin(); it != airportTiles.end(); ++it) {
+        std::sort(
+            it.value().begin(),
+            it.value().end(),
+            [](const Airport* a, const Airport* b) {
+                return a->labelPriority > b->labelPriority;
+            }
+        );
+    }
+}
+
+QList<Airport*> NavData::airportsInTiles(const QList<QPair<int, int> >& tiles) const {
+    // k-way merge of the presorted tiles
+    struct Cursor {
+        const QList<Airport*>* tile;
+        int i;
+    };
+    auto isLower = [](const Cursor& a, const Cursor& b) {
+        return a.tile->at(a.i)->labelPriority < b.tile->at(b.i)->labelPriority;
+    };
+    std::vector<Cursor> heap;
+    int size = 0;
+    foreach (const auto &key, tiles) {
+        const auto it = airportTiles.constFind(key);
+        if (it != airportTiles.constEnd() && !it.value().isEmpty()) {
+            heap.push_back({ &it.value(), 0 });
+            size += it.value().size();
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), isLower);
+
+    QList<Airport*> result;
+    result.reserve(size);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), isLower);
+        Cursor &top = heap.back();
+        result.append(top.tile->at(top.i));
+        if (++top.i < top.tile->size()) {
+            std::push_heap(heap.begin(), heap.end(), isLower);
+        } else {
+            heap.pop_back();
+        }
+    }
+    return result;
+}
+
+void NavData::readAirports(const QString& filename, int& countMissingCountry) {
+    FileReader fr(filename);
+
     auto count = 0;
     while (!fr.atEnd()) {
         ++count;
@@ -63,10 +183,7 @@ void NavData::loadAirports(const QString& filename) {
         }
 
         airports.insert(airport->id, airport);
-    }
-
-    if (countMissingCountry != 0) {
-        qWarning() << countMissingCountry << "airports are missing a country code. Please help by adding them in data/airports.dat.";
+        airportsIndex.insert(airport->lat, airport->lon, airport);
     }
 }
 
@@ -187,12 +304,7 @@ QPair<double, double> NavData::pointDistanceBearing(double lat, double lon, doub
 }
 
 Airport* NavData::airportAt(double lat, double lon, double maxDist) const {
-    foreach (Airport* a, airports.values()) {
-        if (distance(a->lat, a->lon, lat, lon) <= maxDist) {
-            return a;
-        }
-    }
-    return 0;
+    return airportsIndex.nearest(lat, lon, maxDist);
 }
 
 QSet<Airport*> NavData::additionalMatchedAirportsForController(QString prefix, QString suffix) const {
@@ -211,66 +323,125 @@ QSet<Airport*> NavData::additionalMatchedAirportsForController(QString prefix, Q
     return ret;
 }
 
-void NavData::updateData(const WhazzupData& whazzupData) {
+AirportActivity::Filter AirportActivity::Filter::fromSettings() {
+    Filter filter;
+    filter.traffic = Settings::filterTraffic();
+    filter.distance = Settings::filterDistance();
+    filter.arriving = Settings::filterArriving();
+    return filter;
+}
+
+bool AirportActivity::Filter::operator==(const Filter& other) const {
+    return traffic == other.traffic && distance == other.distance && arriving == other.arriving;
+}
+
+// read-only on NavData and the snapshot, safe to run on a worker thread
+// while holding reloadLock() for reading
+AirportActivity NavData::airportActivity(const WhazzupData& whazzupData, const AirportActivity::Filter& filter) const {
+    AirportActivity activity;
+    activity.whazzupTime = whazzupData.whazzupTime;
+    activity.filter = filter;
+    activity.navDataGeneration = m_generation;
+
+    const bool filterTraffic = filter.traffic;
+    const double filterDistance = filter.distance;
+    const double filterArriving = filter.arriving;
+
+    auto pilotActivity = [&](const Pilot* p) {
+        AirportActivity::PilotActivity pa;
+        pa.dep = p->depAirport();
+        if (pa.dep != 0) {
+            pa.countDeparture = !filterTraffic
+                || (p->distanceFromDeparture() < filterDistance);
+        } else if (p->flightStatus() == Pilot::BUSH) { // no flightplan yet?
+            pa.dep = airportAt(p->lat, p->lon, 3.);
+            pa.countDeparture = pa.dep != 0;
+        }
+        pa.dest = p->destAirport();
+        if (pa.dest != 0) {
+            pa.countArrival = (
+                !filterTraffic
+                || (
+                    (p->distanceToDestination() < filterDistance)
+                    || (p->eet().hour() + p->eet().minute() / 60. < filterArriving)
+                )
+            )
+                && (p->flightStatus() != Pilot::FlightStatus::BLOCKED && p->flightStatus() != Pilot::FlightStatus::GROUND_ARR);
+        }
+        return pa;
+    };
+
+    foreach (const Pilot* p, whazzupData.pilots) {
+        activity.pilots.insert(p->callsign, pilotActivity(p));
+    }
+    foreach (const Pilot* p, whazzupData.bookedPilots) {
+        activity.bookedPilots.insert(p->callsign, pilotActivity(p));
+    }
+    foreach (const Controller* c, whazzupData.controllers) {
+        activity.controllers.insert(c->callsign, c->airports());
+    }
+
+    return activity;
+}
+
+void NavData::updateData(const WhazzupData& whazzupData, const AirportActivity* precomputed) {
     qDebug() << "on" << airports.size() << "airports";
+    AirportActivity activity;
+    const AirportActivity::Filter filter = AirportActivity::Filter::fromSettings();
+    if (
+        precomputed == 0
+        || precomputed->whazzupTime != whazzupData.whazzupTime
+        || precomputed->navDataGeneration != m_generation
+        || !(precomputed->filter == filter)
+    ) {
+        activity = airportActivity(whazzupData, filter);
+        precomputed = &activity;
+    }
+
     foreach (Airport* a, activeAirports.values()) {
         a->resetWhazzupStatus();
+        MustacheQs::Renderer::invalidate(a);
     }
 
     QSet<Airport*> newActiveAirportsSet;
-    QList<Pilot*> allpilots = whazzupData.allPilots();
-    for (int i = 0; i < allpilots.size(); i++) {
-        Pilot* p = allpilots[i];
-        if (p == 0) {
-            continue;
-        }
-        Airport* dep = p->depAirport();
-        if (dep != 0) {
-            dep->addDeparture(p);
-            newActiveAirportsSet.insert(dep);
-            if (
-                !Settings::filterTraffic()
-                || (p->distanceFromDeparture() < Settings::filterDistance())
-            ) {
-                dep->nMaybeFilteredDepartures++;
-            }
-        } else if (p->flightStatus() == Pilot::BUSH) { // no flightplan yet?
-            Airport* a = airportAt(p->lat, p->lon, 3.);
-            if (a != 0) {
-                a->addDeparture(p);
-                a->nMaybeFilteredDepartures++;
-                newActiveAirportsSet.insert(a);
+    auto applyPilot = [&](Pilot* p, const AirportActivity::PilotActivity& pa) {
+        if (pa.dep != 0) {
+            pa.dep->addDeparture(p);
+            newActiveAirportsSet.insert(pa.dep);
+            if (pa.countDeparture) {
+                pa.dep->nMaybeFilteredDepartures++;
             }
         }
-        Airport* dest = p->destAirport();
-        if (dest != 0) {
-            dest->addArrival(p);
-            newActiveAirportsSet.insert(dest);
-            if (
-                (
-                    !Settings::filterTraffic()
-                    || (
-                        (p->distanceToDestination() < Settings::filterDistance())
-                        || (p->eet().hour() + p->eet().minute() / 60. < Settings::filterArriving())
-                    )
-                )
-                && (p->flightStatus() != Pilot::FlightStatus::BLOCKED && p->flightStatus() != Pilot::FlightStatus::GROUND_ARR)
-            ) {
-                dest->nMaybeFilteredArrivals++;
+        if (pa.dest != 0) {
+            pa.dest->addArrival(p);
+            newActiveAirportsSet.insert(pa.dest);
+            if (pa.countArrival) {
+                pa.dest->nMaybeFilteredArrivals++;
             }
         }
+    };
+    foreach (Pilot* p, whazzupData.bookedPilots) {
+        applyPilot(p, precomputed->bookedPilots.value(p->callsign));
+    }
+    foreach (Pilot* p, whazzupData.pilots) {
+        applyPilot(p, precomputed->pilots.value(p->callsign));
     }
 
+    atcAirports.clear();
     foreach (Controller* c, whazzupData.controllers) {
-        foreach (const auto _airport, c->airports()) {
+        foreach (const auto _airport, precomputed->controllers.value(c->callsign)) {
             _airport->addController(c);
             newActiveAirportsSet.insert(_airport);
+            if (c->isAppDep() || c->isTwr() || c->isGnd() || c->isDel()) {
+                atcAirports.insert(_airport);
+            }
         }
     }
 
     activeAirports.clear();
     foreach (Airport* a, newActiveAirportsSet) {
         activeAirports.insert(a->congestion(), a);
+        MustacheQs::Renderer::invalidate(a);
     }
 
     qDebug() << "-- finished";
@@ -350,8 +521,9 @@ QList<QPair<double, double> > NavData::greatCirclePoints(
 /**
  * plot great-circles of lat/lon points on Earth.
  * Adds texture coordinates along the way.
+ * @param caching GreatCircleCaching flags: segments to take from the GreatCircleCache
  **/
-void NavData::plotGreatCirclePoints(const QList<QPair<double, double> > &points, bool isReverseTextCoords) {
+void NavData::plotGreatCirclePoints(const QList<QPair<double, double> > &points, bool isReverseTextCoords, int caching) {
     if (points.isEmpty()) {
         return;
     }
@@ -359,15 +531,25 @@ void NavData::plotGreatCirclePoints(const QList<QPair<double, double> > &points,
     if (points.size() > 1) {
         DoublePair wpOld = points[0];
         for (int i = 1; i < points.size(); i++) {
-            auto subPoints = greatCirclePoints(
-                wpOld.first, wpOld.second,
-                points[i].first, points[i].second,
-                400.
-            );
-            for (int h = 0; h < subPoints.count(); h++) {
-                GLfloat ratio = (GLfloat) (i - 1) / (points.size() - 1) + ((GLfloat) h / subPoints.count()) / (points.size() - 1);
+            // a single segment is first and last segment
+            int segmentFlags = 0;
+            if (i == 1) {
+                segmentFlags |= CacheFirstSegment;
+            }
+            if (i == points.size() - 1) {
+                segmentFlags |= CacheLastSegment;
+            }
+            if (segmentFlags == 0) {
+                segmentFlags = CacheInnerSegments;
+            }
+            const QVector<GLfloat> vertices = (caching & segmentFlags) == segmentFlags
+                ? GreatCircleCache::instance()->segment(wpOld.first, wpOld.second, points[i].first, points[i].second, 400.)
+                : GreatCircleCache::tessellate(wpOld.first, wpOld.second, points[i].first, points[i].second, 400.);
+            const int count = vertices.size() / 3;
+            for (int h = 0; h < count; h++) {
+                GLfloat ratio = (GLfloat) (i - 1) / (points.size() - 1) + ((GLfloat) h / count) / (points.size() - 1);
                 glTexCoord1f(isReverseTextCoords? 1. - ratio: ratio);
-                VERTEX(subPoints[h].first, subPoints[h].second);
+                glVertex3fv(vertices.constData() + h * 3);
             }
             wpOld = points[i];
         }
@@ -380,9 +562,9 @@ void NavData::plotGreatCirclePoints(const QList<QPair<double, double> > &points,
  * @return 0 on error
  */
 QPair<double, double>* NavData::fromArinc(const QString &str) {
-    QRegExp arinc("(\\d{2})([NSEW]?)(\\d{2})([NSEW]?)"); // ARINC424 waypoints (strict)
-    if (arinc.exactMatch(str)) {
-        auto capturedTexts = arinc.capturedTexts();
+    const auto arinc = RouteTokenizer::arincRegExp.match(str); // ARINC424 waypoints (strict)
+    if (arinc.hasMatch()) {
+        const auto capturedTexts = arinc.capturedTexts();
         if (
             !capturedTexts[2].isEmpty()
             && !capturedTexts[4].isEmpty()
@@ -397,8 +579,8 @@ QPair<double, double>* NavData::fromArinc(const QString &str) {
             double wLat = capturedTexts[1].toDouble();
             double wLon = capturedTexts[3].toDouble();
             if (
-                QRegExp("[SW]").exactMatch(capturedTexts[2])
-                || QRegExp("[SW]").exactMatch(capturedTexts[4])
+                capturedTexts[2] == "S" || capturedTexts[2] == "W"
+                || capturedTexts[4] == "S" || capturedTexts[4] == "W"
             ) {
                 wLat = -wLat;
             }
@@ -406,8 +588,8 @@ QPair<double, double>* NavData::fromArinc(const QString &str) {
                 wLon = wLon + 100.;
             }
             if (
-                QRegExp("[NW]").exactMatch(capturedTexts[2])
-                || QRegExp("[NW]").exactMatch(capturedTexts[4])
+                capturedTexts[2] == "N" || capturedTexts[2] == "W"
+                || capturedTexts[4] == "N" || capturedTexts[4] == "W"
             ) {
                 wLon = -wLon;
             }
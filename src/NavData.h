@@ -2,6 +2,7 @@
 #define NAVDATA_H_
 
 #include "Airline.h"
+#include "GeoIndex.h"
 #include "SearchVisitor.h"
 #include "Sector.h"
 
@@ -11,6 +12,41 @@ struct ControllerAirportsMapping {
     QSet<Airport*> airports;
 };
 
+// airport assignments of a WhazzupData snapshot, keyed by callsign so that it
+// can be computed off the GUI thread and applied to the live snapshot
+struct AirportActivity {
+    // traffic filter settings, read on the GUI thread
+    struct Filter {
+        bool traffic = false;
+        double distance = 0., arriving = 0.;
+
+        static Filter fromSettings();
+        bool operator==(const Filter& other) const;
+    };
+    struct PilotActivity {
+        Airport* dep = 0;
+        Airport* dest = 0;
+        bool countDeparture = false, countArrival = false;
+    };
+
+    QDateTime whazzupTime;
+    Filter filter;
+    int navDataGeneration = -1; // airport pointers are only valid for this NavData::generation()
+    QHash<QString, PilotActivity> pilots, bookedPilots;
+    QHash<QString, QSet<Airport*> > controllers;
+};
+
+// which segments of NavData::plotGreatCirclePoints() get tessellated through
+// the GreatCircleCache. Points that move between updates (plane positions)
+// should not be cached.
+enum GreatCircleCaching {
+    CacheNone = 0,
+    CacheFirstSegment = 1,
+    CacheInnerSegments = 2,
+    CacheLastSegment = 4,
+    CacheAllSegments = CacheFirstSegment | CacheInnerSegments | CacheLastSegment
+};
+
 enum LatLngPrecission {
     Secs = 3, Mins = 2, Degrees = 1
 };
@@ -46,23 +82,39 @@ class NavData
             double lon2,
             double intervalNm = 30.
         );
-        static void plotGreatCirclePoints(const QList<QPair<double, double> > &points, bool isReverseTextCoords = false);
+        static void plotGreatCirclePoints(
+            const QList<QPair<double, double> > &points,
+            bool isReverseTextCoords = false,
+            int caching = CacheNone // GreatCircleCaching flags
+        );
 
         virtual ~NavData();
 
         QHash<QString, Airport*> airports;
+        GeoIndex<Airport*> airportsIndex;
+        // 1x1 degree tiles (lat and lon truncated) sorted by descending Airport::labelPriority
+        QHash<QPair<int, int>, QList<Airport*> > airportTiles;
         QMultiMap<int, Airport*> activeAirports; // holds activeAirports sorted by congestion ascending
+        QSet<Airport*> atcAirports; // airports with APP, TWR, GND or DEL controllers
         QMultiMap<QString, Sector*> sectors;
         QHash<QString, QString> countryCodes;
         QString airline(const QString &airlineCode);
         QHash<QString, Airline*> airlines;
 
-        Airport* airportAt(double lat, double lon, double maxDist) const;
+        Airport* airportAt(double lat, double lon, double maxDist) const; // nearest within maxDist
 
         QSet<Airport*> additionalMatchedAirportsForController(QString prefix, QString suffix) const;
 
-        void updateData(const WhazzupData& whazzupData);
+        AirportActivity airportActivity(const WhazzupData& whazzupData, const AirportActivity::Filter& filter) const;
+        void updateData(const WhazzupData& whazzupData, const AirportActivity* precomputed = 0);
         void accept(SearchVisitor* visitor);
+        // airports of the tiles by descending Airport::labelPriority
+        QList<Airport*> airportsInTiles(const QList<QPair<int, int> >& tiles) const;
+
+        // held for reading by Whazzup processing off the GUI thread, for writing by load()
+        QReadWriteLock* reloadLock();
+        // incremented by every load()
+        int generation() const;
     public slots:
         void load();
     signals:
@@ -70,8 +122,11 @@ class NavData
     private:
         NavData();
         void loadAirports(const QString& filename);
+        void readAirports(const QString& filename, int& countMissingCountry);
         void loadControllerAirportsMapping(const QString& filename);
         QList<ControllerAirportsMapping> m_controllerAirportsMapping;
+        QReadWriteLock m_reloadLock;
+        int m_generation = 0;
         void loadSectors();
         void loadCountryCodes(const QString& filename);
         void loadAirlineCodes(const QString& filename);
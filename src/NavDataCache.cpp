@@ -0,0 +1,101 @@
+#include "NavDataCache.h"
+
+#include "Settings.h"
+
+bool NavDataCache::enabled = true;
+
+NavDataCache::NavDataCache(const QString& name, const QStringList& sourceFiles)
+    : _name(name), _sourceFiles(sourceFiles) {}
+
+QString NavDataCache::fileName() const {
+    return Settings::dataDirectory(QString("cache/%1.bin").arg(_name));
+}
+
+void NavDataCache::removeAll() {
+    QDir dir(Settings::dataDirectory("cache/"));
+    foreach (const QString &fileName, dir.entryList({ "*.bin" }, QDir::Files)) {
+        dir.remove(fileName);
+    }
+}
+
+// size, mtime and a hash of the first block of each source file. The block
+// holds the header line of the X-Plane files, which carries the AIRAC cycle.
+QByteArray NavDataCache::sourceFingerprint() const {
+    QByteArray result;
+    QDataStream out(&result, QIODevice::WriteOnly);
+    out.setVersion(streamVersion);
+    foreach (const QString &sourceFile, _sourceFiles) {
+        QFileInfo info(sourceFile);
+        QFile file(sourceFile);
+        if (!info.exists() || !file.open(QIODevice::ReadOnly)) {
+            return QByteArray();
+        }
+        out << info.absoluteFilePath() << info.size() << info.lastModified().toMSecsSinceEpoch()
+            << QCryptographicHash::hash(file.read(4096), QCryptographicHash::Sha1);
+    }
+    return result;
+}
+
+bool NavDataCache::read(const std::function<bool(QDataStream&)>& reader) const {
+    if (!enabled) {
+        return false;
+    }
+    QFile file(fileName());
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+        return false;
+    }
+    uchar* mapped = file.map(0, file.size());
+    if (mapped == 0) {
+        qWarning() << "NavDataCache: could not map" << file.fileName() << file.errorString();
+        return false;
+    }
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size());
+    QDataStream in(bytes);
+    in.setVersion(streamVersion);
+
+    quint32 fileMagic, fileFormatVersion;
+    QByteArray fingerprint;
+    in >> fileMagic >> fileFormatVersion >> fingerprint;
+    bool ok = in.status() == QDataStream::Ok
+        && fileMagic == magic
+        && fileFormatVersion == formatVersion
+        && fingerprint == sourceFingerprint()
+        && !fingerprint.isEmpty();
+    if (ok) {
+        ok = reader(in) && in.status() == QDataStream::Ok;
+        if (!ok) {
+            qWarning() << "NavDataCache: could not read" << file.fileName();
+        }
+    } else {
+        qDebug() << "NavDataCache:" << file.fileName() << "is outdated";
+    }
+
+    file.unmap(mapped);
+    return ok;
+}
+
+bool NavDataCache::write(const std::function<void(QDataStream&)>& writer) const {
+    if (!enabled) {
+        return false;
+    }
+    const QByteArray fingerprint = sourceFingerprint();
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+    QDir().mkpath(Settings::dataDirectory("cache/"));
+    QSaveFile file(fileName());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "NavDataCache: could not write" << file.fileName() << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(streamVersion);
+    out << magic << formatVersion << fingerprint;
+    writer(out);
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "NavDataCache: could not write" << file.fileName() << file.errorString();
+        return false;
+    }
+    qDebug() << "NavDataCache: wrote" << file.fileName();
+    return true;
+}
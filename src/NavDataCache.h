@@ -0,0 +1,38 @@
+#ifndef NAVDATACACHE_H_
+#define NAVDATACACHE_H_
+
+#include <QtCore>
+
+#include <functional>
+
+/**
+ * Versioned binary cache of parsed navigation data in cache/.
+ * A cache file is only used while its source files still match the
+ * recorded size, modification time and header hash. It is memory-mapped
+ * for reading, so loading does not need any text parsing.
+ */
+class NavDataCache {
+    public:
+        NavDataCache(const QString& name, const QStringList& sourceFiles);
+
+        // false if there is no matching cache or the reader failed
+        bool read(const std::function<bool(QDataStream&)>& reader) const;
+        bool write(const std::function<void(QDataStream&)>& writer) const;
+
+        QString fileName() const;
+
+        static void removeAll();
+        static bool enabled;
+    private:
+        // bump this when the serialized layout of any cached class changes
+        static const quint32 formatVersion = 2;
+        static const quint32 magic = 0x51534e43; // "QSNC"
+        static const QDataStream::Version streamVersion = QDataStream::Qt_5_15;
+
+        QByteArray sourceFingerprint() const;
+
+        QString _name;
+        QStringList _sourceFiles;
+};
+
+#endif /*NAVDATACACHE_H_*/
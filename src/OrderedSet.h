@@ -0,0 +1,45 @@
+#ifndef ORDEREDSET_H_
+#define ORDEREDSET_H_
+
+#include <QtCore>
+
+/**
+ * Set that keeps the insertion order, with hashed lookups.
+ * T needs a qHash() overload.
+ */
+template <typename T>
+class OrderedSet {
+    public:
+        // returns false if value was already there
+        bool insert(const T& value) {
+            if (_index.contains(value)) {
+                return false;
+            }
+            _index.insert(value);
+            _values.append(value);
+            return true;
+        }
+
+        bool contains(const T& value) const {
+            return _index.contains(value);
+        }
+
+        void clear() {
+            _index.clear();
+            _values.clear();
+        }
+
+        int size() const {
+            return _values.size();
+        }
+
+        // in insertion order
+        const QList<T>& values() const {
+            return _values;
+        }
+    private:
+        QSet<T> _index;
+        QList<T> _values;
+};
+
+#endif /*ORDEREDSET_H_*/
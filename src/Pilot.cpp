@@ -1,10 +1,11 @@
 #include "Pilot.h"
 
-#include "Airac.h"
 #include "Airport.h"
 #include "Client.h"
 #include "helpers.h"
 #include "NavData.h"
+#include "RouteCache.h"
+#include "RouteTokenizer.h"
 #include "Settings.h"
 #include "Whazzup.h"
 #include "dialogs/PilotDetails.h"
@@ -52,12 +53,6 @@ Pilot::Pilot(const QJsonObject& json, const WhazzupData* whazzup)
     planAlt = flightPlan["altitude"].toString();
     planDest = flightPlan["arrival"].toString();
 
-    QRegExp _airlineRegEx("([A-Z]{3})[0-9].*");
-    if (_airlineRegEx.exactMatch(callsign)) {
-        auto _capturedTexts = _airlineRegEx.capturedTexts();
-        airline = NavData::instance()->airlines.value(_capturedTexts[1], 0);
-    }
-
     transponder = json["transponder"].toString();
     transponderAssigned = flightPlan["assigned_transponder"].toString();
 
@@ -69,6 +64,113 @@ Pilot::Pilot(const QJsonObject& json, const WhazzupData* whazzup)
     QString timeEnroute = flightPlan["enroute_time"].toString();
     QString timeFuel = flightPlan["fuel_time"].toString();
 
+    planAltAirport = flightPlan["alternate"].toString();
+    planRemarks = flightPlan["remarks"].toString();
+    planRoute = flightPlan["route"].toString();
+
+    trueHeading = json["heading"].toInt();
+    qnh_inHg = json["qnh_i_hg"].toDouble();
+    qnh_mb = json["qnh_mb"].toInt();
+
+    initDerivedFields(timeEnroute, timeFuel);
+}
+
+Pilot::Pilot(JsonPullReader& reader, const WhazzupData* whazzup)
+    : MapObject(), Client(),
+      airline(0) {
+    whazzupTime = QDateTime(whazzup->whazzupTime); // need some local reference to that
+
+    // defaults as the QJsonObject path yields them for missing keys
+    planRevision = "0";
+    altitude = groundspeed = qnh_mb = 0;
+    pilotRating = militaryRating = 0;
+    trueHeading = qnh_inHg = 0.;
+
+    QString timeEnroute, timeFuel;
+    QLatin1String key;
+    if (reader.beginObject()) {
+        while (reader.nextKey(key)) {
+            if (Client::readField(key, reader)) {
+                continue;
+            }
+            if (key == QLatin1String("latitude")) {
+                lat = reader.readDouble();
+            } else if (key == QLatin1String("longitude")) {
+                lon = reader.readDouble();
+            } else if (key == QLatin1String("pilot_rating")) {
+                pilotRating = reader.readInt();
+            } else if (key == QLatin1String("military_rating")) {
+                militaryRating = reader.readInt();
+            } else if (key == QLatin1String("altitude")) {
+                altitude = reader.readInt();
+            } else if (key == QLatin1String("groundspeed")) {
+                groundspeed = reader.readInt();
+            } else if (key == QLatin1String("transponder")) {
+                transponder = reader.readString();
+            } else if (key == QLatin1String("heading")) {
+                trueHeading = reader.readInt();
+            } else if (key == QLatin1String("qnh_i_hg")) {
+                qnh_inHg = reader.readDouble();
+            } else if (key == QLatin1String("qnh_mb")) {
+                qnh_mb = reader.readInt();
+            } else if (key == QLatin1String("flight_plan")) {
+                if (reader.beginObject()) {
+                    while (reader.nextKey(key)) {
+                        if (key == QLatin1String("aircraft")) {
+                            planAircraftFull = reader.readString();
+                        } else if (key == QLatin1String("aircraft_short")) {
+                            planAircraftShort = reader.readString();
+                        } else if (key == QLatin1String("aircraft_faa")) {
+                            planAircraftFaa = reader.readString();
+                        } else if (key == QLatin1String("cruise_tas")) {
+                            planTAS = reader.readString();
+                        } else if (key == QLatin1String("departure")) {
+                            planDep = reader.readString();
+                        } else if (key == QLatin1String("altitude")) {
+                            planAlt = reader.readString();
+                        } else if (key == QLatin1String("arrival")) {
+                            planDest = reader.readString();
+                        } else if (key == QLatin1String("assigned_transponder")) {
+                            transponderAssigned = reader.readString();
+                        } else if (key == QLatin1String("revision_id")) {
+                            planRevision = QString::number(reader.readInt());
+                        } else if (key == QLatin1String("flight_rules")) {
+                            planFlighttype = reader.readString();
+                        } else if (key == QLatin1String("deptime")) {
+                            planDeptime = reader.readString();
+                            planActtime = planDeptime; // The new data doesn't provide the actual departure
+                        } else if (key == QLatin1String("enroute_time")) {
+                            timeEnroute = reader.readString();
+                        } else if (key == QLatin1String("fuel_time")) {
+                            timeFuel = reader.readString();
+                        } else if (key == QLatin1String("alternate")) {
+                            planAltAirport = reader.readString();
+                        } else if (key == QLatin1String("remarks")) {
+                            planRemarks = reader.readString();
+                        } else if (key == QLatin1String("route")) {
+                            planRoute = reader.readString();
+                        } else {
+                            reader.skipValue();
+                        }
+                    }
+                }
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+    Client::normalizeFields();
+
+    initDerivedFields(timeEnroute, timeFuel);
+}
+
+void Pilot::initDerivedFields(const QString& timeEnroute, const QString& timeFuel) {
+    QRegExp _airlineRegEx("([A-Z]{3})[0-9].*");
+    if (_airlineRegEx.exactMatch(callsign)) {
+        auto _capturedTexts = _airlineRegEx.capturedTexts();
+        airline = NavData::instance()->airlines.value(_capturedTexts[1], 0);
+    }
+
     QString tmpStr = timeEnroute.left(2);
     if (tmpStr.isNull()) {
         planEnroute_hrs = -1;
@@ -78,13 +180,6 @@ Pilot::Pilot(const QJsonObject& json, const WhazzupData* whazzup)
     planEnroute_mins = timeEnroute.rightRef(2).toInt();
     planFuel_hrs = timeFuel.leftRef(2).toInt();
     planFuel_mins = timeFuel.rightRef(2).toInt();
-    planAltAirport = flightPlan["alternate"].toString();
-    planRemarks = flightPlan["remarks"].toString();
-    planRoute = flightPlan["route"].toString();
-
-    trueHeading = json["heading"].toInt();
-    qnh_inHg = json["qnh_i_hg"].toDouble();
-    qnh_mb = json["qnh_mb"].toInt();
     // day of flight
     if (!QTime::fromString(planDeptime, "HHmm").isValid()) { // no Plan ETA given: maybe some more magic needed here
         dayOfFlight = whazzupTime.date();
@@ -484,16 +579,8 @@ QString Pilot::flOrEmpty() const {
 }
 
 QStringList Pilot::waypoints() const {
-    // @todo put this into a RouteResolver
-    auto parts = planRoute.toUpper().split(
-        QRegExp(
-            "[\\s\\-+.,/]|"
-            "\\b(?:[MNAFSMK]\\d{3,4}){2,}\\b|"
-            "\\b\\d{2}\\D?\\b|"
-            "DCT"
-        ),
-        Qt::SkipEmptyParts
-    ); // split and throw away DCT + /N450F230 etc.
+    // drops DCT, speed/level groups and runway designators
+    auto parts = RouteTokenizer::waypointTokens(planRoute);
 
     if (!parts.isEmpty()) {
         if (parts.constFirst() == planDep) {
@@ -521,17 +608,16 @@ int Pilot::nextPointOnRoute(const QList<Waypoint*> &waypoints) const { // next p
     }
     int nextPoint;
     // find the point that is nearest to the plane
-    double minDist = NavData::distance(
-        lat, lon, waypoints[0]->lat,
-        waypoints[0]->lon
-    );
-    int minPoint = 0; // next to departure as default
-    for (int i = 1; i < waypoints.size(); i++) {
-        if (NavData::distance(lat, lon, waypoints[i]->lat, waypoints[i]->lon) < minDist) {
-            minDist = NavData::distance(lat, lon, waypoints[i]->lat, waypoints[i]->lon);
-            minPoint = i;
+    GeoPoints points;
+    if (waypoints == routeWaypointsWithDepDestCache) {
+        points = routeGeoPointsCache;
+    } else {
+        points.reserve(waypoints.size());
+        foreach (const Waypoint* w, waypoints) {
+            points.append(w->lat, w->lon);
         }
     }
+    const int minPoint = points.nearest(lat, lon); // next to departure on ties
     // with the nearest point, look which one is the next point ahead - saves from trouble with zig-zag routes
     if (minPoint == 0) {
         nextPoint = 1;
@@ -586,20 +672,29 @@ QList<Waypoint*> Pilot::routeWaypoints() {
     routeWaypointsPlanDestCache = planDest;
     routeWaypointsPlanRouteCache = planRoute;
 
-    const double maxDist = planFlighttype == "I"
-                               ? Airac::ifrMaxWaypointInterval
-                               : Airac::nonIfrMaxWaypointInterval;
-
     if (depAirport() != 0) {
-        routeWaypointsCache = Airac::instance()->resolveFlightplan(
-            waypoints(), depAirport()->lat, depAirport()->lon, maxDist
+        routeCache = RouteCache::instance()->resolve(
+            depAirport(), planDest, waypoints(), planFlighttype
         );
     } else if (!qFuzzyIsNull(lat) || !qFuzzyIsNull(lon)) {
-        routeWaypointsCache = Airac::instance()->resolveFlightplan(
-            waypoints(), lat, lon, maxDist
-        );
+        // resolved around the current position, nothing to share with other pilots
+        routeCache = RouteCache::resolveUncached(waypoints(), lat, lon, planFlighttype);
     } else {
-        routeWaypointsCache = QList<Waypoint*>();
+        routeCache.reset();
+    }
+    routeWaypointsCache = routeCache.isNull()? QList<Waypoint*>(): routeCache->waypoints;
+
+    routeWaypointsWithDepDestCache = routeWaypointsCache;
+    if (depAirport() != 0) {
+        routeWaypointsWithDepDestCache.prepend(depAirport()->routeWaypoint());
+    }
+    if (destAirport() != 0) {
+        routeWaypointsWithDepDestCache.append(destAirport()->routeWaypoint());
+    }
+    routeGeoPointsCache.clear();
+    routeGeoPointsCache.reserve(routeWaypointsWithDepDestCache.size());
+    foreach (const Waypoint* w, routeWaypointsWithDepDestCache) {
+        routeGeoPointsCache.append(w->lat, w->lon);
     }
 
     return routeWaypointsCache;
@@ -614,14 +709,8 @@ QString Pilot::routeWaypointsString() {
 }
 
 QList<Waypoint*> Pilot::routeWaypointsWithDepDest() {
-    QList<Waypoint*> waypoints = routeWaypoints();
-    if (depAirport() != 0) {
-        waypoints.prepend(new Waypoint(depAirport()->id, depAirport()->lat, depAirport()->lon));
-    }
-    if (destAirport() != 0) {
-        waypoints.append(new Waypoint(destAirport()->id, destAirport()->lat, destAirport()->lon));
-    }
-    return waypoints;
+    routeWaypoints(); // validates the cache
+    return routeWaypointsWithDepDestCache;
 }
 
 void Pilot::checkStatus() {
@@ -632,3 +721,96 @@ void Pilot::checkStatus() {
         || flightStatus() == Pilot::BUSH
         || flightStatus() == Pilot::PREFILED;
 }
+
+bool Pilot::isFlightPlanEqual(const Pilot& other) const {
+    return planRevision == other.planRevision
+        && planDep == other.planDep
+        && planDest == other.planDest
+        && planRoute == other.planRoute
+        && planAlt == other.planAlt
+        && planFlighttype == other.planFlighttype;
+}
+
+bool Pilot::updateStateFrom(const Pilot& other, bool* isMoved) {
+    *isMoved = lat != other.lat || lon != other.lon
+        || altitude != other.altitude || groundspeed != other.groundspeed
+        || trueHeading != other.trueHeading;
+    // whazzupTime (and dayOfFlight derived from it) advances with every update and does not count
+    const bool isChanged = *isMoved
+        || qnh_inHg != other.qnh_inHg || qnh_mb != other.qnh_mb
+        || transponder != other.transponder || transponderAssigned != other.transponderAssigned
+        || userId != other.userId || server != other.server || rating != other.rating
+        || pilotRating != other.pilotRating || militaryRating != other.militaryRating
+        || timeConnected != other.timeConnected || homeBase != other.homeBase
+        || m_nameOrCid != other.m_nameOrCid
+        || planAircraftShort != other.planAircraftShort || planAircraftFaa != other.planAircraftFaa
+        || planAircraftFull != other.planAircraftFull || planTAS != other.planTAS
+        || planAltAirport != other.planAltAirport || planDeptime != other.planDeptime
+        || planActtime != other.planActtime || planRemarks != other.planRemarks
+        || planEnroute_hrs != other.planEnroute_hrs || planEnroute_mins != other.planEnroute_mins
+        || planFuel_hrs != other.planFuel_hrs || planFuel_mins != other.planFuel_mins
+        || airline != other.airline;
+
+    lat = other.lat;
+    lon = other.lon;
+    altitude = other.altitude;
+    groundspeed = other.groundspeed;
+    trueHeading = other.trueHeading;
+    qnh_inHg = other.qnh_inHg;
+    qnh_mb = other.qnh_mb;
+    transponder = other.transponder;
+    transponderAssigned = other.transponderAssigned;
+    whazzupTime = other.whazzupTime;
+    dayOfFlight = other.dayOfFlight;
+
+    userId = other.userId;
+    server = other.server;
+    rating = other.rating;
+    pilotRating = other.pilotRating;
+    militaryRating = other.militaryRating;
+    timeConnected = other.timeConnected;
+    homeBase = other.homeBase;
+    m_nameOrCid = other.m_nameOrCid;
+
+    // flight plan fields that isFlightPlanEqual() does not compare
+    planAircraftShort = other.planAircraftShort;
+    planAircraftFaa = other.planAircraftFaa;
+    planAircraftFull = other.planAircraftFull;
+    planTAS = other.planTAS;
+    planAltAirport = other.planAltAirport;
+    planDeptime = other.planDeptime;
+    planActtime = other.planActtime;
+    planRemarks = other.planRemarks;
+    planEnroute_hrs = other.planEnroute_hrs;
+    planEnroute_mins = other.planEnroute_mins;
+    planFuel_hrs = other.planFuel_hrs;
+    planFuel_mins = other.planFuel_mins;
+    airline = other.airline;
+
+    checkStatus();
+    return isChanged;
+}
+
+void Pilot::assignKeepingRoute(const Pilot& other) {
+    // data saved in this object needs to survive, the cache is validated against the plan
+    const bool _showRoute = showRoute;
+    const QSharedPointer<const ResolvedRoute> _routeCache = routeCache;
+    const QList<Waypoint*> _routeWaypointsCache = routeWaypointsCache,
+        _routeWaypointsWithDepDestCache = routeWaypointsWithDepDestCache;
+    const GeoPoints _routeGeoPointsCache = routeGeoPointsCache;
+    const QString _planDepCache = routeWaypointsPlanDepCache,
+        _planDestCache = routeWaypointsPlanDestCache,
+        _planRouteCache = routeWaypointsPlanRouteCache;
+
+    *this = other;
+
+    showRoute = _showRoute;
+    routeCache = _routeCache;
+    routeWaypointsCache = _routeWaypointsCache;
+    routeWaypointsWithDepDestCache = _routeWaypointsWithDepDestCache;
+    routeGeoPointsCache = _routeGeoPointsCache;
+    routeWaypointsPlanDepCache = _planDepCache;
+    routeWaypointsPlanDestCache = _planDestCache;
+    routeWaypointsPlanRouteCache = _planRouteCache;
+    checkStatus();
+}
@@ -3,6 +3,7 @@
 
 #include "Airline.h"
 #include "Client.h"
+#include "GeoPoints.h"
 #include "MapObject.h"
 #include "Waypoint.h"
 #include "src/mustache/contexts/PilotContext.h"
@@ -10,6 +11,7 @@
 #include <QJsonDocument>
 
 class Airport;
+struct ResolvedRoute;
 
 class Pilot
     : public MapObject, public Client {
@@ -24,6 +26,7 @@ class Pilot
         };
 
         Pilot(const QJsonObject& json, const WhazzupData* whazzup);
+        Pilot(JsonPullReader& reader, const WhazzupData* whazzup);
         virtual ~Pilot();
 
         virtual QString toolTip() const override;
@@ -65,6 +68,12 @@ class Pilot
         QList<Waypoint*> routeWaypointsWithDepDest();
         void checkStatus(); // adjust label visibility from flight status
 
+        // used by WhazzupData::updateFrom() to only transfer what changed
+        bool isFlightPlanEqual(const Pilot& other) const;
+        // everything but the route-relevant flight plan fields, returns true if anything changed
+        bool updateStateFrom(const Pilot& other, bool* isMoved);
+        void assignKeepingRoute(const Pilot& other);
+
         QString planAircraftShort, planAircraftFaa, planAircraftFull,
             planTAS, planDep, planAlt, planDest,
             planAltAirport, planRevision, planFlighttype, planDeptime,
@@ -79,8 +88,13 @@ class Pilot
         double trueHeading, qnh_inHg;
         bool showRoute = false;
         QDateTime whazzupTime; // need some local reference to that
+        QSharedPointer<const ResolvedRoute> routeCache; // keeps the waypoints of routeWaypointsCache alive
         QList<Waypoint*> routeWaypointsCache; // caching calculated routeWaypoints
+        QList<Waypoint*> routeWaypointsWithDepDestCache; // validated together with routeWaypointsCache
+        GeoPoints routeGeoPointsCache; // positions of routeWaypointsWithDepDestCache
         Airline* airline;
+    private:
+        void initDerivedFields(const QString& timeEnroute, const QString& timeFuel);
 };
 
 #endif /*PILOT_H_*/
@@ -1,8 +1,10 @@
 #include "Airac.h"
+#include "Benchmark.h"
 #include "Launcher.h"
 #include "NavData.h"
 #include "Platform.h"
 #include "Settings.h"
+#include "WhazzupArchive.h"
 #include "src/Airport.h"
 
 #include <QApplication>
@@ -93,8 +95,23 @@ int main(int argc, char* argv[]) {
         "<dep> <route> <dest>"
 
     );
-    parser.addOptions({ routeOption });
+    QCommandLineOption benchmarkOption(
+        "benchmark",
+        "run developer benchmark (" + Benchmark::names.join(", ") + ")",
+        "<name> [files...]"
+    );
+    QCommandLineOption migrateWhazzupsOption(
+        "migrate-whazzups",
+        "move downloaded .whazzup files into the compressed Whazzup archive"
+    );
+    parser.addOptions({ routeOption, benchmarkOption, migrateWhazzupsOption });
     parser.process(app);
+    if (parser.isSet(benchmarkOption)) {
+        return Benchmark::run(parser.value(benchmarkOption), parser.positionalArguments());
+    }
+    if (parser.isSet(migrateWhazzupsOption)) {
+        return WhazzupArchive::migrate(Settings::dataDirectory("downloaded/"));
+    }
     if (parser.isSet(routeOption)) { // resolves a route
         if (parser.positionalArguments().size() < 1) {
             QTextStream(stdout) << "ERROR: need at least 2 arguments" << Qt::endl;
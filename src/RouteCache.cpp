@@ -0,0 +1,77 @@
+#include "RouteCache.h"
+
+#include "Airac.h"
+#include "Airport.h"
+
+RouteCache* routeCacheInstance = 0;
+RouteCache* RouteCache::instance() {
+    if (routeCacheInstance == 0) {
+        routeCacheInstance = new RouteCache();
+    }
+    return routeCacheInstance;
+}
+
+ResolvedRoute::~ResolvedRoute() {
+    qDeleteAll(synthesized);
+}
+
+// each entry has a cost of 1
+RouteCache::RouteCache()
+    : _cache(10000) {}
+
+QSharedPointer<const ResolvedRoute> RouteCache::resolve(
+    const Airport* dep,
+    const QString &dest,
+    const QStringList &route,
+    const QString &flightRules
+) {
+    const QString key = QString("%1|%2|%3|%4").arg(dep->id, dest, flightRules, route.join(' '));
+
+    QMutexLocker locker(&_mutex);
+    const QSharedPointer<const ResolvedRoute>* cached = _cache.object(key);
+    if (cached != 0) {
+        _hits++;
+        return *cached;
+    }
+    _misses++;
+    locker.unlock();
+
+    const QSharedPointer<const ResolvedRoute> result = resolveUncached(route, dep->lat, dep->lon, flightRules);
+
+    locker.relock();
+    _cache.insert(key, new QSharedPointer<const ResolvedRoute>(result));
+    return result;
+}
+
+QSharedPointer<const ResolvedRoute> RouteCache::resolveUncached(
+    const QStringList &route, double lat, double lon, const QString &flightRules
+) {
+    const double maxDist = flightRules == "I"
+                               ? Airac::ifrMaxWaypointInterval
+                               : Airac::nonIfrMaxWaypointInterval;
+    ResolvedRoute* result = new ResolvedRoute();
+    result->waypoints = Airac::instance()->resolveFlightplan(route, lat, lon, maxDist, &result->synthesized);
+    return QSharedPointer<const ResolvedRoute>(result);
+}
+
+void RouteCache::clear() {
+    QMutexLocker locker(&_mutex);
+    _cache.clear();
+    _hits = 0;
+    _misses = 0;
+}
+
+int RouteCache::size() const {
+    QMutexLocker locker(&_mutex);
+    return _cache.size();
+}
+
+quint64 RouteCache::hits() const {
+    QMutexLocker locker(&_mutex);
+    return _hits;
+}
+
+quint64 RouteCache::misses() const {
+    QMutexLocker locker(&_mutex);
+    return _misses;
+}
@@ -0,0 +1,59 @@
+#ifndef ROUTECACHE_H_
+#define ROUTECACHE_H_
+
+#include "Waypoint.h"
+
+#include <QtCore>
+
+class Airport;
+
+/**
+ * A resolved route. Waypoints synthesized for coordinates (e.g. 5020N,
+ * 35/30) belong to it and are deleted with it, so whoever uses the
+ * waypoints keeps the route.
+ */
+struct ResolvedRoute {
+    ResolvedRoute() {}
+    ~ResolvedRoute();
+
+    QList<Waypoint*> waypoints;
+    QList<Waypoint*> synthesized; // part of waypoints
+    private:
+        Q_DISABLE_COPY(ResolvedRoute)
+};
+
+/**
+ * LRU cache of resolved flight plan routes shared by all pilots. A resolved
+ * route only depends on the departure airport, the route and the flight
+ * rules, so it survives Whazzup updates and pilots going from prefiled to
+ * connected. Cleared when the AIRAC data gets reloaded. Evicted routes
+ * live on while pilots still hold them.
+ */
+class RouteCache {
+    public:
+        static RouteCache* instance();
+
+        QSharedPointer<const ResolvedRoute> resolve(
+            const Airport* dep,
+            const QString &dest,
+            const QStringList &route,
+            const QString &flightRules
+        );
+        // not cached, e.g. around a position
+        static QSharedPointer<const ResolvedRoute> resolveUncached(
+            const QStringList &route, double lat, double lon, const QString &flightRules
+        );
+        void clear();
+
+        int size() const;
+        quint64 hits() const;
+        quint64 misses() const;
+    private:
+        RouteCache();
+
+        mutable QMutex _mutex;
+        QCache<QString, QSharedPointer<const ResolvedRoute> > _cache;
+        quint64 _hits = 0, _misses = 0;
+};
+
+#endif /*ROUTECACHE_H_*/
@@ -0,0 +1,221 @@
+#include "RouteTokenizer.h"
+
+// ARINC424 waypoints (strict)
+const QRegularExpression RouteTokenizer::arincRegExp = QRegularExpression(
+    "^(\\d{2})([NSEW]?)(\\d{2})([NSEW]?)$"
+);
+// things that are valid for the Eurocontrol route validator:
+// 63N005W or 6330N00530W (minutes) or 633000N0053000W (minutes and seconds)
+// we are not strict and also allow 2-char longitudes like 63N05W
+const QRegularExpression RouteTokenizer::eurocontrolRegExp = QRegularExpression(
+    "^(\\d{2})((\\d{2})?)((\\d{2})?)([NS])(\\d{2,3})((\\d{2})?)((\\d{2})?)([EW])$"
+);
+// some pilots like to use non-standard: -53/170
+const QRegularExpression RouteTokenizer::slashRegExp = QRegularExpression(
+    "^([\\-]?\\d{2})/([\\-]?\\d{2,3})$"
+);
+
+static inline bool isDigit(QChar c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool isUpper(QChar c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+static inline bool isSeparator(QChar c) {
+    return c.isSpace() || c == '-' || c == '+' || c == '.' || c == ',' || c == '/';
+}
+
+// number of digits starting at from
+static int digitRun(const QString &token, int from) {
+    int i = from;
+    while (i < token.size() && isDigit(token[i])) {
+        i++;
+    }
+    return i - from;
+}
+
+bool RouteTokenizer::isLatitudeHalf(const QString &token) {
+    const int digits = digitRun(token, 0);
+    return digits >= 2 && digits <= 4 && token.size() == digits + 1
+        && (token[digits] == 'N' || token[digits] == 'S');
+}
+
+bool RouteTokenizer::isLongitudeHalf(const QString &token) {
+    const int digits = digitRun(token, 0);
+    return (digits == 2 || digits == 3 || digits == 5) && token.size() == digits + 1
+        && (token[digits] == 'E' || token[digits] == 'W');
+}
+
+bool RouteTokenizer::isSlashCoordinate(const QString &token) {
+    int i = 0;
+    if (i < token.size() && token[i] == '-') {
+        i++;
+    }
+    int digits = digitRun(token, i);
+    if (digits != 2) {
+        return false;
+    }
+    i += digits;
+    if (i >= token.size() || token[i] != '/') {
+        return false;
+    }
+    i++;
+    if (i < token.size() && token[i] == '-') {
+        i++;
+    }
+    digits = digitRun(token, i);
+    return (digits == 2 || digits == 3) && i + digits == token.size();
+}
+
+// 2 or more groups of speed/level letter and 3-4 digits
+bool RouteTokenizer::isSpeedLevel(const QString &token) {
+    int groups = 0, i = 0;
+    while (i < token.size()) {
+        const QChar c = token[i];
+        if (c != 'M' && c != 'N' && c != 'A' && c != 'F' && c != 'S' && c != 'K') {
+            return false;
+        }
+        const int digits = digitRun(token, i + 1);
+        if (digits < 3 || digits > 4) {
+            return false;
+        }
+        i += 1 + digits;
+        groups++;
+    }
+    return groups >= 2;
+}
+
+// 1-2 letters, 1-4 digits, optional suffix letter: L9, UL607, N906A
+static bool isAirway(const QString &token) {
+    int i = 0;
+    while (i < token.size() && isUpper(token[i])) {
+        i++;
+    }
+    if (i < 1 || i > 2) {
+        return false;
+    }
+    const int digits = digitRun(token, i);
+    if (digits < 1 || digits > 4) {
+        return false;
+    }
+    i += digits;
+    if (i < token.size() && isUpper(token[i])) {
+        i++;
+    }
+    return i == token.size();
+}
+
+RouteTokenizer::TokenType RouteTokenizer::classify(const QString &token) {
+    if (token == QLatin1String("DCT")) {
+        return Direct;
+    }
+    if (isSpeedLevel(token)) {
+        return SpeedLevel;
+    }
+    if ( // 2 digits, optionally followed by a letter: runways, stray numbers
+        token.size() >= 2 && token.size() <= 3
+        && isDigit(token[0]) && isDigit(token[1])
+        && (token.size() == 2 || !isDigit(token[2]))
+    ) {
+        return Other;
+    }
+    if (isSlashCoordinate(token)) {
+        return Coordinate;
+    }
+    if (isDigit(token[0])) {
+        if (eurocontrolRegExp.match(token).hasMatch()) {
+            return Coordinate;
+        }
+        const QRegularExpressionMatch arinc = arincRegExp.match(token);
+        // exactly one of the letters is set
+        if (arinc.hasMatch() && arinc.capturedLength(2) + arinc.capturedLength(4) == 1) {
+            return Coordinate;
+        }
+        return Fix; // FAA identifiers like 6J0
+    }
+    if (isAirway(token)) {
+        return Airway;
+    }
+    return Fix;
+}
+
+QString RouteTokenizer::typeName(TokenType type) {
+    switch (type) {
+        case Fix: return "Fix";
+        case Airway: return "Airway";
+        case Coordinate: return "Coordinate";
+        case SpeedLevel: return "SpeedLevel";
+        case Direct: return "Direct";
+        case Other: return "Other";
+    }
+    return QString();
+}
+
+QList<RouteTokenizer::Token> RouteTokenizer::tokenize(const QString &route) {
+    // pass 1: split into uppercase alphanumeric parts, keeping slash-style coordinates
+    QStringList parts;
+    const QString upper = route.toUpper();
+    int i = 0;
+    while (i < upper.size()) {
+        if (upper[i].isSpace()) {
+            i++;
+            continue;
+        }
+        // start of a whitespace separated word that might be a slash-style coordinate
+        if ((i == 0 || upper[i - 1].isSpace()) && (upper[i] == '-' || isDigit(upper[i]))) {
+            int end = i;
+            while (end < upper.size() && !upper[end].isSpace()) {
+                end++;
+            }
+            const QString word = upper.mid(i, end - i);
+            if (isSlashCoordinate(word)) {
+                parts.append(word);
+                i = end;
+                continue;
+            }
+        }
+        if (isSeparator(upper[i])) {
+            i++;
+            continue;
+        }
+
+        int end = i;
+        while (end < upper.size() && !isSeparator(upper[end])) {
+            end++;
+        }
+        // everything following an invalid character is dropped: "ABC*X"
+        int alnumEnd = i;
+        while (alnumEnd < end && (isDigit(upper[alnumEnd]) || isUpper(upper[alnumEnd]))) {
+            alnumEnd++;
+        }
+        if (alnumEnd > i) {
+            parts.append(upper.mid(i, alnumEnd - i));
+        }
+        i = end;
+    }
+
+    // pass 2: classify, joining split coordinates: 30N 050W
+    QList<Token> result;
+    for (int p = 0; p < parts.size(); p++) {
+        const QString &part = parts[p];
+        if (p + 1 < parts.size() && isLatitudeHalf(part) && isLongitudeHalf(parts[p + 1])) {
+            result.append({ Coordinate, part + parts[p + 1] });
+            p++;
+            continue;
+        }
+        result.append({ classify(part), part });
+    }
+    return result;
+}
+
+QStringList RouteTokenizer::waypointTokens(const QString &route) {
+    QStringList result;
+    foreach (const Token &token, tokenize(route)) {
+        if (token.type == Fix || token.type == Airway || token.type == Coordinate) {
+            result.append(token.text);
+        }
+    }
+    return result;
+}
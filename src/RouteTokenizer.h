@@ -0,0 +1,44 @@
+#ifndef ROUTETOKENIZER_H_
+#define ROUTETOKENIZER_H_
+
+#include <QtCore>
+
+/**
+ * Splits flight plan routes into classified tokens in one pass, e.g.
+ *   "N0450F350 ABC DCT DEF/N0440F360 UL607 GHI 5530N02000W 35/30"
+ * Classification is syntactic only: whether a Fix or Airway token actually
+ * exists is up to Airac::resolveFlightplan().
+ */
+class RouteTokenizer {
+    public:
+        enum TokenType {
+            Fix, // fix, navaid or aerodrome identifier, SID/STAR
+            Airway,
+            Coordinate, // ARINC424 (5530N), Eurocontrol (55N020W) or slash-style (-53/170)
+            SpeedLevel, // N0450F350, M082F370, K0900S1220
+            Direct, // DCT
+            Other // ignored: runway designators, stray numbers
+        };
+        struct Token {
+            TokenType type;
+            QString text;
+        };
+
+        static QList<Token> tokenize(const QString &route);
+        // the Fix, Airway and Coordinate tokens
+        static QStringList waypointTokens(const QString &route);
+        // token must be uppercase and alphanumeric
+        static TokenType classify(const QString &token);
+        static QString typeName(TokenType type);
+
+        // 30N, 3000N
+        static bool isLatitudeHalf(const QString &token);
+        // 050W, 05000W
+        static bool isLongitudeHalf(const QString &token);
+        static bool isSlashCoordinate(const QString &token);
+        static bool isSpeedLevel(const QString &token);
+
+        static const QRegularExpression arincRegExp, eurocontrolRegExp, slashRegExp;
+};
+
+#endif /*ROUTETOKENIZER_H_*/
@@ -0,0 +1,295 @@
+#include "SearchIndex.h"
+
+#include "Airline.h"
+#include "Airport.h"
+#include "Controller.h"
+#include "Friends.h"
+#include "NavData.h"
+#include "Pilot.h"
+#include "Sector.h"
+#include "Whazzup.h"
+
+SearchIndex* searchIndexInstance = 0;
+SearchIndex* SearchIndex::instance() {
+    if (searchIndexInstance == 0) {
+        searchIndexInstance = new SearchIndex();
+    }
+    return searchIndexInstance;
+}
+
+SearchIndex::SearchIndex()
+    : QObject() {
+    connect(Whazzup::instance(), &Whazzup::newData, this, &SearchIndex::whazzupUpdated);
+    connect(NavData::instance(), &NavData::loaded, this, &SearchIndex::invalidateStatic);
+    connect(Friends::instance(), &Friends::aliasesChanged, this, &SearchIndex::invalidateClients);
+}
+
+bool SearchIndex::Key::operator<(const Key& other) const {
+    return text < other.text;
+}
+
+static QStringList lowercaseKeys(const QStringList& keys) {
+    QStringList result;
+    foreach (const QString& key, keys) {
+        if (!key.isEmpty()) {
+            result << key.toLower();
+        }
+    }
+    return result;
+}
+
+static QStringList pilotKeys(const Pilot* p) {
+    return lowercaseKeys({ p->callsign, p->mapLabel(), p->userId, p->nameOrCid() });
+}
+
+static QStringList controllerKeys(const Controller* c) {
+    return lowercaseKeys(
+        {
+            c->callsign, c->mapLabel(), c->userId, c->nameOrCid(), c->realName(),
+            c->frequency, c->atisMessage, c->sector != 0? c->sector->name: QString()
+        }
+    );
+}
+
+void SearchIndex::whazzupUpdated() {
+    const WhazzupDelta& delta = Whazzup::instance()->lastDelta();
+    if (delta.isFullUpdate) {
+        _isClientsDirty = true;
+        return;
+    }
+
+    // mapLabel() is a key and the sort key, and it may show any pilot data
+    foreach (const QString& callsign, delta.pilotsAdded + delta.pilotsRemoved + delta.pilotsChanged) {
+        _dirtyClients.insert("P|" + callsign);
+    }
+    foreach (const QString& callsign, delta.bookedPilotsAdded + delta.bookedPilotsRemoved + delta.bookedPilotsChanged) {
+        _dirtyClients.insert("B|" + callsign);
+    }
+    foreach (const QString& callsign, delta.controllersAdded + delta.controllersRemoved + delta.controllersChanged) {
+        _dirtyClients.insert("C|" + callsign);
+    }
+}
+
+void SearchIndex::invalidateClients() {
+    _isClientsDirty = true;
+}
+
+void SearchIndex::invalidateStatic() {
+    _isStaticDirty = true;
+}
+
+int SearchIndex::addEntry(MapObject* object, const QStringList& keys) {
+    Entry entry { object, object->mapLabel(), keys };
+    if (!_freeEntries.isEmpty()) {
+        const int i = _freeEntries.takeLast();
+        _entries[i] = entry;
+        return i;
+    }
+    _entries.append(entry);
+    return _entries.size() - 1;
+}
+
+void SearchIndex::buildStatic() {
+    // client entries refer into _entries, so they are rebuilt as well
+    _entries.clear();
+    _freeEntries.clear();
+    _clientEntries.clear();
+    _clientKeys.clear();
+    _dirtyClients.clear();
+    _isClientsDirty = true;
+
+    // airline objects are not deleted: they might still be shown in the search results
+    _airlineObjects.clear();
+
+    _staticKeys.clear();
+    foreach (Airport* a, NavData::instance()->airports) {
+        const int entry = addEntry(a, lowercaseKeys({ a->id, a->name, a->city, a->countryCode, a->mapLabel() }));
+        foreach (const QString& key, _entries[entry].keys) {
+            _staticKeys.append({ key, entry });
+        }
+    }
+    foreach (const Airline* _airline, NavData::instance()->airlines) {
+        // we make it into a MapObject, because that fits the results here well
+        MapObject* object = new MapObject(_airline->label(), _airline->toolTip());
+        _airlineObjects.append(object);
+        const int entry = addEntry(object, lowercaseKeys({ _airline->code, _airline->name, _airline->callsign }));
+        foreach (const QString& key, _entries[entry].keys) {
+            _staticKeys.append({ key, entry });
+        }
+    }
+    std::sort(_staticKeys.begin(), _staticKeys.end());
+
+    _isStaticDirty = false;
+    _generation++;
+    qDebug() << "indexed" << _entries.size() << "airports and airlines with" << _staticKeys.size() << "keys";
+}
+
+void SearchIndex::indexClient(const QString& clientKey, MapObject* object, const QStringList& keys) {
+    _clientEntries.insert(clientKey, addEntry(object, keys));
+    _isClientKeysDirty = true;
+}
+
+void SearchIndex::removeClient(const QString& clientKey) {
+    auto it = _clientEntries.find(clientKey);
+    if (it == _clientEntries.end()) {
+        return;
+    }
+    // the object might already be deleted, so we do not touch it
+    _entries[it.value()] = Entry { 0, QString(), QStringList() };
+    _freeEntries.append(it.value());
+    _clientEntries.erase(it);
+    _isClientKeysDirty = true;
+}
+
+void SearchIndex::updateClients() {
+    const WhazzupData& data = Whazzup::instance()->whazzupData();
+    if (&data != _data) {
+        // switched between real and predicted data
+        _data = &data;
+        _isClientsDirty = true;
+    }
+
+    if (_isClientsDirty) {
+        foreach (const QString& clientKey, _clientEntries.keys()) {
+            removeClient(clientKey);
+        }
+        foreach (Pilot* p, data.pilots) {
+            indexClient("P|" + p->callsign, p, pilotKeys(p));
+        }
+        foreach (Pilot* b, data.bookedPilots) {
+            indexClient("B|" + b->callsign, b, pilotKeys(b));
+        }
+        foreach (Controller* c, data.controllers) {
+            indexClient("C|" + c->callsign, c, controllerKeys(c));
+        }
+        _isClientsDirty = false;
+    } else {
+        foreach (const QString& clientKey, _dirtyClients) {
+            removeClient(clientKey);
+            const QString callsign = clientKey.mid(2);
+            if (clientKey.startsWith("P|")) {
+                Pilot* p = data.pilots.value(callsign, 0);
+                if (p != 0) {
+                    indexClient(clientKey, p, pilotKeys(p));
+                }
+            } else if (clientKey.startsWith("B|")) {
+                Pilot* b = data.bookedPilots.value(callsign, 0);
+                if (b != 0) {
+                    indexClient(clientKey, b, pilotKeys(b));
+                }
+            } else {
+                Controller* c = data.controllers.value(callsign, 0);
+                if (c != 0) {
+                    indexClient(clientKey, c, controllerKeys(c));
+                }
+            }
+        }
+    }
+    _dirtyClients.clear();
+
+    if (_isClientKeysDirty) {
+        _clientKeys.clear();
+        foreach (const int entry, _clientEntries) {
+            foreach (const QString& key, _entries[entry].keys) {
+                _clientKeys.append({ key, entry });
+            }
+        }
+        std::sort(_clientKeys.begin(), _clientKeys.end());
+        _isClientKeysDirty = false;
+        _generation++;
+    }
+}
+
+void SearchIndex::prefixLookup(const QVector<Key>& keys, const QString& prefix, QSet<int>& result) {
+    auto it = std::lower_bound(keys.constBegin(), keys.constEnd(), Key { prefix, -1 });
+    for (; it != keys.constEnd() && it->text.startsWith(prefix); ++it) {
+        result.insert(it->entry);
+    }
+}
+
+QList<MapObject*> SearchIndex::search(const QString& searchStr) {
+    if (_isStaticDirty) {
+        buildStatic();
+    }
+    updateClients();
+
+    // same tokens as the SearchVisitor
+    QStringList tokens = QString(searchStr)
+        .replace(QRegExp("\\*"), ".*")
+        .split(QRegExp("[ \\,]+"), Qt::SkipEmptyParts);
+    if (tokens.isEmpty()) {
+        return QList<MapObject*>();
+    }
+
+    bool isPlain = true;
+    for (int i = 0; i < tokens.size(); i++) {
+        tokens[i] = tokens[i].toLower();
+        if (QRegExp::escape(tokens[i]) != tokens[i]) {
+            isPlain = false;
+        }
+    }
+
+    QVector<int> entries;
+    if (!isPlain) {
+        // wildcards or regular expressions: match all keys
+        QString regExpStr = "^(" + tokens.join("|") + ".*)";
+        if (tokens.size() == 1) {
+            regExpStr = "^" + tokens.first() + ".*";
+        }
+        const QRegExp regex(regExpStr, Qt::CaseInsensitive);
+        for (int i = 0; i < _entries.size(); i++) {
+            if (_entries[i].object == 0) {
+                continue;
+            }
+            foreach (const QString& key, _entries[i].keys) {
+                if (key.contains(regex)) {
+                    entries.append(i);
+                    break;
+                }
+            }
+        }
+        _lastTerm.clear();
+    } else if (
+        tokens.size() == 1 && _lastGeneration == _generation
+        && !_lastTerm.isEmpty() && tokens.first().startsWith(_lastTerm)
+    ) {
+        // the user typed on: narrow down the previous result
+        foreach (const int i, _lastEntries) {
+            foreach (const QString& key, _entries[i].keys) {
+                if (key.startsWith(tokens.first())) {
+                    entries.append(i);
+                    break;
+                }
+            }
+        }
+        _lastTerm = tokens.first();
+    } else {
+        QSet<int> found;
+        foreach (const QString& token, tokens) {
+            prefixLookup(_staticKeys, token, found);
+            prefixLookup(_clientKeys, token, found);
+        }
+        entries.reserve(found.size());
+        foreach (const int i, found) {
+            entries.append(i);
+        }
+        _lastTerm = tokens.size() == 1? tokens.first(): QString();
+    }
+    _lastEntries = entries;
+    _lastGeneration = _generation;
+
+    std::sort(
+        entries.begin(),
+        entries.end(),
+        [this](int a, int b) {
+            return _entries[a].sortKey < _entries[b].sortKey;
+        }
+    );
+
+    QList<MapObject*> result;
+    result.reserve(entries.size());
+    foreach (const int i, entries) {
+        result.append(_entries[i].object);
+    }
+    return result;
+}
@@ -0,0 +1,69 @@
+#ifndef SEARCHINDEX_H_
+#define SEARCHINDEX_H_
+
+#include "MapObject.h"
+
+#include <QtCore>
+
+class WhazzupData;
+
+/**
+ * Search index for the search dock: airports and airlines (built once per
+ * NavData load) and clients of Whazzup::whazzupData(), which are re-indexed
+ * by callsign from the Whazzup deltas when searching. Keys (ICAO code,
+ * callsign, name, CID, ...) are kept lowercase in sorted arrays, so a
+ * search term is looked up as a prefix with a binary search. Terms that
+ * use wildcards or regular expressions fall back to matching all keys, like
+ * the former SearchVisitor. Results are sorted by their mapLabel() as of
+ * indexing time.
+ */
+class SearchIndex
+    : public QObject {
+    Q_OBJECT
+    public:
+        static SearchIndex* instance();
+
+        QList<MapObject*> search(const QString& searchStr);
+    private slots:
+        void whazzupUpdated();
+        void invalidateClients();
+        void invalidateStatic();
+    private:
+        SearchIndex();
+
+        struct Entry {
+            MapObject* object; // 0 for free entries
+            QString sortKey;
+            QStringList keys; // lowercase
+        };
+        struct Key {
+            QString text;
+            int entry;
+            bool operator<(const Key& other) const;
+        };
+
+        void buildStatic();
+        void updateClients();
+        void indexClient(const QString& clientKey, MapObject* object, const QStringList& keys);
+        void removeClient(const QString& clientKey);
+        int addEntry(MapObject* object, const QStringList& keys);
+        static void prefixLookup(const QVector<Key>& keys, const QString& prefix, QSet<int>& result);
+
+        QVector<Entry> _entries;
+        QVector<int> _freeEntries;
+        QVector<Key> _staticKeys, _clientKeys;
+        QHash<QString, int> _clientEntries; // by "P|callsign", "B|callsign" (booked), "C|callsign"
+        QList<MapObject*> _airlineObjects;
+
+        // what changed since the last search
+        bool _isStaticDirty = true, _isClientsDirty = true, _isClientKeysDirty = false;
+        const WhazzupData* _data = 0;
+        QSet<QString> _dirtyClients;
+
+        // incremental narrowing while typing
+        int _generation = 0, _lastGeneration = -1;
+        QString _lastTerm;
+        QVector<int> _lastEntries;
+};
+
+#endif /*SEARCHINDEX_H_*/
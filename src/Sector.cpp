@@ -1,13 +1,12 @@
 #include "Sector.h"
 
 #include "helpers.h"
-#include "Settings.h"
 #include "Tessellator.h"
+#include "VertexBatch.h"
 
 Sector::Sector(const QStringList &fields, const int debugControllerLineNumber, const int debugSectorLineNumber)
     : _debugControllerLineNumber(debugControllerLineNumber),
-      _debugSectorLineNumber(debugSectorLineNumber),
-      _polygon(0), _borderline(0), _polygonHighlighted(0), _borderlineHighlighted(0) {
+      _debugSectorLineNumber(debugSectorLineNumber) {
     // LSAZ:Zurich::::189[:CTR]
     if (fields.size() != 6 && fields.size() != 7) {
         QMessageLogger("firlist.dat", debugControllerLineNumber, QT_MESSAGELOG_FUNC).critical()
@@ -23,20 +22,7 @@ Sector::Sector(const QStringList &fields, const int debugControllerLineNumber, c
     }
 }
 
-Sector::~Sector() {
-    if (_polygon != 0 && glIsList(_polygon) == GL_TRUE) {
-        glDeleteLists(_polygon, 1);
-    }
-    if (_borderline != 0 && glIsList(_borderline) == GL_TRUE) {
-        glDeleteLists(_borderline, 1);
-    }
-    if (_polygonHighlighted != 0 && glIsList(_polygonHighlighted) == GL_TRUE) {
-        glDeleteLists(_polygonHighlighted, 1);
-    }
-    if (_borderlineHighlighted != 0 && glIsList(_borderlineHighlighted) == GL_TRUE) {
-        glDeleteLists(_borderlineHighlighted, 1);
-    }
-}
+Sector::~Sector() {}
 
 bool Sector::isNull() const {
     return icao.isNull();
@@ -67,6 +53,8 @@ const QList<QPolygonF> &Sector::nonWrappedPolygons() const {
 
 void Sector::setPoints(const QList<QPair<double, double> > &points) {
     m_points = points;
+    m_polygonVertices.clear();
+    m_borderLineVertices.clear();
 
     // Populate m_nonWrappedPolygons:
     m_nonWrappedPolygons = { QPolygonF(), QPolygonF() };
@@ -131,90 +119,18 @@ int Sector::debugSectorLineNumber() {
     return _debugSectorLineNumber;
 }
 
-GLuint Sector::glPolygon() {
-    if (_polygon != 0 && glIsList(_polygon) == GL_TRUE) {
-        return _polygon;
-    }
-
-    if (glGetError() == GL_INVALID_OPERATION) {
-        qCritical() << "Ooftimama - probably between glBegin and glEnd";
+const QVector<GLfloat>& Sector::polygonVertices() {
+    if (m_polygonVertices.isEmpty() && m_points.size() >= 3) {
+        m_polygonVertices = Tessellator().triangles(m_points);
     }
-
-    _polygon = glGenLists(1);
-    glNewList(_polygon, GL_COMPILE);
-    QColor color = Settings::firFillColor();
-    glColor4f(color.redF(), color.greenF(), color.blueF(), color.alphaF());
-    Tessellator().tessellate(m_points);
-    glEndList();
-
-    return _polygon;
+    return m_polygonVertices;
 }
 
-GLuint Sector::glBorderLine() {
-    if (_borderline != 0 && glIsList(_borderline) == GL_TRUE) {
-        return _borderline;
-    }
-
-    if (glGetError() == GL_INVALID_OPERATION) {
-        qCritical() << "Ooftimama - probably between glBegin and glEnd";
+const QVector<GLfloat>& Sector::borderLineVertices() {
+    if (m_borderLineVertices.isEmpty()) {
+        m_borderLineVertices = VertexBatch::lineVertices(m_points, true, true);
     }
-
-    _borderline = glGenLists(1);
-    glNewList(_borderline, GL_COMPILE);
-    glLineWidth(Settings::firBorderLineStrength());
-    glBegin(GL_LINE_LOOP);
-    QColor color = Settings::firBorderLineColor();
-    glColor4f(color.redF(), color.greenF(), color.blueF(), color.alphaF());
-    for (int i = 0; i < m_points.size(); i++) {
-        VERTEXhigh(m_points[i].first, m_points[i].second);
-    }
-    glEnd();
-    glEndList();
-
-    return _borderline;
-}
-
-GLuint Sector::glPolygonHighlighted() {
-    if (_polygonHighlighted != 0 && glIsList(_polygonHighlighted) == GL_TRUE) {
-        return _polygonHighlighted;
-    }
-
-    if (glGetError() == GL_INVALID_OPERATION) {
-        qCritical() << "Ooftimama - probably between glBegin and glEnd";
-    }
-
-    _polygonHighlighted = glGenLists(1);
-    glNewList(_polygonHighlighted, GL_COMPILE);
-    QColor color = Settings::firHighlightedFillColor();
-    glColor4f(color.redF(), color.greenF(), color.blueF(), color.alphaF());
-    Tessellator().tessellate(m_points);
-    glEndList();
-
-    return _polygonHighlighted;
-}
-
-GLuint Sector::glBorderLineHighlighted() {
-    if (_borderlineHighlighted != 0 && glIsList(_borderlineHighlighted) == GL_TRUE) {
-        return _borderlineHighlighted;
-    }
-
-    if (glGetError() == GL_INVALID_OPERATION) {
-        qCritical() << "Ooftimama - probably between glBegin and glEnd";
-    }
-
-    _borderlineHighlighted = glGenLists(1);
-    glNewList(_borderlineHighlighted, GL_COMPILE);
-    glLineWidth(Settings::firHighlightedBorderLineStrength());
-    glBegin(GL_LINE_LOOP);
-    QColor color = Settings::firHighlightedBorderLineColor();
-    glColor4f(color.redF(), color.greenF(), color.blueF(), color.alphaF());
-    for (int i = 0; i < m_points.size(); i++) {
-        VERTEXhigh(m_points[i].first, m_points[i].second);
-    }
-    glEnd();
-    glEndList();
-
-    return _borderlineHighlighted;
+    return m_borderLineVertices;
 }
 
 QPair<double, double> Sector::getCenter() const {
@@ -23,10 +23,10 @@ class Sector {
         int debugSectorLineNumber();
         void setDebugSectorLineNumber(int newDebugSectorLineNumber);
 
-        GLuint glPolygon();
-        GLuint glBorderLine();
-        GLuint glPolygonHighlighted();
-        GLuint glBorderLineHighlighted();
+        // x, y, z vertices for GL_TRIANGLES, computed on first use
+        const QVector<GLfloat>& polygonVertices();
+        // x, y, z vertices for GL_LINES, computed on first use
+        const QVector<GLfloat>& borderLineVertices();
 
         QPair<double, double> getCenter() const;
 
@@ -38,7 +38,7 @@ class Sector {
         QStringList m_controllerSuffixes = QStringList();
         QList<QPolygonF> m_nonWrappedPolygons;
         QList<QPair<double, double> > m_points;
-        GLuint _polygon = 0, _borderline = 0, _polygonHighlighted = 0, _borderlineHighlighted = 0;
+        QVector<GLfloat> m_polygonVertices, m_borderLineVertices;
 };
 
 #endif /*SECTOR_H_*/
@@ -2,6 +2,7 @@
 
 #include "FileReader.h"
 #include "helpers.h"
+#include "NavDataCache.h"
 #include "Settings.h"
 
 SectorReader::SectorReader() {}
@@ -39,14 +40,86 @@ void SectorReader::loadSectorlist(QMultiMap<QString, Sector*>& sectors) {
 }
 
 void SectorReader::loadSectordisplay(QMultiMap<QString, Sector*>& sectors) {
-    auto filePath = "data/firdisplay.dat";
-    FileReader* fileReader = new FileReader(Settings::dataDirectory(filePath));
+    const QString filePath = Settings::dataDirectory("data/firdisplay.dat");
+    QList<DisplayList> displayLists;
+
+    NavDataCache cache("firdisplay", { filePath });
+    const bool fromCache = cache.read(
+        [&displayLists](QDataStream& in) {
+            qint32 size;
+            in >> size;
+            for (qint32 i = 0; i < size && in.status() == QDataStream::Ok; i++) {
+                DisplayList displayList;
+                in >> displayList.id >> displayList.debugLineNumber >> displayList.points;
+                displayLists.append(displayList);
+            }
+            return true;
+        }
+    );
+    if (!fromCache) {
+        displayLists = readSectordisplay(filePath);
+        cache.write(
+            [&displayLists](QDataStream& out) {
+                out << (qint32) displayLists.size();
+                foreach (const DisplayList &displayList, displayLists) {
+                    out << displayList.id << displayList.debugLineNumber << displayList.points;
+                }
+            }
+        );
+    }
+
+    foreach (const DisplayList &displayList, displayLists) {
+        if (displayList.points.size() < 3) {
+            QMessageLogger("data/firdisplay.dat", displayList.debugLineNumber, QT_MESSAGELOG_FUNC).critical()
+                << "Sector" << displayList.id << "doesn't contain enough points (" << displayList.points.size() << ", expected 3+)";
+            exit(EXIT_FAILURE);
+        }
+
+        QList<Sector*> sectorsWithMatchingId;
+        foreach (const auto sector, sectors) {
+            if (sector->id == displayList.id) {
+                sectorsWithMatchingId.append(sector);
+            }
+        }
+
+        if (sectorsWithMatchingId.size() == 0) {
+            QMessageLogger("data/firdisplay.dat", displayList.debugLineNumber, QT_MESSAGELOG_FUNC).info()
+                << "Sector ID" << displayList.id << "is not used in firlist.dat.";
+
+            // add this pseudo sector to be able to show it in StaticSectorsDialog
+            auto* s = new Sector(
+                {
+                    "ZZZZ " + displayList.id,
+                    "not used by any controller",
+                    NULL,
+                    NULL,
+                    NULL,
+                    displayList.id,
+                },
+                -1,
+                displayList.debugLineNumber
+            );
+            s->setPoints(displayList.points);
+
+            sectors.insert(NULL, s);
+        }
 
-    QString workingSectorId;
-    QList<QPair<double, double> > pointList;
+        foreach (const auto sector, sectorsWithMatchingId) {
+            if (sector != 0) {
+                sector->setDebugSectorLineNumber(displayList.debugLineNumber);
+                sector->setPoints(displayList.points);
+            }
+        }
+    }
+}
+
+QList<SectorReader::DisplayList> SectorReader::readSectordisplay(const QString& filePath) {
+    QList<DisplayList> result;
+    FileReader* fileReader = new FileReader(filePath);
+
+    DisplayList working;
 
     unsigned int count = 0;
-    unsigned int debugLineWorkingSectorStart = 0;
     while (!fileReader->atEnd()) {
         ++count;
         QString line = fileReader->nextLine();
@@ -61,55 +134,15 @@ void SectorReader::loadSectordisplay(QMultiMap<QString, Sector*>& sectors) {
         // DISPLAY_LIST_    // last line is always DISPLAY_LIST_
 
         if (line.startsWith("DISPLAY_LIST_")) {
-            if (!workingSectorId.isEmpty()) { // we are at the end of a section
-                if (pointList.size() < 3) {
-                    QMessageLogger(filePath, debugLineWorkingSectorStart, QT_MESSAGELOG_FUNC).critical()
-                        << "Sector" << workingSectorId << "doesn't contain enough points (" << pointList.size() << ", expected 3+)";
-                    exit(EXIT_FAILURE);
-                }
-
-                QList<Sector*> sectorsWithMatchingId;
-                foreach (const auto sector, sectors) {
-                    if (sector->id == workingSectorId) {
-                        sectorsWithMatchingId.append(sector);
-                    }
-                }
-
-                if (sectorsWithMatchingId.size() == 0) {
-                    QMessageLogger(filePath, count, QT_MESSAGELOG_FUNC).info()
-                        << line << "Sector ID" << workingSectorId << "is not used in firlist.dat.";
-
-                    // add this pseudo sector to be able to show it in StaticSectorsDialog
-                    auto* s = new Sector(
-                        {
-                            "ZZZZ " + workingSectorId,
-                            "not used by any controller",
-                            NULL,
-                            NULL,
-                            NULL,
-                            workingSectorId,
-                        },
-                        -1,
-                        debugLineWorkingSectorStart
-                    );
-                    s->setPoints(pointList);
-
-                    sectors.insert(NULL, s);
-                }
-
-                foreach (const auto sector, sectorsWithMatchingId) {
-                    if (sector != 0) {
-                        sector->setDebugSectorLineNumber(debugLineWorkingSectorStart);
-                        sector->setPoints(pointList);
-                    }
-                }
+            if (!working.id.isEmpty()) { // we are at the end of a section
+                result.append(working);
             }
 
             // new section starts here
-            workingSectorId = line.split('_').last();
-            debugLineWorkingSectorStart = count;
-            pointList.clear();
-        } else if (!workingSectorId.isEmpty()) {
+            working.id = line.split('_').last();
+            working.debugLineNumber = count;
+            working.points.clear();
+        } else if (!working.id.isEmpty()) {
             QStringList latLng = line.split(':');
             if (latLng.size() < 2) {
                 continue;
@@ -117,13 +150,14 @@ void SectorReader::loadSectordisplay(QMultiMap<QString, Sector*>& sectors) {
             double lat = latLng[0].toDouble();
             double lon = Helpers::modPositive(latLng[1].toDouble() + 180., 360.) - 180.;
             if (lat > 90. || lat < -90. || lon > 180. || lon < -180. || (qFuzzyIsNull(lat) && qFuzzyIsNull(lon))) {
-                QMessageLogger(filePath, count, QT_MESSAGELOG_FUNC).critical()
-                    << line << ": Sector id" << workingSectorId << "has invalid point" << lat << lon;
+                QMessageLogger("data/firdisplay.dat", count, QT_MESSAGELOG_FUNC).critical()
+                    << line << ": Sector id" << working.id << "has invalid point" << lat << lon;
                 exit(EXIT_FAILURE);
             }
 
-            pointList.append(QPair<double, double>(lat, lon));
+            working.points.append(QPair<double, double>(lat, lon));
         }
     }
     delete fileReader;
+    return result;
 }
@@ -12,6 +12,14 @@ class SectorReader {
     private:
         void loadSectorlist(QMultiMap<QString, Sector*>& sectors);
         void loadSectordisplay(QMultiMap<QString, Sector*>& sectors);
+
+        // one DISPLAY_LIST_ section of firdisplay.dat
+        struct DisplayList {
+            QString id;
+            qint32 debugLineNumber = 0;
+            QList<QPair<double, double> > points;
+        };
+        QList<DisplayList> readSectordisplay(const QString& filePath);
 };
 
 #endif /*SECTORREADER_H_*/
@@ -1,11 +1,9 @@
 #include "Settings.h"
 
+#include "Client.h"
 #include "GuiMessage.h"
 #include "Whazzup.h"
-#include "dialogs/AirportDetails.h"
-#include "dialogs/ControllerDetails.h"
-#include "dialogs/PilotDetails.h"
-#include "dialogs/Window.h"
+#include "src/mustache/Renderer.h"
 
 //singleton instance
 QSettings* settingsInstance = 0;
@@ -771,6 +769,7 @@ QString Settings::firPrimaryContent() {
 
 void Settings::setFirPrimaryContent(const QString &value) {
     instance()->setValue("firDisplay/primaryContent", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::firPrimaryContentHovered() {
@@ -779,6 +778,7 @@ QString Settings::firPrimaryContentHovered() {
 
 void Settings::setFirPrimaryContentHovered(const QString &value) {
     instance()->setValue("firDisplay/primaryContentHovered", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::firSecondaryContent() {
@@ -787,6 +787,7 @@ QString Settings::firSecondaryContent() {
 
 void Settings::setFirSecondaryContent(const QString &value) {
     instance()->setValue("firDisplay/secondaryContent", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::firSecondaryContentHovered() {
@@ -795,6 +796,7 @@ QString Settings::firSecondaryContentHovered() {
 
 void Settings::setFirSecondaryContentHovered(const QString &value) {
     instance()->setValue("firDisplay/secondaryContentHovered", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 
@@ -845,6 +847,7 @@ QString Settings::airportPrimaryContent() {
 
 void Settings::setAirportPrimaryContent(const QString &value) {
     instance()->setValue("airportDisplay/primaryContent", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::airportPrimaryContentHovered() {
@@ -853,6 +856,7 @@ QString Settings::airportPrimaryContentHovered() {
 
 void Settings::setAirportPrimaryContentHovered(const QString &value) {
     instance()->setValue("airportDisplay/primaryContentHovered", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::airportSecondaryContent() {
@@ -861,6 +865,7 @@ QString Settings::airportSecondaryContent() {
 
 void Settings::setAirportSecondaryContent(const QString &value) {
     instance()->setValue("airportDisplay/secondaryContent", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::airportSecondaryContentHovered() {
@@ -869,6 +874,7 @@ QString Settings::airportSecondaryContentHovered() {
 
 void Settings::setAirportSecondaryContentHovered(const QString &value) {
     instance()->setValue("airportDisplay/secondaryContentHovered", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QColor Settings::airportDotColor() {
@@ -1188,6 +1194,7 @@ QString Settings::pilotPrimaryContent() {
 
 void Settings::setPilotPrimaryContent(const QString &value) {
     instance()->setValue("pilotDisplay/primaryContent", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::pilotPrimaryContentHovered() {
@@ -1196,6 +1203,7 @@ QString Settings::pilotPrimaryContentHovered() {
 
 void Settings::setPilotPrimaryContentHovered(const QString &value) {
     instance()->setValue("pilotDisplay/primaryContentHovered", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::pilotSecondaryContent() {
@@ -1204,6 +1212,7 @@ QString Settings::pilotSecondaryContent() {
 
 void Settings::setPilotSecondaryContent(const QString &value) {
     instance()->setValue("pilotDisplay/secondaryContent", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QString Settings::pilotSecondaryContentHovered() {
@@ -1212,6 +1221,7 @@ QString Settings::pilotSecondaryContentHovered() {
 
 void Settings::setPilotSecondaryContentHovered(const QString &value) {
     instance()->setValue("pilotDisplay/secondaryContentHovered", value);
+    MustacheQs::Renderer::invalidateAll();
 }
 
 QColor Settings::pilotDotColor() {
@@ -1518,34 +1528,18 @@ void Settings::setClientAlias(const QString &userId, const QString &alias) {
             alias
         );
     }
+}
 
-    // should maybe use signals instead
-    auto wnd = Window::instance(false);
-    if (wnd != 0) {
-        if (wnd->friendsList != 0) {
-            wnd->friendsList->reset();
-        }
-        if (wnd->searchResult != 0) {
-            wnd->searchResult->reset();
-        }
-        if (wnd->mapScreen != 0) {
-            if (wnd->mapScreen->glWidget != 0) {
-                wnd->mapScreen->glWidget->update();
-            }
+QHash<QString, QString> Settings::clientAliases() {
+    QHash<QString, QString> result;
+    instance()->beginGroup("clients");
+    foreach (const auto key, instance()->childKeys()) {
+        if (key.startsWith("alias_")) {
+            result.insert(key.mid(6), instance()->value(key).toString());
         }
     }
-
-    if (PilotDetails::instance(false) != 0) {
-        PilotDetails::instance()->refresh();
-    }
-
-    if (ControllerDetails::instance(false) != 0) {
-        ControllerDetails::instance()->refresh();
-    }
-
-    if (AirportDetails::instance(false) != 0) {
-        AirportDetails::instance()->refresh();
-    }
+    instance()->endGroup();
+    return result;
 }
 
 bool Settings::resetOnNextStart() {
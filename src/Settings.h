@@ -479,6 +479,7 @@ class Settings {
 
         static const QString clientAlias(const QString& userId);
         static void setClientAlias(const QString& userId, const QString& alias = QString());
+        static QHash<QString, QString> clientAliases(); // by user ID
 
         static bool resetOnNextStart();
         static void setResetOnNextStart(bool value);
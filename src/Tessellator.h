@@ -29,26 +29,32 @@
     #define CALLBACK_DECL void CALLBACK
 #endif
 
+/**
+ * Splits polygons into triangles, to be drawn as GL_TRIANGLES.
+ */
 class Tessellator {
     public:
         Tessellator();
         ~Tessellator();
 
-        void tessellate(const QList<QPair<double, double> >& points);
+        // x, y, z of the triangle vertices
+        QVector<GLfloat> triangles(const QList<QPair<double, double> >& points, bool isHigh = true);
 
     private:
         GLUtesselator* _tess;
         QList<GLdouble*> _pointList;
+        QVector<GLfloat> _triangles;
 
-        static CALLBACK_DECL tessBeginCB(GLenum which);
-        static CALLBACK_DECL tessEndCB();
-        static CALLBACK_DECL tessVertexCB(const GLvoid* data);
+        static CALLBACK_DECL tessBeginCB(GLenum which, GLvoid* polygonData);
+        static CALLBACK_DECL tessEdgeFlagCB(GLboolean flag, GLvoid* polygonData);
+        static CALLBACK_DECL tessVertexCB(const GLvoid* data, GLvoid* polygonData);
         static CALLBACK_DECL tessErrorCB(GLenum errorCode);
         static CALLBACK_DECL tessCombineCB(
             const GLdouble newVertex[3],
             const GLdouble* neighborVertex[4],
             const GLfloat neighborWeight[4],
-            GLdouble** outData
+            GLdouble** outData,
+            GLvoid* polygonData
         );
 };
 
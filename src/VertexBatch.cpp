@@ -0,0 +1,174 @@
+#include "VertexBatch.h"
+
+#include "helpers.h"
+
+#include <algorithm>
+
+static inline void appendVertex(QVector<GLfloat>& vertices, double lat, double lon, bool isHigh) {
+    if (isHigh) {
+        vertices << SXhigh(lat, lon) << SYhigh(lat, lon) << SZhigh(lat, lon);
+    } else {
+        vertices << SX(lat, lon) << SY(lat, lon) << SZ(lat, lon);
+    }
+}
+
+VertexBatch::VertexBatch(GLenum mode, QOpenGLBuffer::UsagePattern usagePattern)
+    : _mode(mode), _buffer(QOpenGLBuffer::VertexBuffer) {
+    _buffer.setUsagePattern(usagePattern);
+}
+
+void VertexBatch::clear() {
+    _vertices.clear();
+    _uploadedCount = 0;
+}
+
+void VertexBatch::append(double lat, double lon, bool isHigh) {
+    appendVertex(_vertices, lat, lon, isHigh);
+}
+
+void VertexBatch::append(const QVector<GLfloat>& vertices) {
+    _vertices += vertices;
+}
+
+void VertexBatch::appendLineStrip(const QList<QPair<double, double> >& points, bool isClosed, bool isHigh) {
+    _vertices += lineVertices(points, isClosed, isHigh);
+}
+
+QVector<GLfloat> VertexBatch::lineVertices(const QList<QPair<double, double> >& points, bool isClosed, bool isHigh) {
+    QVector<GLfloat> result;
+    if (points.size() < 2) {
+        return result;
+    }
+    const int segments = isClosed? points.size(): points.size() - 1;
+    result.reserve(segments * 2 * 3);
+    for (int i = 0; i < segments; i++) {
+        const QPair<double, double>& from = points[i];
+        const QPair<double, double>& to = points[(i + 1) % points.size()];
+        appendVertex(result, from.first, from.second, isHigh);
+        appendVertex(result, to.first, to.second, isHigh);
+    }
+    return result;
+}
+
+void VertexBatch::upload() {
+    if (!_buffer.isCreated() && !_buffer.create()) {
+        qWarning() << "VertexBatch: could not create vertex buffer";
+        return;
+    }
+    _buffer.bind();
+    _buffer.allocate(_vertices.constData(), _vertices.size() * sizeof(GLfloat));
+    _buffer.release();
+    _uploadedCount = _vertices.size() / 3;
+    _vertices = QVector<GLfloat>();
+}
+
+void VertexBatch::draw() {
+    if (_uploadedCount == 0) {
+        return;
+    }
+    _buffer.bind();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, 0);
+    glDrawArrays(_mode, 0, _uploadedCount);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    _buffer.release();
+}
+
+int VertexBatch::vertexCount() const {
+    return _uploadedCount;
+}
+
+KeyedVertexBatch::KeyedVertexBatch(GLenum mode, int verticesPerKey)
+    : _mode(mode), _floatsPerSlot(verticesPerKey * 3), _buffer(QOpenGLBuffer::VertexBuffer) {
+    _buffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+}
+
+void KeyedVertexBatch::set(const QString& key, const GLfloat* vertices) {
+    int slot = _slotByKey.value(key, -1);
+    if (slot == -1) {
+        slot = _keyBySlot.size();
+        _slotByKey.insert(key, slot);
+        _keyBySlot.append(key);
+        _vertices.resize(_vertices.size() + _floatsPerSlot);
+    }
+    std::copy(vertices, vertices + _floatsPerSlot, _vertices.begin() + slot * _floatsPerSlot);
+    markDirty(slot);
+}
+
+void KeyedVertexBatch::remove(const QString& key) {
+    const auto it = _slotByKey.constFind(key);
+    if (it == _slotByKey.constEnd()) {
+        return;
+    }
+    const int slot = it.value();
+    _slotByKey.erase(it);
+
+    const int last = _keyBySlot.size() - 1;
+    if (slot != last) {
+        const auto lastBegin = _vertices.constBegin() + last * _floatsPerSlot;
+        std::copy(lastBegin, lastBegin + _floatsPerSlot, _vertices.begin() + slot * _floatsPerSlot);
+        _keyBySlot[slot] = _keyBySlot[last];
+        _slotByKey[_keyBySlot[slot]] = slot;
+        markDirty(slot);
+    }
+    _keyBySlot.removeLast();
+    _vertices.resize(last * _floatsPerSlot);
+}
+
+void KeyedVertexBatch::clear() {
+    _vertices.clear();
+    _slotByKey.clear();
+    _keyBySlot.clear();
+    _dirtyBegin = INT_MAX;
+    _dirtyEnd = 0;
+}
+
+int KeyedVertexBatch::size() const {
+    return _keyBySlot.size();
+}
+
+void KeyedVertexBatch::markDirty(int slot) {
+    _dirtyBegin = qMin(_dirtyBegin, slot);
+    _dirtyEnd = qMax(_dirtyEnd, slot + 1);
+}
+
+void KeyedVertexBatch::upload() {
+    if (!_buffer.isCreated() && !_buffer.create()) {
+        qWarning() << "KeyedVertexBatch: could not create vertex buffer";
+        return;
+    }
+    const int bytes = _vertices.size() * sizeof(GLfloat);
+    const int slotBytes = _floatsPerSlot * sizeof(GLfloat);
+    _dirtyEnd = qMin(_dirtyEnd, _keyBySlot.size());
+
+    _buffer.bind();
+    if (bytes > _allocatedBytes) {
+        // leave room for new keys so that they don't cause a full upload each time
+        _allocatedBytes = bytes + bytes / 4;
+        _buffer.allocate(_allocatedBytes);
+        _buffer.write(0, _vertices.constData(), bytes);
+    } else if (_dirtyBegin < _dirtyEnd) {
+        _buffer.write(
+            _dirtyBegin * slotBytes,
+            _vertices.constData() + _dirtyBegin * _floatsPerSlot,
+            (_dirtyEnd - _dirtyBegin) * slotBytes
+        );
+    }
+    _buffer.release();
+
+    _uploadedSlots = _keyBySlot.size();
+    _dirtyBegin = INT_MAX;
+    _dirtyEnd = 0;
+}
+
+void KeyedVertexBatch::draw() {
+    if (_uploadedSlots == 0) {
+        return;
+    }
+    _buffer.bind();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, 0);
+    glDrawArrays(_mode, 0, _uploadedSlots * _floatsPerSlot / 3);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    _buffer.release();
+}
@@ -0,0 +1,68 @@
+#ifndef VERTEXBATCH_H_
+#define VERTEXBATCH_H_
+
+#include <QtCore>
+#include <QOpenGLBuffer>
+
+/**
+ * Vertices of one primitive type in a vertex buffer object, drawn with a
+ * single glDrawArrays(). Color, line width and point size are GL state and
+ * set by the caller before draw().
+ * upload() and draw() need the GL context to be current.
+ */
+class VertexBatch {
+    public:
+        VertexBatch(GLenum mode, QOpenGLBuffer::UsagePattern usagePattern = QOpenGLBuffer::StaticDraw);
+
+        void clear();
+        void append(double lat, double lon, bool isHigh = false);
+        void append(const QVector<GLfloat>& vertices); // x, y, z
+        // as GL_LINES segments, for batches of mode GL_LINES
+        void appendLineStrip(const QList<QPair<double, double> >& points, bool isClosed = false, bool isHigh = false);
+
+        // sends the appended vertices to the GPU and releases the local copy
+        void upload();
+        void draw();
+        int vertexCount() const;
+
+        // the segments of a line strip or loop as pairs of x, y, z vertices
+        static QVector<GLfloat> lineVertices(const QList<QPair<double, double> >& points, bool isClosed, bool isHigh);
+    private:
+        GLenum _mode;
+        QOpenGLBuffer _buffer;
+        QVector<GLfloat> _vertices;
+        int _uploadedCount = 0;
+};
+
+/**
+ * Streamed vertex buffer where every key (e.g. a callsign) owns a slot of
+ * verticesPerKey vertices. upload() only writes the range of slots that
+ * changed since the last upload, so updating a few keys does not resend
+ * the whole buffer. Removing a key moves the last slot into its place.
+ */
+class KeyedVertexBatch {
+    public:
+        KeyedVertexBatch(GLenum mode, int verticesPerKey);
+
+        // vertices: verticesPerKey * (x, y, z)
+        void set(const QString& key, const GLfloat* vertices);
+        void remove(const QString& key);
+        void clear();
+        int size() const;
+
+        void upload();
+        void draw();
+    private:
+        void markDirty(int slot);
+
+        GLenum _mode;
+        int _floatsPerSlot;
+        QOpenGLBuffer _buffer;
+        QVector<GLfloat> _vertices;
+        QHash<QString, int> _slotByKey;
+        QVector<QString> _keyBySlot;
+        int _dirtyBegin = INT_MAX, _dirtyEnd = 0; // slots
+        int _allocatedBytes = 0, _uploadedSlots = 0;
+};
+
+#endif /*VERTEXBATCH_H_*/
@@ -3,33 +3,6 @@
 #include "Airac.h"
 #include "NavData.h"
 
-Waypoint::Waypoint(const QStringList& fields)
-    : MapObject() {
-    if (fields.size() != 6) {
-        QMessageLogger("earth_fix.dat", 0, QT_MESSAGELOG_FUNC).critical()
-            << fields << ": Expected 6 fields";
-        return;
-    }
-
-    bool ok;
-
-    lat = fields[0].toDouble(&ok);
-    if (!ok) {
-        QMessageLogger("earth_fix.dat", 0, QT_MESSAGELOG_FUNC).critical()
-            << fields << ": unable to parse lat";
-        return;
-    }
-    lon = fields[1].toDouble(&ok);
-    if (!ok) {
-        QMessageLogger("earth_fix.dat", 0, QT_MESSAGELOG_FUNC).critical()
-            << fields << ": unable to parse lon";
-        return;
-    }
-    id = fields[2];
-
-    regionCode = fields[4];
-}
-
 Waypoint::Waypoint(const QString& id, const double lat, const double lon)
     : MapObject() {
     this->id = id;
@@ -44,9 +17,11 @@ QString Waypoint::mapLabel() const {
 }
 
 QStringList Waypoint::mapLabelSecondaryLinesHovered() const {
-    return {
-        // airwaysString().split("\n")
-    };
+    const QString airways = airwaysString();
+    if (airways.isEmpty()) {
+        return {};
+    }
+    return airways.split("\n");
 }
 
 QString Waypoint::toolTip() const {
@@ -67,12 +42,8 @@ const QString Waypoint::airwaysString() const {
         return { };
     }
 
-    foreach (const auto &awyList, airac->airways) {
-        foreach (const auto &a, awyList) {
-            if (a->waypoints().contains((Waypoint*) this)) {
-                ret << a->name;
-            }
-        }
+    foreach (const auto a, airac->airwaysOf(this)) {
+        ret << a->name;
     }
 
     return ret.join("\n");
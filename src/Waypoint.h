@@ -9,7 +9,6 @@ class Waypoint
     : public MapObject {
     public:
         Waypoint() {}
-        Waypoint(const QStringList& stringList);
         Waypoint(const QString& id, const double lat, const double lon);
         virtual ~Waypoint();
 
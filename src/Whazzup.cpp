@@ -1,11 +1,16 @@
 #include "Whazzup.h"
 
 #include "Client.h"
+#include "Controller.h"
 #include "GuiMessage.h"
 #include "Net.h"
+#include "Pilot.h"
+#include "RouteCache.h"
 #include "Settings.h"
 #include "dialogs/Window.h"
 
+#include <QtConcurrent>
+
 Whazzup* whazzupInstance = 0;
 
 Whazzup* Whazzup::instance() {
@@ -23,6 +28,16 @@ Whazzup::Whazzup()
     connect(_bookingsTimer, &QTimer::timeout, this, &Whazzup::downloadBookings);
 
     connect(this, &Whazzup::needBookings, this, &Whazzup::downloadBookings);
+
+    // one worker keeps updates in order
+    _processingPool.setMaxThreadCount(1);
+    qRegisterMetaType<ProcessedWhazzup*>();
+    connect(this, &Whazzup::whazzupProcessed, this, &Whazzup::applyProcessedWhazzup, Qt::QueuedConnection);
+
+    // only the latest warp step matters, see predict()
+    _predictionPool.setMaxThreadCount(1);
+    qRegisterMetaType<PredictedWhazzup*>();
+    connect(this, &Whazzup::whazzupPredicted, this, &Whazzup::applyPredictedWhazzup, Qt::QueuedConnection);
 }
 
 Whazzup::~Whazzup() {
@@ -41,6 +56,10 @@ Whazzup::~Whazzup() {
     if (_replyBookings != 0) {
         delete _replyBookings;
     }
+    _processingPool.waitForDone();
+    _predictionPool.clear();
+    _predictionPool.waitForDone();
+    qDeleteAll(_archives);
 }
 
 void Whazzup::setStatusLocation(const QString& statusLocation) {
@@ -204,8 +223,79 @@ void Whazzup::processWhazzup() {
     }
     GuiMessages::progress("whazzupProcess", "Processing Whazzup...");
 
-    QByteArray* bytes = new QByteArray(_replyWhazzup->readAll());
-    WhazzupData newWhazzupData(bytes, WhazzupData::WHAZZUP);
+    const QByteArray bytes = _replyWhazzup->readAll();
+    WhazzupArchive* archive = Settings::saveWhazzupData()? this->archive(): 0;
+    // QSettings is not read off the GUI thread
+    const int downloadIntervalSec = Settings::downloadInterval();
+    const AirportActivity::Filter activityFilter = AirportActivity::Filter::fromSettings();
+    QThread* guiThread = thread();
+    QtConcurrent::run(
+        &_processingPool,
+        [this, bytes, downloadIntervalSec, activityFilter, archive, guiThread]() {
+            emit whazzupProcessed(processWhazzupBytes(bytes, downloadIntervalSec, activityFilter, archive, guiThread));
+        }
+    );
+}
+
+void Whazzup::fromArchive(const QDateTime& whazzupTime) {
+    qDebug() << whazzupTime;
+    GuiMessages::progress("whazzupProcess", "Processing Whazzup...");
+
+    WhazzupArchive* archive = this->archive();
+    const int downloadIntervalSec = Settings::downloadInterval();
+    const AirportActivity::Filter activityFilter = AirportActivity::Filter::fromSettings();
+    QThread* guiThread = thread();
+    QtConcurrent::run(
+        &_processingPool,
+        [this, archive, whazzupTime, downloadIntervalSec, activityFilter, guiThread]() {
+            emit whazzupProcessed(
+                processWhazzupBytes(archive->json(whazzupTime), downloadIntervalSec, activityFilter, 0, guiThread)
+            );
+        }
+    );
+}
+
+// runs on the worker thread: parse -> airport activity -> archive
+ProcessedWhazzup* Whazzup::processWhazzupBytes(
+    const QByteArray& bytes, int downloadIntervalSec, const AirportActivity::Filter& activityFilter,
+    WhazzupArchive* archive, QThread* targetThread
+) {
+    // clients look up airports, sectors and airlines while parsing
+    QReadLocker navDataLocker(NavData::instance()->reloadLock());
+    ProcessedWhazzup* processed = new ProcessedWhazzup();
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray parseBytes(bytes);
+    processed->data = new WhazzupData(&parseBytes, WhazzupData::WHAZZUP, downloadIntervalSec);
+    // clients are QObjects and will be used and deleted by the GUI thread
+    foreach (Pilot* p, processed->data->allPilots()) {
+        p->moveToThread(targetThread);
+    }
+    foreach (Controller* c, processed->data->controllers) {
+        c->moveToThread(targetThread);
+    }
+    processed->timings.whazzupTime = processed->data->whazzupTime;
+    processed->timings.parseMs = timer.restart();
+
+    if (!processed->data->isNull()) {
+        processed->airportActivity = NavData::instance()->airportActivity(*processed->data, activityFilter);
+        processed->timings.airportActivityMs = timer.restart();
+
+        if (archive != 0 && !archive->contains(processed->data->whazzupTime)) {
+            archive->append(processed->data->whazzupTime, bytes);
+            processed->timings.archiveMs = timer.restart();
+        }
+    }
+
+    processed->sinceFinished.start();
+    return processed;
+}
+
+void Whazzup::applyProcessedWhazzup(ProcessedWhazzup* processed) {
+    WhazzupUpdateTimings &timings = processed->timings;
+    timings.queuedMs = processed->sinceFinished.elapsed();
+    const WhazzupData &newWhazzupData = *processed->data;
 
     if (!newWhazzupData.isNull()) {
         if (
@@ -216,24 +306,32 @@ void Whazzup::processWhazzup() {
         }
 
         if (newWhazzupData.whazzupTime != _data.whazzupTime) {
-            _data.updateFrom(newWhazzupData);
+            QElapsedTimer timer;
+            timer.start();
+            _predictionPool.waitForDone();
+            _lastDelta = _data.updateFrom(newWhazzupData);
+            if (predictedTime.isValid()) {
+                // the prediction gets recalculated from the new data later
+                _lastDelta = WhazzupDelta();
+            }
+            _airportActivity = processed->airportActivity;
+            timings.updateFromMs = timer.restart();
             qDebug() << "Whazzup updated from timestamp" << _data.whazzupTime;
             emit newData(true);
-
-            if (Settings::saveWhazzupData()) {
-                // write out Whazzup to a file
-                QFile out(Settings::dataDirectory(
-                        QString("downloaded/%1_%2.whazzup")
-                        .arg(Settings::downloadNetwork())
-                        .arg(_data.whazzupTime.toString("yyyyMMdd-HHmmss"))
-                ));
-                if (!out.exists() && out.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                    qDebug() << "Writing Whazzup to" << out.fileName();
-                    out.write(bytes->constData());
-                    out.close();
-                } else {
-                    qWarning() << "Could not write Whazzup to disk" << out.fileName();
-                }
+            timings.notifyMs = timer.elapsed();
+
+            qDebug() << "update stages [ms]: parse" << timings.parseMs
+                     << "airportActivity" << timings.airportActivityMs
+                     << "archive" << timings.archiveMs
+                     << "queued" << timings.queuedMs
+                     << "updateFrom" << timings.updateFromMs
+                     << "notify" << timings.notifyMs
+                     << "- route cache" << RouteCache::instance()->size() << "routes,"
+                     << RouteCache::instance()->hits() << "hits"
+                     << RouteCache::instance()->misses() << "misses";
+            _updateTimings.append(timings);
+            while (_updateTimings.size() > 50) {
+                _updateTimings.removeFirst();
             }
         } else {
             GuiMessages::message(
@@ -242,7 +340,14 @@ void Whazzup::processWhazzup() {
             );
         }
     }
+    delete processed->data;
+    delete processed;
+
+    scheduleNextDownload();
+    GuiMessages::remove("whazzupProcess");
+}
 
+void Whazzup::scheduleNextDownload() {
     if (Settings::downloadPeriodically()) {
         const int serverNextUpdateInSec = QDateTime::currentDateTimeUtc().secsTo(_data.updateEarliest);
         if (
@@ -256,8 +361,6 @@ void Whazzup::processWhazzup() {
             _downloadTimer->start(Settings::downloadInterval() * 1000);
         }
     }
-
-    GuiMessages::remove("whazzupProcess");
 }
 
 void Whazzup::downloadBookings() {
@@ -324,7 +427,11 @@ void Whazzup::processBookings() {
 
         if (newBookingsData.bookingsTime != _data.bookingsTime) {
             qDebug() << "will call updateFrom()";
-            _data.updateFrom(newBookingsData);
+            _predictionPool.waitForDone();
+            _lastDelta = _data.updateFrom(newBookingsData);
+            if (predictedTime.isValid()) {
+                _lastDelta = WhazzupDelta();
+            }
             qDebug() << "Bookings updated from timestamp"
                      << _data.bookingsTime;
 
@@ -380,42 +487,113 @@ void Whazzup::setPredictedTime(QDateTime predictedTime) {
         if (Settings::downloadBookings() && !_data.bookingsTime.isValid()) {
             emit needBookings();
         }
-        if (predictedTime == _data.whazzupTime) {
-            qDebug() << "predictedTime == data.whazzupTime"
+        if (!predictedTime.isValid() || predictedTime == _data.whazzupTime) {
+            qDebug() << "predictedTime invalid or == data.whazzupTime"
                      << "(no need to predict, we have it already :) )";
-            _predictedData = _data;
+            // results of a running prediction are dropped in applyPredictedWhazzup()
+            _predictionPool.clear();
+            WhazzupWarpTimings timings;
+            timings.predictedTime = predictedTime;
+            QElapsedTimer timer;
+            timer.start();
+            if (predictedTime.isValid()) {
+                _predictedData = _data;
+            }
+            _lastDelta = WhazzupDelta();
+            timings.updateFromMs = timer.elapsed();
+            notifyWarped(timings);
         } else {
-            _predictedData.updateFrom(WhazzupData(predictedTime, _data)); // or .assignFrom()?
+            predict();
         }
-        GuiMessages::remove("warpProcess");
-        emit newData(true);
     }
 }
 
-QList <QPair <QDateTime, QString> > Whazzup::downloadedWhazzups() const {
-    // Process directory
-    QStringList list = QDir(Settings::dataDirectory("downloaded/")).entryList(
-        QStringList(QString("%1_*.whazzup").arg(Settings::downloadNetwork())),
-        QDir::Files | QDir::Readable
-    ); // getting all *.whazzup
-    list.sort();
-
-    QList <QPair <QDateTime, QString> > returnList;
-    foreach (const QString filename, list) {
-        QRegExp dtRe = QRegExp("\\.*_(\\d{8}-\\d{6})"); // dateTime: 20110301-191050
-        if (dtRe.indexIn(filename) > 0) {
-            QDateTime dt = QDateTime::fromString(dtRe.cap(1), "yyyyMMdd-HHmmss");
-            dt.setTimeSpec(Qt::UTC);
-            returnList.append(
-                QPair<QDateTime, QString>(
-                    dt,
-                    Settings::dataDirectory(
-                        QString("downloaded/%1").
-                        arg(filename)
-                    )
-                )
-            );
+void Whazzup::predict() {
+    // a prediction that did not start yet is outdated
+    _predictionPool.clear();
+    const QDateTime predictedTime = this->predictedTime;
+    const WhazzupData* data = &_data;
+    QThread* guiThread = thread();
+    QtConcurrent::run(
+        &_predictionPool,
+        [this, predictedTime, data, guiThread]() {
+            emit whazzupPredicted(predictWhazzup(predictedTime, *data, guiThread));
         }
+    );
+}
+
+// runs on the prediction thread. The GUI thread only reads data meanwhile.
+PredictedWhazzup* Whazzup::predictWhazzup(const QDateTime& predictedTime, const WhazzupData& data, QThread* targetThread) {
+    // predicted clients look up airports and sectors
+    QReadLocker navDataLocker(NavData::instance()->reloadLock());
+    PredictedWhazzup* predicted = new PredictedWhazzup();
+    predicted->timings.predictedTime = predictedTime;
+    QElapsedTimer timer;
+    timer.start();
+
+    predicted->data = new WhazzupData(predictedTime, data);
+    // clients are QObjects and will be used and deleted by the GUI thread
+    foreach (Pilot* p, predicted->data->allPilots()) {
+        p->moveToThread(targetThread);
+    }
+    foreach (Controller* c, predicted->data->controllers) {
+        c->moveToThread(targetThread);
+    }
+    predicted->timings.predictMs = timer.elapsed();
+
+    predicted->sinceFinished.start();
+    return predicted;
+}
+
+void Whazzup::applyPredictedWhazzup(PredictedWhazzup* predicted) {
+    const WhazzupData &predictedData = *predicted->data;
+    if (predicted->timings.predictedTime != predictedTime) {
+        qDebug() << "dropping prediction for" << predicted->timings.predictedTime << "- warped on to" << predictedTime;
+    } else if (
+        predictedData.predictionBasedOnTime != _data.whazzupTime
+        || predictedData.predictionBasedOnBookingsTime != _data.bookingsTime
+    ) {
+        qDebug() << "new data arrived while predicting" << predictedTime;
+        predict();
+    } else {
+        WhazzupWarpTimings timings = predicted->timings;
+        timings.queuedMs = predicted->sinceFinished.elapsed();
+        QElapsedTimer timer;
+        timer.start();
+        _lastDelta = _predictedData.updateFrom(predictedData); // or .assignFrom()?
+        timings.updateFromMs = timer.elapsed();
+        notifyWarped(timings);
+    }
+    delete predicted->data;
+    delete predicted;
+}
+
+void Whazzup::notifyWarped(WhazzupWarpTimings timings) {
+    timings.clients = whazzupData().pilots.size() + whazzupData().bookedPilots.size()
+        + whazzupData().controllers.size();
+    GuiMessages::remove("warpProcess");
+    QElapsedTimer timer;
+    timer.start();
+    emit newData(true);
+    timings.notifyMs = timer.elapsed();
+
+    qDebug() << "warp stages [ms]: predict" << timings.predictMs
+             << "queued" << timings.queuedMs
+             << "updateFrom" << timings.updateFromMs
+             << "notify" << timings.notifyMs
+             << "-" << timings.clients << "clients";
+    _warpTimings.append(timings);
+    while (_warpTimings.size() > 50) {
+        _warpTimings.removeFirst();
+    }
+}
+
+WhazzupArchive* Whazzup::archive() {
+    const int network = Settings::downloadNetwork();
+    WhazzupArchive* archive = _archives.value(network, 0);
+    if (archive == 0) {
+        archive = new WhazzupArchive(WhazzupArchive::fileNameFor(network));
+        _archives.insert(network, archive);
     }
-    return returnList;
+    return archive;
 }
@@ -1,9 +1,49 @@
 #ifndef WHAZZUP_H_
 #define WHAZZUP_H_
 
+#include "NavData.h"
+#include "WhazzupArchive.h"
 #include "WhazzupData.h"
 
+#include <QElapsedTimer>
 #include <QNetworkReply>
+#include <QThreadPool>
+
+// durations of the stages of one Whazzup update
+struct WhazzupUpdateTimings {
+    QDateTime whazzupTime;
+    // worker thread
+    qint64 parseMs = 0, airportActivityMs = 0, archiveMs = 0;
+    // GUI thread
+    qint64 queuedMs = 0, updateFromMs = 0, notifyMs = 0;
+};
+
+// durations of one warp step (Whazzup::setPredictedTime())
+struct WhazzupWarpTimings {
+    QDateTime predictedTime;
+    int clients = 0;
+    // prediction thread
+    qint64 predictMs = 0;
+    // GUI thread
+    qint64 queuedMs = 0, updateFromMs = 0, notifyMs = 0;
+};
+
+// result of the worker thread pipeline, handed over to the GUI thread
+struct ProcessedWhazzup {
+    WhazzupData* data = 0;
+    AirportActivity airportActivity;
+    WhazzupUpdateTimings timings;
+    QElapsedTimer sinceFinished;
+};
+Q_DECLARE_METATYPE(ProcessedWhazzup*)
+
+// predicted snapshot, handed over to the GUI thread
+struct PredictedWhazzup {
+    WhazzupData* data = 0;
+    WhazzupWarpTimings timings;
+    QElapsedTimer sinceFinished;
+};
+Q_DECLARE_METATYPE(PredictedWhazzup*)
 
 class Whazzup
     : public QObject {
@@ -22,28 +62,67 @@ class Whazzup
         void setPredictedTime(QDateTime predictedTime);
         QString userUrl(const QString& id) const,
         metarUrl(const QString& id) const;
-        QList <QPair <QDateTime, QString> > downloadedWhazzups() const;
+        // downloaded Whazzups of the current network
+        WhazzupArchive* archive();
         QDateTime predictedTime;
+
+        // airport assignments precomputed for realWhazzupData()
+        const AirportActivity* airportActivity() const {
+            return &_airportActivity;
+        }
+        // changes of whazzupData() by the last update
+        const WhazzupDelta& lastDelta() const {
+            return _lastDelta;
+        }
+        const QList<WhazzupUpdateTimings>& updateTimings() const {
+            return _updateTimings;
+        } // most recent last
+        const QList<WhazzupWarpTimings>& warpTimings() const {
+            return _warpTimings;
+        } // most recent last
     signals:
         void newData(bool isNew);
         void whazzupDownloaded();
         void needBookings();
+        void whazzupProcessed(ProcessedWhazzup* processed); // emitted from the worker thread
+        void whazzupPredicted(PredictedWhazzup* predicted); // emitted from the prediction thread
     public slots:
         void downloadJson3();
         void fromFile(QString filename);
+        void fromArchive(const QDateTime& whazzupTime);
         void setStatusLocation(const QString& url);
         void downloadBookings();
     private slots:
         void processStatus();
         void whazzupProgress(qint64 prog, qint64 tot);
         void processWhazzup();
+        void applyProcessedWhazzup(ProcessedWhazzup* processed);
+        void applyPredictedWhazzup(PredictedWhazzup* predicted);
         void bookingsProgress(qint64 prog, qint64 tot);
         void processBookings();
     private:
         Whazzup();
         virtual ~Whazzup();
 
+        static ProcessedWhazzup* processWhazzupBytes(
+            const QByteArray& bytes, int downloadIntervalSec, const AirportActivity::Filter& activityFilter,
+            WhazzupArchive* archive, QThread* targetThread
+        );
+        static PredictedWhazzup* predictWhazzup(
+            const QDateTime& predictedTime, const WhazzupData& data, QThread* targetThread
+        );
+        void predict(); // predictedTime from _data, off the GUI thread
+        void notifyWarped(WhazzupWarpTimings timings);
+        void scheduleNextDownload();
+
         WhazzupData _data, _predictedData;
+        AirportActivity _airportActivity;
+        WhazzupDelta _lastDelta;
+        QList<WhazzupUpdateTimings> _updateTimings;
+        QList<WhazzupWarpTimings> _warpTimings;
+        QThreadPool _processingPool;
+        QThreadPool _predictionPool; // reads _data, so it is drained before _data changes
+        QHash<int, WhazzupArchive*> _archives; // by network, kept while the worker might use them
         QStringList _json3Urls;
         QString _metar0Url, _user0Url;
         QTime _lastDownloadTime;
@@ -0,0 +1,546 @@
+#include "WhazzupArchive.h"
+
+#include "Settings.h"
+
+// msecs, type, payload length
+static const qint64 recordHeaderSize = sizeof(qint64) + sizeof(quint8) + sizeof(quint32);
+
+WhazzupArchive::WhazzupArchive(const QString& fileName)
+    : _fileName(fileName) {}
+
+QString WhazzupArchive::fileName() const {
+    return _fileName;
+}
+
+QString WhazzupArchive::fileNameFor(int network) {
+    return Settings::dataDirectory(QString("downloaded/%1.whazzups").arg(network));
+}
+
+void WhazzupArchive::load() const {
+    if (_isLoaded) {
+        return;
+    }
+    _isLoaded = true;
+    _records.clear();
+    _end = 0;
+
+    QFile file(_fileName);
+    if (!file.exists() || file.size() == 0) {
+        return;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "WhazzupArchive: could not open" << _fileName << file.errorString();
+        _isValid = false;
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(streamVersion);
+
+    quint32 fileMagic, fileFormatVersion;
+    in >> fileMagic >> fileFormatVersion;
+    if (in.status() != QDataStream::Ok || fileMagic != magic || fileFormatVersion != formatVersion) {
+        qWarning() << "WhazzupArchive:" << _fileName << "has an unknown format, not using it";
+        _isValid = false;
+        return;
+    }
+    _end = file.pos();
+
+    while (!in.atEnd()) {
+        const qint64 offset = file.pos();
+        qint64 msecs;
+        quint8 type;
+        quint32 length;
+        in >> msecs >> type >> length;
+        if (
+            in.status() != QDataStream::Ok
+            || offset + recordHeaderSize + length > file.size()
+            || (type != Keyframe && _records.isEmpty())
+            || (!_records.isEmpty() && msecs <= _records.last().msecs)
+        ) {
+            // an interrupted append: the next one overwrites it
+            qWarning() << "WhazzupArchive: ignoring incomplete record at" << offset << "of" << _fileName;
+            break;
+        }
+        file.seek(offset + recordHeaderSize + length);
+        _records.append({ msecs, offset, type == Keyframe? _records.size(): _records.last().keyframe });
+        _end = file.pos();
+    }
+    qDebug() << "WhazzupArchive:" << _records.size() << "snapshots in" << _fileName;
+}
+
+int WhazzupArchive::lowerBound(qint64 msecs) const {
+    return std::lower_bound(
+        _records.constBegin(),
+        _records.constEnd(),
+        msecs,
+        [](const Record& record, qint64 msecs) {
+            return record.msecs < msecs;
+        }
+    ) - _records.constBegin();
+}
+
+QList<QDateTime> WhazzupArchive::times() const {
+    QMutexLocker locker(&_mutex);
+    load();
+    QList<QDateTime> result;
+    result.reserve(_records.size());
+    foreach (const Record& record, _records) {
+        result.append(QDateTime::fromMSecsSinceEpoch(record.msecs, Qt::UTC));
+    }
+    return result;
+}
+
+int WhazzupArchive::size() const {
+    QMutexLocker locker(&_mutex);
+    load();
+    return _records.size();
+}
+
+bool WhazzupArchive::contains(const QDateTime& whazzupTime) const {
+    QMutexLocker locker(&_mutex);
+    load();
+    const qint64 msecs = whazzupTime.toMSecsSinceEpoch();
+    const int i = lowerBound(msecs);
+    return i < _records.size() && _records[i].msecs == msecs;
+}
+
+QDateTime WhazzupArchive::first() const {
+    QMutexLocker locker(&_mutex);
+    load();
+    if (_records.isEmpty()) {
+        return QDateTime();
+    }
+    return QDateTime::fromMSecsSinceEpoch(_records.first().msecs, Qt::UTC);
+}
+
+QDateTime WhazzupArchive::floor(const QDateTime& dateTime) const {
+    QMutexLocker locker(&_mutex);
+    load();
+    if (_records.isEmpty()) {
+        return QDateTime();
+    }
+    const qint64 msecs = dateTime.toMSecsSinceEpoch();
+    int i = lowerBound(msecs);
+    if (i == _records.size() || _records[i].msecs != msecs) {
+        i = qMax(0, i - 1);
+    }
+    return QDateTime::fromMSecsSinceEpoch(_records[i].msecs, Qt::UTC);
+}
+
+QDateTime WhazzupArchive::ceil(const QDateTime& dateTime) const {
+    QMutexLocker locker(&_mutex);
+    load();
+    if (_records.isEmpty()) {
+        return QDateTime();
+    }
+    const int i = qMin(lowerBound(dateTime.toMSecsSinceEpoch()), _records.size() - 1);
+    return QDateTime::fromMSecsSinceEpoch(_records[i].msecs, Qt::UTC);
+}
+
+bool WhazzupArchive::append(const QDateTime& whazzupTime, const QByteArray& json) {
+    QMutexLocker locker(&_mutex);
+    load();
+    if (!_isValid || !whazzupTime.isValid()) {
+        return false;
+    }
+    const qint64 msecs = whazzupTime.toMSecsSinceEpoch();
+    if (!_records.isEmpty() && msecs <= _records.last().msecs) {
+        qDebug() << "WhazzupArchive: not appending" << whazzupTime << "- not newer than the last snapshot";
+        return false;
+    }
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &error);
+    if (!document.isObject()) {
+        qWarning() << "WhazzupArchive: not appending" << whazzupTime << error.errorString();
+        return false;
+    }
+    const QJsonObject snapshot = document.object();
+
+    const bool isKeyframe = _records.isEmpty() || _records.size() - _records.last().keyframe >= keyframeInterval;
+    const QJsonObject payload = isKeyframe? snapshot: delta(stateAt(_records.size() - 1), snapshot);
+    const QByteArray bytes = qCompress(QCborValue(QCborMap::fromJsonObject(payload)).toCbor());
+
+    QFile file(_fileName);
+    QDir().mkpath(QFileInfo(file).absolutePath());
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "WhazzupArchive: could not write" << _fileName << file.errorString();
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(streamVersion);
+    if (_end == 0) {
+        file.resize(0);
+        out << magic << formatVersion;
+        _end = file.pos();
+    } else {
+        file.resize(_end);
+        file.seek(_end);
+    }
+    const qint64 offset = _end;
+    out << msecs << (quint8) (isKeyframe? Keyframe: Delta) << bytes;
+    if (out.status() != QDataStream::Ok || !file.flush()) {
+        qWarning() << "WhazzupArchive: could not write" << _fileName << file.errorString();
+        file.resize(offset);
+        return false;
+    }
+    _end = file.pos();
+    _records.append({ msecs, offset, isKeyframe? _records.size(): _records.last().keyframe });
+    _state = snapshot;
+    _stateIndex = _records.size() - 1;
+    return true;
+}
+
+QByteArray WhazzupArchive::json(const QDateTime& whazzupTime) const {
+    QMutexLocker locker(&_mutex);
+    load();
+    const qint64 msecs = whazzupTime.toMSecsSinceEpoch();
+    const int i = lowerBound(msecs);
+    if (i == _records.size() || _records[i].msecs != msecs) {
+        return QByteArray();
+    }
+    return toJson(stateAt(i));
+}
+
+QByteArray WhazzupArchive::toJson(const QJsonObject& object) {
+    // QJsonObject sorts its keys, but WhazzupData's streaming parser needs
+    // "general" before the clients, as in the feed
+    QStringList keys = object.keys();
+    if (keys.removeOne("general")) {
+        keys.prepend("general");
+    }
+    QByteArray json("{");
+    foreach (const QString& key, keys) {
+        if (json.size() > 1) {
+            json += ',';
+        }
+        // as a one-element array, so scalars and the key get JSON escaping, too
+        const QByteArray keyJson = QJsonDocument(QJsonArray { key }).toJson(QJsonDocument::Compact);
+        const QByteArray valueJson = QJsonDocument(QJsonArray { object.value(key) }).toJson(QJsonDocument::Compact);
+        json += keyJson.mid(1, keyJson.size() - 2) + ':' + valueJson.mid(1, valueJson.size() - 2);
+    }
+    return json + '}';
+}
+
+QJsonObject WhazzupArchive::readRecord(QFile& file, int i) const {
+    file.seek(_records[i].offset);
+    QDataStream in(&file);
+    in.setVersion(streamVersion);
+    qint64 msecs;
+    quint8 type;
+    QByteArray bytes;
+    in >> msecs >> type >> bytes;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "WhazzupArchive: could not read record" << i << "of" << _fileName;
+        return QJsonObject();
+    }
+    return QCborValue::fromCbor(qUncompress(bytes)).toMap().toJsonObject();
+}
+
+QJsonObject WhazzupArchive::stateAt(int i) const {
+    if (i == _stateIndex) {
+        return _state;
+    }
+    QFile file(_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "WhazzupArchive: could not open" << _fileName << file.errorString();
+        return QJsonObject();
+    }
+
+    const int keyframe = _records[i].keyframe;
+    int next = keyframe;
+    QJsonObject state;
+    if (_stateIndex >= keyframe && _stateIndex < i) {
+        // continue from the last decoded snapshot
+        state = _state;
+        next = _stateIndex + 1;
+    }
+    for (; next <= i; next++) {
+        if (next == keyframe) {
+            state = readRecord(file, next);
+        } else {
+            applyDelta(state, readRecord(file, next));
+        }
+    }
+    _state = state;
+    _stateIndex = i;
+    return state;
+}
+
+bool WhazzupArchive::byCallsign(const QJsonArray& array, QHash<QString, QJsonObject>& clients, QStringList& order) {
+    clients.clear();
+    order.clear();
+    foreach (const QJsonValue& value, array) {
+        const QJsonObject client = value.toObject();
+        const QString callsign = client.value("callsign").toString();
+        if (!value.isObject() || callsign.isEmpty() || clients.contains(callsign)) {
+            return false;
+        }
+        clients.insert(callsign, client);
+        order.append(callsign);
+    }
+    return true;
+}
+
+QJsonObject WhazzupArchive::delta(const QJsonObject& from, const QJsonObject& to) {
+    QJsonObject values, arrays;
+    QJsonArray removed;
+    for (auto it = to.constBegin(); it != to.constEnd(); ++it) {
+        const QJsonValue previous = from.value(it.key());
+        if (previous == it.value()) {
+            continue;
+        }
+        if (previous.isArray() && it.value().isArray()) {
+            bool ok;
+            const QJsonObject clientsDelta = arrayDelta(previous.toArray(), it.value().toArray(), &ok);
+            if (ok) {
+                arrays.insert(it.key(), clientsDelta);
+                continue;
+            }
+        }
+        values.insert(it.key(), it.value());
+    }
+    foreach (const QString& key, from.keys()) {
+        if (!to.contains(key)) {
+            removed.append(key);
+        }
+    }
+
+    QJsonObject result;
+    if (!values.isEmpty()) {
+        result.insert("values", values);
+    }
+    if (!arrays.isEmpty()) {
+        result.insert("arrays", arrays);
+    }
+    if (!removed.isEmpty()) {
+        result.insert("removed", removed);
+    }
+    return result;
+}
+
+QJsonObject WhazzupArchive::arrayDelta(const QJsonArray& from, const QJsonArray& to, bool* ok) {
+    QHash<QString, QJsonObject> fromClients, toClients;
+    QStringList fromOrder, toOrder;
+    *ok = byCallsign(from, fromClients, fromOrder) && byCallsign(to, toClients, toOrder);
+    if (!*ok) {
+        return QJsonObject();
+    }
+
+    QJsonArray added, removed;
+    QJsonObject set, unset;
+    // the order applyArrayDelta() will produce without an explicit one
+    QStringList order;
+    foreach (const QString& callsign, fromOrder) {
+        if (toClients.contains(callsign)) {
+            order.append(callsign);
+        } else {
+            removed.append(callsign);
+        }
+    }
+    foreach (const QString& callsign, toOrder) {
+        const QJsonObject client = toClients[callsign];
+        const auto previous = fromClients.constFind(callsign);
+        if (previous == fromClients.constEnd()) {
+            added.append(client);
+            order.append(callsign);
+            continue;
+        }
+        QJsonObject changedFields;
+        QJsonArray unsetFields;
+        for (auto it = client.constBegin(); it != client.constEnd(); ++it) {
+            if (previous->value(it.key()) != it.value()) {
+                changedFields.insert(it.key(), it.value());
+            }
+        }
+        foreach (const QString& key, previous->keys()) {
+            if (!client.contains(key)) {
+                unsetFields.append(key);
+            }
+        }
+        if (!changedFields.isEmpty()) {
+            set.insert(callsign, changedFields);
+        }
+        if (!unsetFields.isEmpty()) {
+            unset.insert(callsign, unsetFields);
+        }
+    }
+
+    QJsonObject result;
+    if (!added.isEmpty()) {
+        result.insert("added", added);
+    }
+    if (!removed.isEmpty()) {
+        result.insert("removed", removed);
+    }
+    if (!set.isEmpty()) {
+        result.insert("set", set);
+    }
+    if (!unset.isEmpty()) {
+        result.insert("unset", unset);
+    }
+    if (order != toOrder) {
+        result.insert("order", QJsonArray::fromStringList(toOrder));
+    }
+    return result;
+}
+
+void WhazzupArchive::applyDelta(QJsonObject& state, const QJsonObject& delta) {
+    const QJsonObject values = delta.value("values").toObject();
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        state.insert(it.key(), it.value());
+    }
+    const QJsonObject arrays = delta.value("arrays").toObject();
+    for (auto it = arrays.constBegin(); it != arrays.constEnd(); ++it) {
+        state.insert(it.key(), applyArrayDelta(state.value(it.key()).toArray(), it.value().toObject()));
+    }
+    foreach (const QJsonValue& key, delta.value("removed").toArray()) {
+        state.remove(key.toString());
+    }
+}
+
+QJsonArray WhazzupArchive::applyArrayDelta(const QJsonArray& array, const QJsonObject& delta) {
+    QHash<QString, QJsonObject> clients;
+    QStringList order;
+    byCallsign(array, clients, order);
+
+    foreach (const QJsonValue& callsign, delta.value("removed").toArray()) {
+        clients.remove(callsign.toString());
+    }
+    QStringList newOrder;
+    foreach (const QString& callsign, order) {
+        if (clients.contains(callsign)) {
+            newOrder.append(callsign);
+        }
+    }
+
+    const QJsonObject set = delta.value("set").toObject();
+    for (auto it = set.constBegin(); it != set.constEnd(); ++it) {
+        QJsonObject& client = clients[it.key()];
+        const QJsonObject fields = it.value().toObject();
+        for (auto field = fields.constBegin(); field != fields.constEnd(); ++field) {
+            client.insert(field.key(), field.value());
+        }
+    }
+    const QJsonObject unset = delta.value("unset").toObject();
+    for (auto it = unset.constBegin(); it != unset.constEnd(); ++it) {
+        QJsonObject& client = clients[it.key()];
+        foreach (const QJsonValue& key, it.value().toArray()) {
+            client.remove(key.toString());
+        }
+    }
+    foreach (const QJsonValue& value, delta.value("added").toArray()) {
+        const QJsonObject client = value.toObject();
+        const QString callsign = client.value("callsign").toString();
+        clients.insert(callsign, client);
+        newOrder.append(callsign);
+    }
+    if (delta.contains("order")) {
+        newOrder.clear();
+        foreach (const QJsonValue& callsign, delta.value("order").toArray()) {
+            newOrder.append(callsign.toString());
+        }
+    }
+
+    QJsonArray result;
+    foreach (const QString& callsign, newOrder) {
+        result.append(clients.value(callsign));
+    }
+    return result;
+}
+
+int WhazzupArchive::migrate(const QString& directory) {
+    QTextStream out(stdout);
+
+    QRegExp fileNameRe("(\\d+)_(\\d{8}-\\d{6})\\.whazzup"); // network, dateTime: 20110301-191050
+    QMap<int, QMap<qint64, QString> > filesByNetwork;
+    QDir dir(directory);
+    foreach (const QString& fileName, dir.entryList({ "*.whazzup" }, QDir::Files | QDir::Readable)) {
+        if (!fileNameRe.exactMatch(fileName)) {
+            continue;
+        }
+        QDateTime dt = QDateTime::fromString(fileNameRe.cap(2), "yyyyMMdd-HHmmss");
+        dt.setTimeSpec(Qt::UTC);
+        filesByNetwork[fileNameRe.cap(1).toInt()].insert(dt.toMSecsSinceEpoch(), dir.filePath(fileName));
+    }
+    if (filesByNetwork.isEmpty()) {
+        out << "no .whazzup files in " << directory << Qt::endl;
+        return 0;
+    }
+
+    int result = 0;
+    for (auto network = filesByNetwork.constBegin(); network != filesByNetwork.constEnd(); ++network) {
+        const QMap<qint64, QString>& files = network.value();
+        const QString fileName = dir.filePath(QString("%1.whazzups").arg(network.key()));
+        const QString migratingFileName = fileName + ".migrating";
+        QFile::remove(migratingFileName);
+        const WhazzupArchive archive(fileName);
+        WhazzupArchive migrated(migratingFileName);
+
+        // files and archived snapshots in time order; an empty path stands for the archive
+        QMap<qint64, QString> sources(files);
+        foreach (const QDateTime& whazzupTime, archive.times()) {
+            sources.insert(whazzupTime.toMSecsSinceEpoch(), QString());
+        }
+        qint64 bytesBefore = QFileInfo(fileName).size();
+        bool isArchiveCopied = true;
+        for (auto it = sources.constBegin(); it != sources.constEnd(); ++it) {
+            const QDateTime whazzupTime = QDateTime::fromMSecsSinceEpoch(it.key(), Qt::UTC);
+            if (it.value().isEmpty()) {
+                if (!migrated.append(whazzupTime, archive.json(whazzupTime))) {
+                    isArchiveCopied = false;
+                    break;
+                }
+                continue;
+            }
+            QFile file(it.value());
+            if (file.open(QIODevice::ReadOnly)) {
+                bytesBefore += file.size();
+                migrated.append(whazzupTime, file.readAll());
+            }
+        }
+        if (!isArchiveCopied) {
+            out << "ERROR: could not copy " << fileName << ", leaving everything as it was" << Qt::endl;
+            QFile::remove(migratingFileName);
+            result = 1;
+            continue;
+        }
+
+        // only files that can be read back get removed
+        QStringList verified;
+        for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+            QFile file(it.value());
+            if (!file.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            const QJsonObject original = QJsonDocument::fromJson(file.readAll()).object();
+            const QByteArray archived = migrated.json(QDateTime::fromMSecsSinceEpoch(it.key(), Qt::UTC));
+            if (!original.isEmpty() && original == QJsonDocument::fromJson(archived).object()) {
+                verified.append(it.value());
+            }
+        }
+
+        const QString oldFileName = fileName + ".old";
+        QFile::remove(oldFileName);
+        if (QFile::exists(fileName) && !QFile::rename(fileName, oldFileName)) {
+            out << "ERROR: could not replace " << fileName << Qt::endl;
+            QFile::remove(migratingFileName);
+            result = 1;
+            continue;
+        }
+        if (!QFile::rename(migratingFileName, fileName)) {
+            out << "ERROR: could not replace " << fileName << Qt::endl;
+            QFile::rename(oldFileName, fileName);
+            result = 1;
+            continue;
+        }
+        QFile::remove(oldFileName);
+        foreach (const QString& path, verified) {
+            QFile::remove(path);
+        }
+
+        out << fileName << ": " << verified.size() << " of " << files.size() << " files migrated, "
+            << migrated.size() << " snapshots, " << bytesBefore / 1024 << "kB -> "
+            << QFileInfo(fileName).size() / 1024 << "kB" << Qt::endl;
+    }
+    return result;
+}
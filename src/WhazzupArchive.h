@@ -0,0 +1,82 @@
+#ifndef WHAZZUPARCHIVE_H_
+#define WHAZZUPARCHIVE_H_
+
+#include <QtCore>
+
+/**
+ * Append-only log of downloaded Whazzup JSON documents of one network in
+ * downloaded/. Every keyframeInterval-th record holds the whole document,
+ * the others only what changed since the previous one: top-level values
+ * and, for arrays of clients, the added, removed and changed fields of each
+ * callsign. Records are stored as CBOR, compressed with qCompress().
+ * The time index is read from the record headers on first use, so finding a
+ * snapshot is a binary search plus decoding the records since its keyframe.
+ * All methods are thread-safe.
+ */
+class WhazzupArchive {
+    public:
+        WhazzupArchive(const QString& fileName);
+
+        QString fileName() const;
+        static QString fileNameFor(int network);
+
+        // snapshot times, oldest first
+        QList<QDateTime> times() const;
+        int size() const;
+        bool contains(const QDateTime& whazzupTime) const;
+        // invalid if empty
+        QDateTime first() const;
+        // last snapshot at or before dateTime, else the first one; invalid if empty
+        QDateTime floor(const QDateTime& dateTime) const;
+        // first snapshot at or after dateTime, else the last one; invalid if empty
+        QDateTime ceil(const QDateTime& dateTime) const;
+
+        // false if json is not a JSON object or not newer than all archived snapshots
+        bool append(const QDateTime& whazzupTime, const QByteArray& json);
+        // the JSON document archived for whazzupTime, empty if there is none
+        QByteArray json(const QDateTime& whazzupTime) const;
+
+        // moves <network>_<yyyyMMdd-HHmmss>.whazzup files of directory into
+        // the archives, removing files only after reading them back
+        static int migrate(const QString& directory);
+    private:
+        enum RecordType : quint8 {
+            Keyframe = 0,
+            Delta = 1
+        };
+        struct Record {
+            qint64 msecs; // whazzupTime
+            qint64 offset;
+            int keyframe; // index of the record to start decoding from
+        };
+
+        static const quint32 formatVersion = 1;
+        static const quint32 magic = 0x51535741; // "QSWA"
+        static const QDataStream::Version streamVersion = QDataStream::Qt_5_15;
+        static const int keyframeInterval = 30;
+
+        void load() const;
+        int lowerBound(qint64 msecs) const;
+        QJsonObject stateAt(int i) const;
+        QJsonObject readRecord(QFile& file, int i) const;
+        // compact JSON with "general" as the first key
+        static QByteArray toJson(const QJsonObject& object);
+
+        static QJsonObject delta(const QJsonObject& from, const QJsonObject& to);
+        static QJsonObject arrayDelta(const QJsonArray& from, const QJsonArray& to, bool* ok);
+        static void applyDelta(QJsonObject& state, const QJsonObject& delta);
+        static QJsonArray applyArrayDelta(const QJsonArray& array, const QJsonObject& delta);
+        // false if not all elements are objects with a unique callsign
+        static bool byCallsign(const QJsonArray& array, QHash<QString, QJsonObject>& clients, QStringList& order);
+
+        QString _fileName;
+        mutable QMutex _mutex;
+        mutable bool _isLoaded = false, _isValid = true;
+        mutable QVector<Record> _records;
+        mutable qint64 _end = 0; // end of the last complete record
+        // last decoded snapshot, so stepping forward only applies one delta
+        mutable int _stateIndex = -1;
+        mutable QJsonObject _state;
+};
+
+#endif /*WHAZZUPARCHIVE_H_*/
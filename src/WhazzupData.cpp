@@ -3,10 +3,15 @@
 #include "Airport.h"
 #include "BookedController.h"
 #include "Controller.h"
+#include "Friends.h"
+#include "JsonPullReader.h"
 #include "NavData.h"
 #include "Pilot.h"
 #include "Sector.h"
 #include "Settings.h"
+#include "src/mustache/Renderer.h"
+
+#include <QtConcurrent>
 
 WhazzupData::WhazzupData()
     : servers(QList<QStringList>()),
@@ -14,13 +19,174 @@ WhazzupData::WhazzupData()
       _dataType(UNIFIED) {}
 
 WhazzupData::WhazzupData(QByteArray* bytes, WhazzupType type)
+    : WhazzupData(bytes, type, Settings::downloadInterval()) {}
+
+WhazzupData::WhazzupData(QByteArray* bytes, WhazzupType type, int downloadIntervalSec)
     : servers(QList<QStringList>()),
       updateEarliest(QDateTime()), whazzupTime(QDateTime()),
       bookingsTime(QDateTime()) {
     qDebug() << type << "[NONE, WHAZZUP, ATCBOOKINGS, UNIFIED]";
     _dataType = type;
-    int reloadInSec = Settings::downloadInterval();
-    QJsonDocument data = QJsonDocument::fromJson(*bytes);
+    int reloadInSec = downloadIntervalSec;
+    if (type == WHAZZUP && useStreamingParser && parseJsonStream(*bytes)) {
+        qDebug() << "parsed" << pilots.size() << "pilots," << controllers.size() << "controllers (streaming)";
+    } else {
+        parseJsonDocument(*bytes, type);
+    }
+    // set the earliest time the server will have new data
+    if (whazzupTime.isValid() && reloadInSec > 0) {
+        updateEarliest = whazzupTime.addSecs(reloadInSec).toUTC();
+    }
+    qDebug() << "-- finished";
+}
+
+bool WhazzupData::useStreamingParser = true;
+
+// pull-parses the vatsim-data feed without building a QJsonDocument.
+// Returns false on malformed or unexpectedly ordered input, leaving this empty.
+bool WhazzupData::parseJsonStream(const QByteArray& bytes) {
+    JsonPullReader reader(bytes);
+    bool generalSeen = false;
+    QLatin1String key;
+    if (!reader.beginObject()) {
+        return false;
+    }
+    while (reader.nextKey(key)) {
+        if (key == QLatin1String("general")) {
+            generalSeen = true;
+            if (reader.beginObject()) {
+                while (reader.nextKey(key)) {
+                    if (key == QLatin1String("update_timestamp")) {
+                        whazzupTime = QDateTime::fromString(reader.readString(), Qt::ISODate);
+                    } else {
+                        reader.skipValue();
+                    }
+                }
+            }
+            if (!whazzupTime.isValid()) {
+                // Assume it's the current time
+                whazzupTime = QDateTime::currentDateTime();
+            }
+        } else if (
+            key == QLatin1String("pilots") || key == QLatin1String("prefiles")
+            || key == QLatin1String("controllers") || key == QLatin1String("atis")
+        ) {
+            // clients need whazzupTime which the feed provides up front
+            if (!generalSeen) {
+                break;
+            }
+            const bool isPilots = key == QLatin1String("pilots");
+            const bool isPrefiles = key == QLatin1String("prefiles");
+            if (reader.beginArray()) {
+                while (reader.nextElement()) {
+                    if (isPilots || isPrefiles) {
+                        Pilot* p = new Pilot(reader, this);
+                        if (isPilots) {
+                            pilots[p->callsign] = p;
+                        } else {
+                            bookedPilots[p->callsign] = p;
+                        }
+                    } else {
+                        Controller* c = new Controller(reader, this);
+                        controllers[c->callsign] = c;
+                    }
+                }
+            }
+        } else if (key == QLatin1String("servers")) {
+            if (reader.beginArray()) {
+                while (reader.nextElement()) {
+                    QStringList server;
+                    server << "" << "" << "" << "" << "";
+                    int fieldsFound = 0;
+                    if (reader.beginObject()) {
+                        while (reader.nextKey(key)) {
+                            const int i = key == QLatin1String("ident")? 0
+                                : key == QLatin1String("hostname_or_ip")? 1
+                                : key == QLatin1String("location")? 2
+                                : key == QLatin1String("name")? 3
+                                : key == QLatin1String("clients_connection_allowed")? 4
+                                : -1;
+                            if (i == 4) {
+                                // numeric, the QJsonDocument path ends up with an empty string, too
+                                if (reader.peek() == JsonPullReader::Number) {
+                                    fieldsFound++;
+                                }
+                                reader.skipValue();
+                            } else if (i >= 0) {
+                                if (reader.peek() == JsonPullReader::String) {
+                                    fieldsFound++;
+                                }
+                                server[i] = reader.readString();
+                            } else {
+                                reader.skipValue();
+                            }
+                        }
+                    }
+                    if (fieldsFound == 5) {
+                        servers += server;
+                    }
+                }
+            }
+        } else if (
+            key == QLatin1String("ratings") || key == QLatin1String("pilot_ratings")
+            || key == QLatin1String("military_ratings")
+        ) {
+            QHash<int, QString>* target = key == QLatin1String("ratings")? &ratings
+                : key == QLatin1String("pilot_ratings")? &pilotRatings
+                : &militaryRatings;
+            const QLatin1String nameKey(target == &ratings? "short": "short_name");
+            if (reader.beginArray()) {
+                while (reader.nextElement()) {
+                    int id = 0;
+                    QString name;
+                    if (reader.beginObject()) {
+                        while (reader.nextKey(key)) {
+                            if (key == QLatin1String("id")) {
+                                id = reader.readInt();
+                            } else if (key == nameKey) {
+                                name = reader.readString();
+                            } else {
+                                reader.skipValue();
+                            }
+                        }
+                    }
+                    target->insert(id, name);
+                }
+            }
+        } else {
+            reader.skipValue();
+        }
+    }
+
+    if (!generalSeen || reader.hasError()) {
+        qDebug() << "streaming parse failed:" << reader.errorString();
+        // their destructors tear down the shared Renderer context, which is
+        // only safe on the GUI thread
+        QThread* guiThread = QCoreApplication::instance()->thread();
+        foreach (Pilot* p, pilots.values() + bookedPilots.values()) {
+            p->moveToThread(guiThread);
+            p->deleteLater();
+        }
+        pilots.clear();
+        bookedPilots.clear();
+        foreach (Controller* c, controllers) {
+            c->moveToThread(guiThread);
+            c->deleteLater();
+        }
+        controllers.clear();
+        servers.clear();
+        ratings.clear();
+        pilotRatings.clear();
+        militaryRatings.clear();
+        whazzupTime = QDateTime();
+        return false;
+    }
+    qDebug() << "ratings:" << ratings << "pilotRatings:" << pilotRatings << "militaryRatings:" << militaryRatings;
+    return true;
+}
+
+void WhazzupData::parseJsonDocument(const QByteArray& bytes, WhazzupType type) {
+    QJsonDocument data = QJsonDocument::fromJson(bytes);
     if (data.isNull()) {
         qDebug() << "Couldn't parse JSON";
     } else if (type == WHAZZUP) {
@@ -129,16 +295,12 @@ WhazzupData::WhazzupData(QByteArray* bytes, WhazzupType type)
             BookedController* bc = new BookedController(bookedControllerJson);
             bookedControllers.append(bc);
         }
+        bookingIndex.build(bookedControllers);
         bookingsTime = QDateTime::currentDateTime();
     } else {
         // Try again in 15 seconds
         updateEarliest = QDateTime::currentDateTime().addSecs(15);
     }
-    // set the earliest time the server will have new data
-    if (whazzupTime.isValid() && reloadInSec > 0) {
-        updateEarliest = whazzupTime.addSecs(reloadInSec).toUTC();
-    }
-    qDebug() << "-- finished";
 }
 
 // faking WhazzupData based on valid data and a predictTime
@@ -165,34 +327,33 @@ WhazzupData::WhazzupData(const QDateTime predictTime, const WhazzupData &data)
 
     _dataType = data._dataType;
     // so now lets fake some controllers
-    foreach (const BookedController* bc, data.bookedControllers) {
-        // only ones booked for the selected time
-        if (bc->starts() <= predictTime && bc->ends() >= predictTime) {
-            QJsonObject controllerObject;
-
-            controllerObject["callsign"] = bc->callsign;
-            controllerObject["name"] = bc->realName();
-            controllerObject["cid"] = bc->userId.toInt();
-            controllerObject["facility"] = bc->facilityType;
-            controllerObject["rating"] = -99; // strictly out of API range
-            controllerObject["frequency"] = "?"; // cannot be empty
-
-            QJsonArray atisLines;
-            atisLines.append(
-                QString("BOOKED from %1, online until %2")
-                .arg(bc->starts().toString("HHmm'z'"), bc->ends().toString("HHmm'z'"))
-            );
-            atisLines.append(bc->bookingInfoStr);
-            controllerObject["text_atis"] = atisLines;
+    // only ones booked for the selected time
+    foreach (const int row, data.bookingIndex.at(predictTime)) {
+        const BookedController* bc = data.bookedControllers[row];
+        QJsonObject controllerObject;
+
+        controllerObject["callsign"] = bc->callsign;
+        controllerObject["name"] = bc->realName();
+        controllerObject["cid"] = bc->userId.toInt();
+        controllerObject["facility"] = bc->facilityType;
+        controllerObject["rating"] = -99; // strictly out of API range
+        controllerObject["frequency"] = "?"; // cannot be empty
+
+        QJsonArray atisLines;
+        atisLines.append(
+            QString("BOOKED from %1, online until %2")
+            .arg(bc->starts().toString("HHmm'z'"), bc->ends().toString("HHmm'z'"))
+        );
+        atisLines.append(bc->bookingInfoStr);
+        controllerObject["text_atis"] = atisLines;
 
-            controllerObject["logon_time"] = bc->timeConnected.toString(Qt::ISODate);
+        controllerObject["logon_time"] = bc->timeConnected.toString(Qt::ISODate);
 
-            controllerObject["server"] = "BOOKED SESSION";
+        controllerObject["server"] = "BOOKED SESSION";
 
-            controllerObject["visual_range"] = 0;
+        controllerObject["visual_range"] = 0;
 
-            controllers[bc->callsign] = new Controller(controllerObject, this);
-        }
+        controllers[bc->callsign] = new Controller(controllerObject, this);
     }
     qDebug() << "added" << controllers.size() << "bookedControllers as fake controllers";
 
@@ -212,89 +373,124 @@ WhazzupData::WhazzupData(const QDateTime predictTime, const WhazzupData &data)
         }
     }
 
-    QDateTime startTime, endTime = QDateTime();
-    double startLat, startLon, endLat, endLon = 0.;
-    int altitude = 0;
-
+    // the prediction of a pilot only reads its source pilot: spread them over all cores
+    struct Prediction {
+        const Pilot* source;
+        Pilot* pilot;
+        bool isBooked;
+    };
+    QVector<Prediction> predictions;
+    predictions.reserve(data.pilots.size() + data.bookedPilots.size());
     foreach (const Pilot* p, data.allPilots()) {
-        //if (p == 0) continue;
-        if (!p->eta().isValid()) {
-            continue; // no ETA, no prediction...
-        }
-        if (!p->etd().isValid() && predictTime < predictionBasedOnTime) {
-            continue; // no ETD, difficult prediction. Before the whazzupTime, no prediction...
-        }
-        if (p->destAirport() == 0) {
-            continue; // sorry, no magic available yet. Just let him fly the last heading until etaPlan()?
-                      // Does not make
-                      // sense
-        }
-        if (p->etd() > predictTime || p->eta() < predictTime) {
-            if (p->flightStatus() == Pilot::PREFILED && p->etd() > predictTime) { // we want prefiled before
-                                                                                  // their
-                //departure as in non-Warped view
-                Pilot* np = new Pilot(*p);
-                np->whazzupTime = QDateTime(predictTime);
-                bookedPilots[np->callsign] = np; // just copy him over
-                continue;
+        predictions.append({ p, 0, false });
+    }
+    QThread* targetThread = QThread::currentThread();
+    const QDateTime basedOnTime = predictionBasedOnTime;
+    QtConcurrent::blockingMap(
+        predictions,
+        [predictTime, basedOnTime, targetThread](Prediction& prediction) {
+            prediction.pilot = predictedPilot(prediction.source, predictTime, basedOnTime, &prediction.isBooked);
+            if (prediction.pilot != 0) {
+                // clients are QObjects and will be used and deleted by the calling thread
+                prediction.pilot->moveToThread(targetThread);
             }
-            continue; // not on the map on the selected time
         }
-        if (p->flightStatus() == Pilot::PREFILED) {
-            // if we dont know where a prefiled comes from, no magic available
-            if (p->depAirport() == 0 || p->destAirport() == 0) {
-                continue;
-            }
-
-            startTime = p->etd();
-            startLat = p->depAirport()->lat;
-            startLon = p->depAirport()->lon;
+    );
 
-            endTime = p->eta();
-            endLat = p->destAirport()->lat;
-            endLon = p->destAirport()->lon;
-        } else {
-            startTime = data.whazzupTime;
-            startLat = p->lat;
-            startLon = p->lon;
-
-            endTime = p->eta();
-            endLat = p->destAirport()->lat;
-            endLon = p->destAirport()->lon;
+    foreach (const Prediction &prediction, predictions) {
+        if (prediction.pilot == 0) {
+            continue;
         }
-        // altitude
-        if (p->planAlt.toInt() != 0) {
-            altitude = p->defuckPlanAlt(p->planAlt);
+        if (prediction.isBooked) {
+            bookedPilots[prediction.pilot->callsign] = prediction.pilot;
+        } else {
+            pilots[prediction.pilot->callsign] = prediction.pilot;
         }
+    }
+    qDebug() << "-- finished";
+}
 
-        // position
-        double fraction = (double) startTime.secsTo(predictTime)
-            / startTime.secsTo(endTime);
-        QPair<double, double> pos = NavData::greatCircleFraction(
-            startLat, startLon,
-            endLat, endLon, fraction
-        );
+// the pilot p at predictTime, 0 if not on the map then. Runs on worker threads.
+Pilot* WhazzupData::predictedPilot(const Pilot* p, const QDateTime &predictTime, const QDateTime &basedOnTime, bool* isBooked) {
+    *isBooked = false;
+    QDateTime startTime, endTime = QDateTime();
+    double startLat, startLon, endLat, endLon = 0.;
+    int altitude = 0;
 
-        double dist = NavData::distance(startLat, startLon, endLat, endLon);
-        double enrouteHrs = ((double) startTime.secsTo(endTime)) / 3600.0;
-        if (qFuzzyIsNull(enrouteHrs)) {
-            enrouteHrs = 0.1;
+    if (!p->eta().isValid()) {
+        return 0; // no ETA, no prediction...
+    }
+    if (!p->etd().isValid() && predictTime < basedOnTime) {
+        return 0; // no ETD, difficult prediction. Before the whazzupTime, no prediction...
+    }
+    if (p->destAirport() == 0) {
+        return 0; // sorry, no magic available yet. Just let him fly the last heading until etaPlan()?
+                  // Does not make
+                  // sense
+    }
+    if (p->etd() > predictTime || p->eta() < predictTime) {
+        if (p->flightStatus() == Pilot::PREFILED && p->etd() > predictTime) { // we want prefiled before
+                                                                              // their
+            //departure as in non-Warped view
+            Pilot* np = new Pilot(*p);
+            np->whazzupTime = QDateTime(predictTime);
+            *isBooked = true; // just copy him over
+            return np;
+        }
+        return 0; // not on the map on the selected time
+    }
+    if (p->flightStatus() == Pilot::PREFILED) {
+        // if we dont know where a prefiled comes from, no magic available
+        if (p->depAirport() == 0 || p->destAirport() == 0) {
+            return 0;
         }
-        double groundspeed = dist / enrouteHrs;
-        double trueHeading = NavData::courseTo(pos.first, pos.second, endLat, endLon);
 
-        // create Pilot instance and assign values
-        Pilot* np = new Pilot(*p);
-        np->whazzupTime = QDateTime(predictTime);
-        np->lat = pos.first;
-        np->lon = pos.second;
-        np->altitude = altitude;
-        np->trueHeading = trueHeading;
-        np->groundspeed = (int) groundspeed;
+        startTime = p->etd();
+        startLat = p->depAirport()->lat;
+        startLon = p->depAirport()->lon;
 
-        pilots[np->callsign] = np;
-    }
-    qDebug() << "-- finished";
+        endTime = p->eta();
+        endLat = p->destAirport()->lat;
+        endLon = p->destAirport()->lon;
+    } else {
+        startTime = basedOnTime;
+        startLat = p->lat;
+        startLon = p->lon;
+
+        endTime = p->eta();
+        endLat = p->destAirport()->lat;
+        endLon = p->destAirport()->lon;
+    }
+    // altitude
+    if (p->planAlt.toInt() != 0) {
+        altitude = p->defuckPlanAlt(p->planAlt);
+    }
+
+    // position
+    double fraction = (double) startTime.secsTo(predictTime)
+        / startTime.secsTo(endTime);
+    QPair<double, double> pos = NavData::greatCircleFraction(
+        startLat, startLon,
+        endLat, endLon, fraction
+    );
+
+    double dist = NavData::distance(startLat, startLon, endLat, endLon);
+    double enrouteHrs = ((double) startTime.secsTo(endTime)) / 3600.0;
+    if (qFuzzyIsNull(enrouteHrs)) {
+        enrouteHrs = 0.1;
+    }
+    double groundspeed = dist / enrouteHrs;
+    double trueHeading = NavData::courseTo(pos.first, pos.second, endLat, endLon);
+
+    // create Pilot instance and assign values
+    Pilot* np = new Pilot(*p);
+    np->whazzupTime = QDateTime(predictTime);
+    np->lat = pos.first;
+    np->lon = pos.second;
+    np->altitude = altitude;
+    np->trueHeading = trueHeading;
+    np->groundspeed = (int) groundspeed;
+    return np;
 }
 
 WhazzupData::WhazzupData(const WhazzupData &data) {
@@ -321,6 +517,7 @@ WhazzupData::~WhazzupData() {
         delete bc;
     }
     bookedControllers.clear();
+    bookingIndex.clear();
 }
 
 WhazzupData &WhazzupData::operator=(const WhazzupData &data) {
@@ -381,6 +578,7 @@ void WhazzupData::assignFrom(const WhazzupData &data) {
         foreach (const BookedController* bc, data.bookedControllers) {
             bookedControllers.append(new BookedController(*bc));
         }
+        bookingIndex = data.bookingIndex;
 
         bookingsTime = QDateTime(data.bookingsTime);
         predictionBasedOnBookingsTime = QDateTime(data.predictionBasedOnBookingsTime);
@@ -388,28 +586,37 @@ void WhazzupData::assignFrom(const WhazzupData &data) {
     qDebug() << "-- finished";
 }
 
-void WhazzupData::updatePilotsFrom(const WhazzupData &data) {
+void WhazzupData::updatePilotsFrom(const WhazzupData &data, WhazzupDelta &delta) {
     qDebug();
     foreach (const QString s, pilots.keys()) { // remove pilots that are no longer there
         if (!data.pilots.contains(s)) {
             delete pilots.value(s);
             pilots.remove(s);
+            delta.pilotsRemoved.insert(s);
         }
     }
     foreach (const QString s, data.pilots.keys()) {
-        if (!pilots.contains(s)) { // new pilots
+        Pilot* p = pilots.value(s, 0);
+        if (p == 0) { // new pilots
             // create a new copy of new pilot
-            Pilot* p = new Pilot(*data.pilots[s]);
-            pilots[s] = p;
-        } else { // existing pilots: data saved in the object needs to be transferred
-            data.pilots[s]->showRoute = pilots[s]->showRoute;
-            data.pilots[s]->routeWaypointsCache = pilots[s]->routeWaypointsCache;
-            data.pilots[s]->routeWaypointsPlanDepCache = pilots[s]->routeWaypointsPlanDepCache;
-            data.pilots[s]->routeWaypointsPlanDestCache = pilots[s]->routeWaypointsPlanDestCache;
-            data.pilots[s]->routeWaypointsPlanRouteCache = pilots[s]->routeWaypointsPlanRouteCache;
-            data.pilots[s]->checkStatus();
-
-            *pilots[s] = *data.pilots[s];
+            pilots[s] = new Pilot(*data.pilots[s]);
+            delta.pilotsAdded.insert(s);
+        } else if (!p->isFlightPlanEqual(*data.pilots[s])) {
+            p->assignKeepingRoute(*data.pilots[s]);
+            MustacheQs::Renderer::invalidate(p);
+            delta.pilotsFlightPlanChanged.insert(s);
+            delta.pilotsMoved.insert(s);
+            delta.pilotsChanged.insert(s);
+        } else {
+            // also takes e.g. the rating when the position did not change
+            bool isMoved = false;
+            if (p->updateStateFrom(*data.pilots[s], &isMoved)) {
+                if (isMoved) {
+                    delta.pilotsMoved.insert(s);
+                }
+                delta.pilotsChanged.insert(s);
+                MustacheQs::Renderer::invalidate(p);
+            }
         }
     }
 
@@ -417,35 +624,51 @@ void WhazzupData::updatePilotsFrom(const WhazzupData &data) {
         if (!data.bookedPilots.contains(s)) {
             delete bookedPilots.value(s);
             bookedPilots.remove(s);
+            delta.bookedPilotsRemoved.insert(s);
         }
     }
     foreach (const QString s, data.bookedPilots.keys()) {
-        if (!bookedPilots.contains(s)) { // new pilots
-            Pilot* p = new Pilot(*data.bookedPilots[s]);
-            bookedPilots[s] = p;
-        } else { // existing pilots
-            *bookedPilots[s] = *data.bookedPilots[s];
+        Pilot* p = bookedPilots.value(s, 0);
+        if (p == 0) { // new pilots
+            bookedPilots[s] = new Pilot(*data.bookedPilots[s]);
+            delta.bookedPilotsAdded.insert(s);
+        } else if (!p->isFlightPlanEqual(*data.bookedPilots[s])) {
+            p->assignKeepingRoute(*data.bookedPilots[s]);
+            MustacheQs::Renderer::invalidate(p);
+            delta.bookedPilotsChanged.insert(s);
+        } else {
+            bool isMoved = false;
+            if (p->updateStateFrom(*data.bookedPilots[s], &isMoved)) {
+                delta.bookedPilotsChanged.insert(s);
+                MustacheQs::Renderer::invalidate(p);
+            }
         }
     }
     qDebug() << "-- finished";
 }
 
-void WhazzupData::updateControllersFrom(const WhazzupData &data) {
+void WhazzupData::updateControllersFrom(const WhazzupData &data, WhazzupDelta &delta) {
     qDebug();
     foreach (const QString s, controllers.keys()) {
         if (!data.controllers.contains(s)) {
             // remove controllers that are no longer there
             delete controllers[s];
             controllers.remove(s);
+            delta.controllersRemoved.insert(s);
         }
     }
     foreach (const QString s, data.controllers.keys()) {
-        if (!controllers.contains(s)) {
+        Controller* c = controllers.value(s, 0);
+        if (c == 0) {
             // create a new copy of new controllers
-            Controller* c = new Controller(*data.controllers[s]);
+            c = new Controller(*data.controllers[s]);
             controllers[c->callsign] = c;
-        } else { // controller already exists, assign values from data
-            *controllers[s] = *data.controllers[s];
+            delta.controllersAdded.insert(s);
+        } else if (c->hasChangedFrom(*data.controllers[s])) {
+            // controller already exists, assign values from data
+            *c = *data.controllers[s];
+            MustacheQs::Renderer::invalidate(c);
+            delta.controllersChanged.insert(s);
         }
     }
     qDebug() << "-- finished";
@@ -457,18 +680,21 @@ void WhazzupData::updateBookedControllersFrom(const WhazzupData &data) {
     foreach (const BookedController* bc, data.bookedControllers) {
         bookedControllers.append(new BookedController(*bc));
     }
+    bookingIndex = data.bookingIndex;
     qDebug() << "-- finished";
 }
 
-void WhazzupData::updateFrom(const WhazzupData &data) {
+WhazzupDelta WhazzupData::updateFrom(const WhazzupData &data) {
     qDebug();
+    WhazzupDelta delta;
     if (this == &data) {
-        return;
+        return delta;
     }
 
     if (data.isNull()) {
-        return;
+        return delta;
     }
+    delta.isFullUpdate = false;
 
     if (!data.ratings.empty()) {
         ratings = data.ratings;
@@ -484,8 +710,8 @@ void WhazzupData::updateFrom(const WhazzupData &data) {
         if (_dataType == ATCBOOKINGS) {
             _dataType = UNIFIED;
         }
-        updatePilotsFrom(data);
-        updateControllersFrom(data);
+        updatePilotsFrom(data, delta);
+        updateControllersFrom(data, delta);
 
         servers = data.servers;
         whazzupTime = data.whazzupTime;
@@ -497,10 +723,29 @@ void WhazzupData::updateFrom(const WhazzupData &data) {
             _dataType = UNIFIED;
         }
         updateBookedControllersFrom(data);
+        delta.bookedControllersChanged = true;
         bookingsTime = data.bookingsTime;
         predictionBasedOnBookingsTime = data.predictionBasedOnBookingsTime;
     }
+    qDebug() << "pilots +" << delta.pilotsAdded.size() << "-" << delta.pilotsRemoved.size()
+             << "moved" << delta.pilotsMoved.size() << "flight plan changed" << delta.pilotsFlightPlanChanged.size()
+             << "changed" << delta.pilotsChanged.size()
+             << "controllers +" << delta.controllersAdded.size() << "-" << delta.controllersRemoved.size()
+             << "changed" << delta.controllersChanged.size();
     qDebug() << "-- finished";
+    return delta;
+}
+
+bool WhazzupDelta::hasPilotChanges() const {
+    return isFullUpdate
+        || !pilotsAdded.isEmpty() || !pilotsRemoved.isEmpty() || !pilotsMoved.isEmpty()
+        || !pilotsFlightPlanChanged.isEmpty() || !pilotsChanged.isEmpty()
+        || !bookedPilotsAdded.isEmpty() || !bookedPilotsRemoved.isEmpty() || !bookedPilotsChanged.isEmpty();
+}
+
+bool WhazzupDelta::hasControllerChanges() const {
+    return isFullUpdate
+        || !controllersAdded.isEmpty() || !controllersRemoved.isEmpty() || !controllersChanged.isEmpty();
 }
 
 QSet<Controller*> WhazzupData::controllersWithSectors() const {
@@ -519,7 +764,7 @@ QList<Pilot*> WhazzupData::allPilots() const {
 }
 
 QList<QPair<double, double> > WhazzupData::friendsLatLon() const {
-    QStringList friends = Settings::friends();
+    const QSet<QString> &friends = Friends::instance()->ids();
     QList<QPair<double, double> > result;
     foreach (Controller* c, controllers.values()) {
         if (c->isAtis()) {
@@ -1,6 +1,7 @@
 #ifndef WHAZZUPDATA_H_
 #define WHAZZUPDATA_H_
 
+#include "BookingIndex.h"
 #include "MapObjectVisitor.h"
 
 class Pilot;
@@ -8,12 +9,31 @@ class Controller;
 class BookedController;
 class Client;
 
+// what changed in a WhazzupData::updateFrom(), by callsign
+struct WhazzupDelta {
+    bool isFullUpdate = true; // no change detection was done, consider everything changed
+
+    QSet<QString> pilotsAdded, pilotsRemoved, pilotsMoved, pilotsFlightPlanChanged;
+    QSet<QString> pilotsChanged; // any field, includes pilotsMoved and pilotsFlightPlanChanged
+    QSet<QString> bookedPilotsAdded, bookedPilotsRemoved, bookedPilotsChanged;
+    QSet<QString> controllersAdded, controllersRemoved, controllersChanged; // changed: ATIS, frequency, position...
+    bool bookedControllersChanged = false;
+
+    bool hasPilotChanges() const;
+    bool hasControllerChanges() const;
+};
+
 class WhazzupData {
     public:
         enum WhazzupType { NONE, WHAZZUP, ATCBOOKINGS, UNIFIED };
 
+        // parse WHAZZUP feeds with JsonPullReader, falling back to QJsonDocument on failure
+        static bool useStreamingParser;
+
         WhazzupData();
         WhazzupData(QByteArray* bytes, WhazzupType type);
+        // without reading Settings, for worker threads
+        WhazzupData(QByteArray* bytes, WhazzupType type, int downloadIntervalSec);
         WhazzupData(const QDateTime predictTime, const WhazzupData &data); // predict whazzup data
         WhazzupData(const WhazzupData &data);
         ~WhazzupData();
@@ -21,13 +41,14 @@ class WhazzupData {
         WhazzupData &operator=(const WhazzupData &data);
 
         bool isNull() const;
-        void updateFrom(const WhazzupData &data);
+        WhazzupDelta updateFrom(const WhazzupData &data);
 
         QSet<Controller*> controllersWithSectors() const;
         QHash<QString, Pilot*> pilots, bookedPilots;
         QHash<QString, Controller*> controllers;
         QList<Pilot*> allPilots() const;
         QList<BookedController*> bookedControllers;
+        BookingIndex bookingIndex; // over bookedControllers
 
         QList<QPair<double, double> > friendsLatLon() const;
 
@@ -42,12 +63,17 @@ class WhazzupData {
 
         void accept(MapObjectVisitor* visitor) const;
     private:
+        bool parseJsonStream(const QByteArray& bytes);
+        void parseJsonDocument(const QByteArray& bytes, WhazzupType type);
         void assignFrom(const WhazzupData &data);
-        void updatePilotsFrom(const WhazzupData &data);
-        void updateControllersFrom(const WhazzupData &data);
+        void updatePilotsFrom(const WhazzupData &data, WhazzupDelta &delta);
+        void updateControllersFrom(const WhazzupData &data, WhazzupDelta &delta);
         void updateBookedControllersFrom(const WhazzupData &data);
+        static Pilot* predictedPilot(const Pilot* p, const QDateTime &predictTime, const QDateTime &basedOnTime, bool* isBooked);
         int _whazzupVersion;
         WhazzupType _dataType;
+
+        friend class Benchmark;
 };
 
 #endif /*WHAZZUPDATA_H_*/
@@ -82,7 +82,7 @@ void BookedAtcDialog::refresh() {
     const WhazzupData &data = Whazzup::instance()->realWhazzupData();
 
     qDebug() << "BookedAtcDialog/refresh(): setting clients";
-    _bookedAtcModel->setClients(data.bookedControllers);
+    _bookedAtcModel->setClients(data.bookedControllers, data.bookingIndex);
 
     QString msg = QString("Bookings %1 updated")
         .arg(
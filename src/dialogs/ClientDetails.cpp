@@ -2,7 +2,7 @@
 
 #include "Window.h"
 #include "../Client.h"
-#include "../Settings.h"
+#include "../Friends.h"
 
 ClientDetails::ClientDetails(QWidget* parent)
     : QDialog(parent) {
@@ -30,15 +30,11 @@ void ClientDetails::showOnMap() const {
 
 void ClientDetails::friendClicked() const {
     if (!userId.isEmpty()) {
-        if (Settings::friends().contains(userId)) {
-            Settings::removeFriend(userId);
+        // views follow Friends::friendsChanged()
+        if (Friends::instance()->contains(userId)) {
+            Friends::instance()->remove(userId);
         } else {
-            Settings::addFriend(userId);
-        }
-
-        if (Window::instance(false) != 0) {
-            Window::instance()->refreshFriends();
-            Window::instance()->mapScreen->glWidget->newWhazzupData(true);
+            Friends::instance()->add(userId);
         }
     }
 }
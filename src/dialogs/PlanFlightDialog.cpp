@@ -308,7 +308,7 @@ void PlanFlightDialog::plotPlannedRoute() const {
     glColor4f((GLfloat) .7, (GLfloat) 1., (GLfloat) .4, (GLfloat) .8);
     glLineWidth(2.);
     glBegin(GL_LINE_STRIP);
-    NavData::plotGreatCirclePoints(points);
+    NavData::plotGreatCirclePoints(points, false, CacheAllSegments);
     glEnd();
     glPointSize(4.);
     glColor4f(.5, .5, .5, .5);
@@ -8,6 +8,7 @@
 #include "PlanFlightDialog.h"
 #include "PreferencesDialog.h"
 #include "StaticSectorsDialog.h"
+#include "../Friends.h"
 #include "../FriendsVisitor.h"
 #include "../GLWidget.h"
 #include "../GuiMessage.h"
@@ -16,7 +17,7 @@
 #include "../NavData.h"
 #include "../Platform.h"
 #include "../Settings.h"
-#include "../SearchVisitor.h"
+#include "../SearchIndex.h"
 #include "../Whazzup.h"
 
 #include <QModelIndex>
@@ -147,6 +148,8 @@ Window::Window(QWidget* parent)
 
     connect(friendsList, &QAbstractItemView::clicked, this, &Window::friendClicked);
     friendsList->sortByColumn(0, Qt::AscendingOrder);
+    connect(Friends::instance(), &Friends::friendsChanged, this, &Window::refreshFriends);
+    connect(Friends::instance(), &Friends::aliasesChanged, this, &Window::aliasesChanged);
 
     // debounce input timers
     connect(&_timerSearch, &QTimer::timeout, this, &Window::performSearch);
@@ -436,11 +439,7 @@ void Window::performSearch() {
     searchResult->repaint();
     qApp->processEvents();
 
-    SearchVisitor* visitor = new SearchVisitor(searchEdit->text());
-    NavData::instance()->accept(visitor);
-    Whazzup::instance()->whazzupData().accept(visitor);
-    _modelSearchResult.setSearchResults(visitor->result());
-    delete visitor;
+    _modelSearchResult.setSearchResults(SearchIndex::instance()->search(searchEdit->text()));
 
     _modelSearchResult.m_isSearching = false;
     searchResult->reset();
@@ -532,6 +531,22 @@ void Window::friendClicked(const QModelIndex& index) {
     _modelFriends.modelClicked(_sortmodelFriends->mapToSource(index));
 }
 
+void Window::aliasesChanged() {
+    friendsList->reset();
+    searchResult->reset();
+    mapScreen->glWidget->update();
+
+    if (PilotDetails::instance(false) != 0) {
+        PilotDetails::instance()->refresh();
+    }
+    if (ControllerDetails::instance(false) != 0) {
+        ControllerDetails::instance()->refresh();
+    }
+    if (AirportDetails::instance(false) != 0) {
+        AirportDetails::instance()->refresh();
+    }
+}
+
 void Window::metarClicked(const QModelIndex& index) {
     _metarModel.modelClicked(_sortmodelMetar->mapToSource(index));
 }
@@ -587,22 +602,21 @@ void Window::performWarp() {
     qDebug() << "warpToTime=" << warpToTime << " realWhazzupTime=" << realWhazzupTime;
     if (cbUseDownloaded->isChecked() && warpToTime < realWhazzupTime) {
         qDebug() << "Looking for downloaded Whazzups";
-        QList<QPair<QDateTime, QString> > downloaded = Whazzup::instance()->downloadedWhazzups();
-        for (int i = downloaded.size() - 1; i > -1; i--) {
-            if ((downloaded[i].first <= warpToTime && realWhazzupTime < downloaded[i].first) || (i == 0)) {
-                // only if different
-                if (downloaded[i].first != realWhazzupTime) {
-                    // disconnect to inhibit update because will be updated later
-                    disconnect(Whazzup::instance(), &Whazzup::newData, mapScreen->glWidget, &GLWidget::newWhazzupData);
-                    disconnect(Whazzup::instance(), &Whazzup::newData, this, &Window::processWhazzup);
-
-                    Whazzup::instance()->fromFile(downloaded[i].second);
-
-                    connect(Whazzup::instance(), &Whazzup::newData, mapScreen->glWidget, &GLWidget::newWhazzupData);
-                    connect(Whazzup::instance(), &Whazzup::newData, this, &Window::processWhazzup);
-                }
-                break;
-            }
+        const WhazzupArchive* archive = Whazzup::instance()->archive();
+        QDateTime downloaded = archive->floor(warpToTime);
+        if (!downloaded.isValid() || !(realWhazzupTime < downloaded && downloaded <= warpToTime)) {
+            downloaded = archive->first();
+        }
+        // only if different
+        if (downloaded.isValid() && downloaded != realWhazzupTime) {
+            // disconnect to inhibit update because will be updated later
+            disconnect(Whazzup::instance(), &Whazzup::newData, mapScreen->glWidget, &GLWidget::newWhazzupData);
+            disconnect(Whazzup::instance(), &Whazzup::newData, this, &Window::processWhazzup);
+
+            Whazzup::instance()->fromArchive(downloaded);
+
+            connect(Whazzup::instance(), &Whazzup::newData, mapScreen->glWidget, &GLWidget::newWhazzupData);
+            connect(Whazzup::instance(), &Whazzup::newData, this, &Window::processWhazzup);
         }
     }
     Whazzup::instance()->setPredictedTime(warpToTime);
@@ -612,9 +626,9 @@ void Window::on_cbUseDownloaded_toggled(bool checked) {
     qDebug() << "checked=" << checked;
     if (!checked) {
         // I currently don't understand why we had this
-        //        QList<QPair<QDateTime, QString> > downloaded = Whazzup::instance()->downloadedWhazzups();
-        //        if(!downloaded.isEmpty())
-        //            Whazzup::instance()->fromFile(downloaded.last().second);
+        //        QDateTime downloaded = Whazzup::instance()->archive()->ceil(QDateTime::currentDateTimeUtc());
+        //        if(downloaded.isValid())
+        //            Whazzup::instance()->fromArchive(downloaded);
         cbOnlyUseDownloaded->setChecked(false);
     }
     performWarp();
@@ -673,12 +687,9 @@ void Window::runPredict() {
     // when only using downloaded Whazzups, select the next available
     if (cbOnlyUseDownloaded->isChecked()) {
         qDebug() << "restricting Warp target to downloaded Whazzups";
-        QList<QPair<QDateTime, QString> > downloaded = Whazzup::instance()->downloadedWhazzups();
-        for (int i = 0; i < downloaded.size(); i++) {
-            if ((downloaded[i].first >= to) || (i == downloaded.size() - 1)) {
-                to = downloaded[i].first;
-                break;
-            }
+        const QDateTime downloaded = Whazzup::instance()->archive()->ceil(to);
+        if (downloaded.isValid()) {
+            to = downloaded;
         }
     }
 
@@ -765,22 +776,12 @@ void Window::dateTimePredict_dateTimeChanged(QDateTime dateTime) {
     // when only using downloaded Whazzups, select the next available
     if (cbOnlyUseDownloaded->isChecked()) {
         qDebug() << "restricting Warp target to downloaded Whazzups";
-        QList<QPair<QDateTime, QString> > downloaded =
-            Whazzup::instance()->downloadedWhazzups();
-        if (dateTime > _dateTimePredict_old) { // selecting a later date
-            for (int i = 0; i < downloaded.size(); i++) {
-                if ((downloaded[i].first >= dateTime) || (i == downloaded.size() - 1)) {
-                    dateTime = downloaded[i].first;
-                    break;
-                }
-            }
-        } else { // selecting an earlier date
-            for (int i = downloaded.size() - 1; i > -1; i--) {
-                if ((downloaded[i].first <= dateTime) || (i == 0)) {
-                    dateTime = downloaded[i].first;
-                    break;
-                }
-            }
+        const WhazzupArchive* archive = Whazzup::instance()->archive();
+        const QDateTime downloaded = dateTime > _dateTimePredict_old
+            ? archive->ceil(dateTime) // selecting a later date
+            : archive->floor(dateTime); // selecting an earlier date
+        if (downloaded.isValid()) {
+            dateTime = downloaded;
         }
     }
 
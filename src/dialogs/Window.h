@@ -79,6 +79,7 @@ class Window
         void searchDockMoved(Qt::DockWidgetArea area);
         void friendsDockMoved(Qt::DockWidgetArea area);
         void friendClicked(const QModelIndex& index);
+        void aliasesChanged();
         void downloadWatchdogTriggered();
     protected:
         virtual void closeEvent(QCloseEvent* event) override;
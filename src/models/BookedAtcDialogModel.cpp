@@ -4,13 +4,18 @@
 #include <QDesktopServices>
 #include <QMessageBox>
 
-void BookedAtcDialogModel::setClients(const QList<BookedController*> &controllers) {
+void BookedAtcDialogModel::setClients(const QList<BookedController*> &controllers, const BookingIndex& index) {
     qDebug() << "BookedAtcDialogModel/setClients()";
     beginResetModel();
     this->_controllers = controllers;
+    this->_index = index;
     endResetModel();
 }
 
+QVector<int> BookedAtcDialogModel::rowsOverlapping(const QDateTime& from, const QDateTime& to) const {
+    return _index.overlapping(from, to);
+}
+
 QVariant BookedAtcDialogModel::headerData(int section, enum Qt::Orientation orientation, int role) const {
     if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
         switch (section) {
@@ -2,6 +2,7 @@
 #define BOOKEDATCDIALOGMODEL_H_
 
 #include "../BookedController.h"
+#include "../BookingIndex.h"
 
 #include <QAbstractTableModel>
 
@@ -23,11 +24,15 @@ class BookedAtcDialogModel
             int role = Qt::DisplayRole
         ) const override;
 
+        // rows booked from-to, see BookingIndex::overlapping()
+        QVector<int> rowsOverlapping(const QDateTime& from, const QDateTime& to) const;
+
     public slots:
-        void setClients(const QList<BookedController*>& controllers);
+        void setClients(const QList<BookedController*>& controllers, const BookingIndex& index);
 
     private:
         QList<BookedController*> _controllers;
+        BookingIndex _index;
 };
 
 #endif /*BOOKEDATCDIALOGMODEL_H_*/
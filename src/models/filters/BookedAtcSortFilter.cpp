@@ -1,23 +1,12 @@
 #include "BookedAtcSortFilter.h"
 
+#include "../BookedAtcDialogModel.h"
+
 bool BookedAtcSortFilter::filterAcceptsRow(int source_row, const QModelIndex& source_parent) const {
-    if (this->_from.isValid() && this->_to.isValid()) {
-        if (sourceModel()->index(source_row, 0, source_parent).isValid()) {
-            QDateTime starts = sourceModel()->index(source_row, 4, source_parent).data(Qt::UserRole).toDateTime().toUTC();
-            QDateTime ends = sourceModel()->index(source_row, 5, source_parent).data(Qt::UserRole).toDateTime().toUTC();
-            if (
-                (_to == _from && _from <= ends) // _to == _from means for: ever
-                || (_from <= starts && _to >= starts)
-                || (_from <= ends && _to >= starts)
-            ) {
-                return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
-            }
-            return false;
-        }
-    } else {
-        return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+    if (this->_from.isValid() && this->_to.isValid() && !_isRowInRange.value(source_row, false)) {
+        return false;
     }
-    return false;
+    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
 }
 
 bool BookedAtcSortFilter::lessThan(const QModelIndex &left, const QModelIndex &right) const {
@@ -33,5 +22,28 @@ bool BookedAtcSortFilter::lessThan(const QModelIndex &left, const QModelIndex &r
 void BookedAtcSortFilter::setDateTimeRange(QDateTime& from, QDateTime& to) {
     this->_from = from;
     this->_to = to;
+    updateRowsInRange();
     this->invalidateFilter();
 }
+
+void BookedAtcSortFilter::setSourceModel(QAbstractItemModel* sourceModel) {
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    connect(
+        sourceModel, &QAbstractItemModel::modelReset, this, [this] {
+            updateRowsInRange();
+            invalidateFilter();
+        }
+    );
+}
+
+// looked up in the BookingIndex once instead of comparing dates per row
+void BookedAtcSortFilter::updateRowsInRange() {
+    _isRowInRange.fill(false, sourceModel()->rowCount());
+    const BookedAtcDialogModel* model = qobject_cast<const BookedAtcDialogModel*>(sourceModel());
+    if (model != 0 && _from.isValid() && _to.isValid()) {
+        // _to == _from means for: ever
+        foreach (const int row, model->rowsOverlapping(_from, _to == _from? QDateTime(): _to)) {
+            _isRowInRange[row] = true;
+        }
+    }
+}
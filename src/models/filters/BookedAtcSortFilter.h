@@ -10,12 +10,16 @@ class BookedAtcSortFilter
         BookedAtcSortFilter(QObject* parent = 0)
             : QSortFilterProxyModel(parent) {}
         void setDateTimeRange(QDateTime& dtfrom, QDateTime& dtto);
+        virtual void setSourceModel(QAbstractItemModel* sourceModel) override;
 
     protected:
         bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const;
         bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
     private:
+        void updateRowsInRange();
+
         QDateTime _from, _to;
+        QVector<bool> _isRowInRange; // by source row
 };
 
 #endif // BOOKEDATCSORTFILTER_H
@@ -16,7 +16,15 @@ namespace MustacheQs {
     }
 
     void Renderer::teardownContext(QObject* _o) {
-        instance()->m_teardownContext(_o);
+        invalidate(_o);
+    }
+
+    void Renderer::invalidate(QObject* _o) {
+        instance()->m_rendered.remove(_o);
+    }
+
+    void Renderer::invalidateAll() {
+        instance()->m_rendered.clear();
     }
 
     Renderer::Renderer() {
@@ -26,42 +34,46 @@ namespace MustacheQs {
     }
 
     QString Renderer::m_render(const QString &_template, QObject* _o) {
-        return m_renderer.render(_template, m_context(_o));
-    }
-
-    void Renderer::m_teardownContext(QObject* _o) {
-        if (!m_contexts.contains(_o)) {
-            return;
+        const Template* compiled = m_template(_template, _o);
+        if (compiled == 0) {
+            Mustache::QtVariantContext context((QVariantHash()));
+            return m_renderer.render(_template, &context);
         }
 
-        auto context = m_contexts.take(_o);
-        delete context;
+        auto &rendered = m_rendered[_o];
+        const auto it = rendered.constFind(_template);
+        if (it != rendered.constEnd()) {
+            return it.value();
+        }
+        const QString result = compiled->render(_o);
+        rendered.insert(_template, result);
+        return result;
     }
 
-    Mustache::Context* Renderer::m_context(QObject* _o) {
-        if (m_contexts.contains(_o)) {
-            return m_contexts.value(_o);
+    const Template* Renderer::m_template(const QString &_template, QObject* _o) {
+        QHash<QString, Template*>* templates;
+        const Keys* keys;
+        if (qobject_cast<::Airport*>(_o) != 0) {
+            templates = &m_airportTemplates;
+            keys = &MustacheQs::Airport::Context::keys();
+        } else if (qobject_cast<::Controller*>(_o) != 0) {
+            templates = &m_controllerTemplates;
+            keys = &MustacheQs::Controller::Context::keys();
+        } else if (qobject_cast<::Pilot*>(_o) != 0) {
+            templates = &m_pilotTemplates;
+            keys = &MustacheQs::Pilot::Context::keys();
+        } else {
+            return 0;
         }
 
-        Mustache::Context* context;
-
-        ::Airport* a = qobject_cast<::Airport*>(_o);
-        if (a != 0) {
-            context = new MustacheQs::Airport::Context(a);
-        } else {
-            ::Controller* c = qobject_cast<::Controller*>(_o);
-            if (c != 0) {
-                context = new MustacheQs::Controller::Context(c);
-            } else {
-                ::Pilot* p = qobject_cast<::Pilot*>(_o);
-                if (p != 0) {
-                    context = new MustacheQs::Pilot::Context(p);
-                } else {
-                    context = new Mustache::QtVariantContext((QVariantHash()));
-                }
+        Template* compiled = templates->value(_template, 0);
+        if (compiled == 0) {
+            compiled = new Template(m_renderer.compile(_template, keys->partials), *keys);
+            if (!m_renderer.error().isEmpty()) {
+                qWarning() << "template" << _template << ":" << m_renderer.error() << "at" << m_renderer.errorPos();
             }
+            templates->insert(_template, compiled);
         }
-        m_contexts.insert(_o, context);
-        return context;
+        return compiled;
     }
 }
@@ -1,24 +1,31 @@
 #ifndef MUSTACHEQS_RENDERER_H
 #define MUSTACHEQS_RENDERER_H
 
-#include "src/mustache/external/qt-mustache/mustache.h"
+#include "src/mustache/Template.h"
 
 namespace MustacheQs {
     class Renderer {
         public:
             static Renderer* instance();
-            // when using this, call teardownContext() to release memory
+            // Airports, controllers and pilots render with a compiled template,
+            // memoized per object and template. Call teardownContext() to release memory.
             static QString render(const QString& _template, QObject* _o);
             static void teardownContext(QObject* _o);
+            // the data of the object changed
+            static void invalidate(QObject* _o);
+            // data of all objects changed, e.g. friends or aliases
+            static void invalidateAll();
         private:
             Renderer();
 
             QString m_render(const QString& _template, QObject* _o);
-            void m_teardownContext(QObject* _o);
-            Mustache::Context* m_context(QObject* o);
+            const Template* m_template(const QString& _template, QObject* _o);
 
             Mustache::Renderer m_renderer;
-            QHash<QObject*, Mustache::Context*> m_contexts;
+            // by template
+            QHash<QString, Template*> m_airportTemplates, m_controllerTemplates, m_pilotTemplates;
+            // by object and template. Settings clears it when a template is edited.
+            QHash<QObject*, QHash<QString, QString> > m_rendered;
     };
 }
 
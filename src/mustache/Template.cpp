@@ -0,0 +1,65 @@
+#include "Template.h"
+
+namespace MustacheQs {
+    // like unescapeHtml() in qt-mustache
+    static QString unescapeHtml(const QString &escaped) {
+        QString unescaped(escaped);
+        unescaped.replace(QLatin1String("&lt;"), QLatin1String("<"));
+        unescaped.replace(QLatin1String("&gt;"), QLatin1String(">"));
+        unescaped.replace(QLatin1String("&quot;"), QLatin1String("\""));
+        unescaped.replace(QLatin1String("&amp;"), QLatin1String("&"));
+        return unescaped;
+    }
+
+    Template::Template(const Mustache::Program &program, const Keys &keys)
+        : m_isZeroFalse(keys.isZeroFalse) {
+        m_ops.reserve(program.ops.size());
+        foreach (const auto &op, program.ops) {
+            Op compiled { op.type, op.text, 0, op.escapeMode == Mustache::Tag::Unescape, op.end };
+            if (op.type != Mustache::Program::Op::Text) {
+                compiled.getter = keys.getters.value(op.text, 0);
+            }
+            // contexts render unknown keys as "{key}"
+            if (op.type == Mustache::Program::Op::Value && compiled.getter == 0) {
+                compiled.type = Mustache::Program::Op::Text;
+                compiled.text = QString("{%1}").arg(op.text);
+                if (compiled.isUnescape) {
+                    compiled.text = unescapeHtml(compiled.text);
+                }
+            }
+            m_ops.append(compiled);
+        }
+    }
+
+    QString Template::render(const QObject* o) const {
+        QString result;
+        for (int i = 0; i < m_ops.size();) {
+            const Op &op = m_ops[i];
+            switch (op.type) {
+                case Mustache::Program::Op::Text:
+                    result += op.text;
+                    i++;
+                    break;
+                case Mustache::Program::Op::Value:
+                    result += op.isUnescape? unescapeHtml(op.getter(o)): op.getter(o);
+                    i++;
+                    break;
+                case Mustache::Program::Op::SectionStart:
+                    i = isFalse(op, o)? op.end: i + 1;
+                    break;
+                case Mustache::Program::Op::InvertedSectionStart:
+                    i = isFalse(op, o)? i + 1: op.end;
+                    break;
+            }
+        }
+        return result;
+    }
+
+    bool Template::isFalse(const Op &op, const QObject* o) const {
+        if (op.getter == 0) {
+            return false;
+        }
+        const QString value = op.getter(o);
+        return value.isEmpty() || (m_isZeroFalse && value == "0");
+    }
+}
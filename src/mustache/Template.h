@@ -0,0 +1,40 @@
+#ifndef MUSTACHEQS_TEMPLATE_H
+#define MUSTACHEQS_TEMPLATE_H
+
+#include "src/mustache/external/qt-mustache/mustache.h"
+
+#include <QtCore>
+
+namespace MustacheQs {
+    // the keys of a context type, looked up once when compiling a template
+    struct Keys {
+        typedef QString (*Getter)(const QObject*);
+
+        QHash<QString, Getter> getters;
+        Mustache::PartialResolver* partials;
+        bool isZeroFalse; // "0" is false in sections
+    };
+
+    // a template compiled for one context type. Renders like Mustache::Renderer
+    // with the matching Mustache::Context, without parsing the template again.
+    class Template {
+        public:
+            Template(const Mustache::Program& program, const Keys& keys);
+
+            QString render(const QObject* o) const;
+        private:
+            struct Op {
+                Mustache::Program::Op::Type type;
+                QString text; // literal text or key
+                Keys::Getter getter; // 0 for unknown keys
+                bool isUnescape;
+                int end;
+            };
+            bool isFalse(const Op& op, const QObject* o) const;
+
+            QVector<Op> m_ops;
+            bool m_isZeroFalse;
+    };
+}
+
+#endif
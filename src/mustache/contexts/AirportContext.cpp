@@ -31,75 +31,80 @@ namespace MustacheQs::Airport {
 
     Context::~Context() {}
 
+    static const class Airport* airport(const QObject* o) {
+        return static_cast<const class Airport*>(o);
+    }
+
+    const Keys& Context::keys() {
+        static const Keys _keys {
+            {
+                { "code", [](const QObject* o) -> QString {
+                      return airport(o)->id;
+                  } },
+                { "arrs", [](const QObject* o) -> QString {
+                      return QString::number(airport(o)->nMaybeFilteredArrivals);
+                  } },
+                { "deps", [](const QObject* o) -> QString {
+                      return QString::number(airport(o)->nMaybeFilteredDepartures);
+                  } },
+                { "allArrs", [](const QObject* o) -> QString {
+                      return QString::number(airport(o)->arrivals.count());
+                  } },
+                { "allDeps", [](const QObject* o) -> QString {
+                      return QString::number(airport(o)->departures.count());
+                  } },
+                { "del", [](const QObject* o) -> QString {
+                      return airport(o)->dels.isEmpty()? "": "D";
+                  } },
+                { "gnd", [](const QObject* o) -> QString {
+                      return airport(o)->gnds.isEmpty()? "": "G";
+                  } },
+                { "twr", [](const QObject* o) -> QString {
+                      return airport(o)->twrs.isEmpty()? "": "T";
+                  } },
+                { "app", [](const QObject* o) -> QString {
+                      return airport(o)->appDeps.isEmpty()? "": "A";
+                  } },
+                { "controllers", [](const QObject* o) -> QString {
+                      return airport(o)->controllersString();
+                  } },
+                { "atis", [](const QObject* o) -> QString {
+                      return airport(o)->atisCodeString();
+                  } },
+                { "country", [](const QObject* o) -> QString {
+                      return airport(o)->countryCode;
+                  } },
+                { "prettyName", [](const QObject* o) -> QString {
+                      return airport(o)->prettyName();
+                  } },
+                { "name", [](const QObject* o) -> QString {
+                      return airport(o)->name;
+                  } },
+                { "city", [](const QObject* o) -> QString {
+                      return airport(o)->city;
+                  } },
+                { "frequencies", [](const QObject* o) -> QString {
+                      return airport(o)->frequencyString();
+                  } },
+                { "pdc", [](const QObject* o) -> QString {
+                      return airport(o)->pdcString("");
+                  } },
+                { "livestream", [](const QObject* o) -> QString {
+                      return airport(o)->livestreamString();
+                  } },
+            },
+            PartialResolver::instance(),
+            true
+        };
+        return _keys;
+    }
+
     QString Context::stringValue(const QString &key) const {
-        if (key == "code") {
-            return m_o->id;
-        }
-        if (key == "arrs") {
-            return QString::number(m_o->nMaybeFilteredArrivals);
-        }
-        if (key == "deps") {
-            return QString::number(m_o->nMaybeFilteredDepartures);
-        }
-        if (key == "allArrs") {
-            return QString::number(m_o->arrivals.count());
-        }
-        if (key == "allDeps") {
-            return QString::number(m_o->departures.count());
-        }
-        if (key == "del") {
-            if (m_o->dels.isEmpty()) {
-                return "";
-            }
-            return "D";
-        }
-        if (key == "gnd") {
-            if (m_o->gnds.isEmpty()) {
-                return "";
-            }
-            return "G";
-        }
-        if (key == "twr") {
-            if (m_o->twrs.isEmpty()) {
-                return "";
-            }
-            return "T";
+        const auto getter = keys().getters.value(key, 0);
+        if (getter == 0) {
+            return QString("{%1}").arg(key);
         }
-        if (key == "app") {
-            if (m_o->appDeps.isEmpty()) {
-                return "";
-            }
-            return "A";
-        }
-        if (key == "controllers") {
-            return m_o->controllersString();
-        }
-        if (key == "atis") {
-            return m_o->atisCodeString();
-        }
-        if (key == "country") {
-            return m_o->countryCode;
-        }
-        if (key == "prettyName") {
-            return m_o->prettyName();
-        }
-        if (key == "name") {
-            return m_o->name;
-        }
-        if (key == "city") {
-            return m_o->city;
-        }
-        if (key == "frequencies") {
-            return m_o->frequencyString();
-        }
-        if (key == "pdc") {
-            return m_o->pdcString("");
-        }
-        if (key == "livestream") {
-            return m_o->livestreamString();
-        }
-
-        return QString("{%1}").arg(key);
+        return getter(m_o);
     }
 
     bool Context::isFalse(const QString &key) const {
@@ -22,41 +22,58 @@ namespace MustacheQs::Controller {
 
     Context::~Context() {}
 
-    QString Context::stringValue(const QString &key) const {
-        if (key == "sectorOrLogin") {
-            if (m_o->sector != 0) {
-                return m_o->controllerSectorName();
-            }
+    static const class Controller* controller(const QObject* o) {
+        return static_cast<const class Controller*>(o);
+    }
 
-            return m_o->callsign;
-        }
-        if (key == "sector") {
-            if (m_o->sector != 0) {
-                return m_o->sector->name;
-            }
+    const Keys& Context::keys() {
+        static const Keys _keys {
+            {
+                { "sectorOrLogin", [](const QObject* o) -> QString {
+                      if (controller(o)->sector != 0) {
+                          return controller(o)->controllerSectorName();
+                      }
 
-            return "";
-        }
-        if (key == "name") {
-            return m_o->aliasOrName();
-        }
-        if (key == "nameIfFriend") {
-            return m_o->isFriend()? m_o->aliasOrName(): "";
-        }
-        if (key == "rating") {
-            return m_o->rank();
-        }
-        if (key == "frequency") {
-            return m_o->frequency.length() > 1? m_o->frequency: "";
-        }
-        if (key == "cpdlc") {
-            return m_o->cpdlcString();
-        }
-        if (key == "livestream") {
-            return m_o->livestreamString();
-        }
+                      return controller(o)->callsign;
+                  } },
+                { "sector", [](const QObject* o) -> QString {
+                      if (controller(o)->sector != 0) {
+                          return controller(o)->sector->name;
+                      }
 
-        return QString("{%1}").arg(key);
+                      return "";
+                  } },
+                { "name", [](const QObject* o) -> QString {
+                      return controller(o)->aliasOrName();
+                  } },
+                { "nameIfFriend", [](const QObject* o) -> QString {
+                      return controller(o)->isFriend()? controller(o)->aliasOrName(): "";
+                  } },
+                { "rating", [](const QObject* o) -> QString {
+                      return controller(o)->rank();
+                  } },
+                { "frequency", [](const QObject* o) -> QString {
+                      return controller(o)->frequency.length() > 1? controller(o)->frequency: "";
+                  } },
+                { "cpdlc", [](const QObject* o) -> QString {
+                      return controller(o)->cpdlcString();
+                  } },
+                { "livestream", [](const QObject* o) -> QString {
+                      return controller(o)->livestreamString();
+                  } },
+            },
+            PartialResolver::instance(),
+            false
+        };
+        return _keys;
+    }
+
+    QString Context::stringValue(const QString &key) const {
+        const auto getter = keys().getters.value(key, 0);
+        if (getter == 0) {
+            return QString("{%1}").arg(key);
+        }
+        return getter(m_o);
     }
 
     bool Context::isFalse(const QString &key) const {
@@ -1,7 +1,7 @@
 #ifndef MUSTACHEQS_CONTROLLER_CONTEXT_H
 #define MUSTACHEQS_CONTROLLER_CONTEXT_H
 
-#include "src/mustache/external/qt-mustache/mustache.h"
+#include "src/mustache/Template.h"
 
 class Controller;
 namespace MustacheQs::Controller {
@@ -21,6 +21,8 @@ namespace MustacheQs::Controller {
             Context(const class Controller*);
             virtual ~Context();
 
+            static const Keys& keys();
+
             virtual QString stringValue(const QString &key) const override;
             virtual bool isFalse(const QString &key) const override;
             virtual int listCount(const QString &key) const override;
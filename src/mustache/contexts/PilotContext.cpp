@@ -22,66 +22,82 @@ namespace MustacheQs::Pilot {
 
     Context::~Context() {}
 
-    QString Context::stringValue(const QString &key) const {
-        if (key == "debug:nextWp") {
-            QList<Waypoint*> waypoints = ((class Pilot*) m_o)->routeWaypointsWithDepDest();
-            int next = m_o->nextPointOnRoute(waypoints);
-            Waypoint* w = waypoints.value(next, nullptr);
-            if (w == nullptr) {
-                return "";
-            }
-            return w->id;
-        }
+    static const class Pilot* pilot(const QObject* o) {
+        return static_cast<const class Pilot*>(o);
+    }
 
-        if (key == "login") {
-            return m_o->callsign;
-        }
-        if (key == "name") {
-            return m_o->aliasOrName();
-        }
-        if (key == "nameIfFriend") {
-            return m_o->isFriend()? m_o->aliasOrName(): "";
-        }
-        if (key == "rating") {
-            return m_o->rank();
-        }
-        if (key == "dep") {
-            return m_o->planDep;
-        }
-        if (key == "dest") {
-            return m_o->planDest;
-        }
-        if (key == "FL") {
-            return m_o->flOrEmpty();
-        }
-        if (key == "GS") {
-            auto _gs = m_o->groundspeed;
-            if (_gs == 0) {
-                return "";
-            }
-            return QString("N%1").arg(m_o->groundspeed);
-        }
-        if (key == "GS10") {
-            auto _gs = m_o->groundspeed;
-            if (_gs == 0) {
-                return "";
-            }
-            return QString("N%1").arg(round(m_o->groundspeed / 10.));
-        }
-        if (key == "rules") {
-            return m_o->planFlighttype;
-        }
-        if (key == "rulesIfNotIfr") {
-            return m_o->planFlighttype != "I"? m_o->planFlighttype: "";
-        }
-        if (key == "type") {
-            return m_o->planAircraftShort;
-        }
-        if (key == "livestream") {
-            return m_o->livestreamString();
-        }
+    const Keys& Context::keys() {
+        static const Keys _keys {
+            {
+                { "debug:nextWp", [](const QObject* o) -> QString {
+                      QList<Waypoint*> waypoints = ((class Pilot*) pilot(o))->routeWaypointsWithDepDest();
+                      int next = pilot(o)->nextPointOnRoute(waypoints);
+                      Waypoint* w = waypoints.value(next, nullptr);
+                      if (w == nullptr) {
+                          return "";
+                      }
+                      return w->id;
+                  } },
+                { "login", [](const QObject* o) -> QString {
+                      return pilot(o)->callsign;
+                  } },
+                { "name", [](const QObject* o) -> QString {
+                      return pilot(o)->aliasOrName();
+                  } },
+                { "nameIfFriend", [](const QObject* o) -> QString {
+                      return pilot(o)->isFriend()? pilot(o)->aliasOrName(): "";
+                  } },
+                { "rating", [](const QObject* o) -> QString {
+                      return pilot(o)->rank();
+                  } },
+                { "dep", [](const QObject* o) -> QString {
+                      return pilot(o)->planDep;
+                  } },
+                { "dest", [](const QObject* o) -> QString {
+                      return pilot(o)->planDest;
+                  } },
+                { "FL", [](const QObject* o) -> QString {
+                      return pilot(o)->flOrEmpty();
+                  } },
+                { "GS", [](const QObject* o) -> QString {
+                      auto _gs = pilot(o)->groundspeed;
+                      if (_gs == 0) {
+                          return "";
+                      }
+                      return QString("N%1").arg(_gs);
+                  } },
+                { "GS10", [](const QObject* o) -> QString {
+                      auto _gs = pilot(o)->groundspeed;
+                      if (_gs == 0) {
+                          return "";
+                      }
+                      return QString("N%1").arg(round(_gs / 10.));
+                  } },
+                { "rules", [](const QObject* o) -> QString {
+                      return pilot(o)->planFlighttype;
+                  } },
+                { "rulesIfNotIfr", [](const QObject* o) -> QString {
+                      return pilot(o)->planFlighttype != "I"? pilot(o)->planFlighttype: "";
+                  } },
+                { "type", [](const QObject* o) -> QString {
+                      return pilot(o)->planAircraftShort;
+                  } },
+                { "livestream", [](const QObject* o) -> QString {
+                      return pilot(o)->livestreamString();
+                  } },
+            },
+            PartialResolver::instance(),
+            false
+        };
+        return _keys;
+    }
 
-        return QString("{%1}").arg(key);
+    QString Context::stringValue(const QString &key) const {
+        const auto getter = keys().getters.value(key, 0);
+        if (getter == 0) {
+            return QString("{%1}").arg(key);
+        }
+        return getter(m_o);
     }
 
     bool Context::isFalse(const QString &key) const {
@@ -1,7 +1,7 @@
 #ifndef MUSTACHEQS_PILOT_CONTEXT_H
 #define MUSTACHEQS_PILOT_CONTEXT_H
 
-#include "src/mustache/external/qt-mustache/mustache.h"
+#include "src/mustache/Template.h"
 
 class Pilot;
 namespace MustacheQs::Pilot {
@@ -21,6 +21,8 @@ namespace MustacheQs::Pilot {
             Context(const class Pilot*);
             virtual ~Context();
 
+            static const Keys& keys();
+
             virtual QString stringValue(const QString &key) const override;
             virtual bool isFalse(const QString &key) const override;
             virtual int listCount(const QString &key) const override;
@@ -386,6 +386,120 @@ QString Renderer::render(const QString& _template, int startPos, int endPos, Con
 	return output;
 }
 
+Program Renderer::compile(const QString& _template, PartialResolver* resolver)
+{
+	m_error.clear();
+	m_errorPos = -1;
+	m_errorPartial.clear();
+
+	m_tagStartMarker = m_defaultTagStartMarker;
+	m_tagEndMarker = m_defaultTagEndMarker;
+
+	Program program;
+	compile(_template, 0, _template.length(), resolver, &program);
+	return program;
+}
+
+// mirrors render(), emitting operations instead of output
+void Renderer::compile(const QString& _template, int startPos, int endPos, PartialResolver* resolver, Program* program)
+{
+	auto appendText = [program](QStringView text) {
+		if (text.isEmpty()) {
+			return;
+		}
+		if (!program->ops.isEmpty() && program->ops.last().type == Program::Op::Text) {
+			program->ops.last().text += text;
+		} else {
+			program->ops.append({ Program::Op::Text, text.toString(), Tag::Raw, 0 });
+		}
+	};
+
+	int lastTagEnd = startPos;
+
+	while (m_errorPos == -1) {
+		Tag tag = findTag(_template, lastTagEnd, endPos);
+		if (tag.type == Tag::Null) {
+			appendText(QStringView(_template).mid(lastTagEnd, qMax(0, endPos - lastTagEnd)));
+			break;
+		}
+		appendText(QStringView(_template).mid(lastTagEnd, tag.start - lastTagEnd));
+		switch (tag.type) {
+		case Tag::Value:
+			program->ops.append({ Program::Op::Value, tag.key, tag.escapeMode, 0 });
+			lastTagEnd = tag.end;
+			break;
+		case Tag::SectionStart:
+		case Tag::InvertedSectionStart:
+		{
+			Tag endTag = findEndTag(_template, tag, endPos);
+			if (endTag.type == Tag::Null) {
+				if (m_errorPos == -1) {
+					setError(
+						tag.type == Tag::SectionStart
+							? "No matching end tag found for section"
+							: "No matching end tag found for inverted section",
+						tag.start
+					);
+				}
+			} else {
+				const int index = program->ops.size();
+				program->ops.append({
+					tag.type == Tag::SectionStart? Program::Op::SectionStart: Program::Op::InvertedSectionStart,
+					tag.key, Tag::Raw, 0
+				});
+				compile(_template, tag.end, endTag.start, resolver, program);
+				program->ops[index].end = program->ops.size();
+				lastTagEnd = endTag.end;
+			}
+		}
+		break;
+		case Tag::SectionEnd:
+			setError("Unexpected end tag", tag.start);
+			lastTagEnd = tag.end;
+			break;
+		case Tag::Partial:
+		{
+			QString tagStartMarker = m_tagStartMarker;
+			QString tagEndMarker = m_tagEndMarker;
+
+			m_tagStartMarker = m_defaultTagStartMarker;
+			m_tagEndMarker = m_defaultTagEndMarker;
+
+			m_partialStack.push(tag.key);
+
+			QString partialContent = resolver != 0? resolver->getPartial(tag.key): QString();
+
+			if (tag.indentation > 0) {
+				appendText(QString(" ").repeated(tag.indentation));
+				int posOfLF = partialContent.indexOf("\n", 0);
+				while (posOfLF > 0 && posOfLF < (partialContent.length() - 1)) {
+					partialContent = partialContent.insert(posOfLF + 1, QString(" ").repeated(tag.indentation));
+					posOfLF = partialContent.indexOf("\n", posOfLF + 1);
+				}
+			}
+
+			compile(partialContent, 0, partialContent.length(), resolver, program);
+
+			lastTagEnd = tag.end;
+
+			m_partialStack.pop();
+
+			m_tagStartMarker = tagStartMarker;
+			m_tagEndMarker = tagEndMarker;
+		}
+		break;
+		case Tag::SetDelimiter:
+			lastTagEnd = tag.end;
+			break;
+		case Tag::Comment:
+			lastTagEnd = tag.end;
+			break;
+		case Tag::Null:
+			break;
+		}
+	}
+}
+
 void Renderer::setError(const QString& error, int pos)
 {
 	Q_ASSERT(!error.isEmpty());
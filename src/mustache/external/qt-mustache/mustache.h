@@ -17,6 +17,7 @@
 #include <QtCore/QStack>
 #include <QtCore/QString>
 #include <QtCore/QVariant>
+#include <QtCore/QVector>
 
 #if __cplusplus >= 201103L
 #include <functional> /* for std::function */
@@ -203,6 +204,30 @@ struct Tag
 	int indentation;
 };
 
+/** QuteScoop: a template parsed once by Renderer::compile() into a flat list
+  * of operations, so that it can be evaluated without scanning for tags again.
+  */
+struct Program
+{
+	struct Op
+	{
+		enum Type
+		{
+			Text, /// literal text
+			Value, /// a {{key}} tag
+			SectionStart, /// a {{#section}} tag, the section ends before ops[end]
+			InvertedSectionStart /// an {{^inverted-section}} tag, the section ends before ops[end]
+		};
+
+		Type type;
+		QString text; /// the text or the key
+		Tag::EscapeMode escapeMode;
+		int end;
+	};
+
+	QVector<Op> ops;
+};
+
 /** Renders Mustache templates, replacing mustache tags with
   * values from a provided context.
   */
@@ -239,8 +264,16 @@ public:
 	  */
 	void setTagMarkers(const QString& startMarker, const QString& endMarker);
 
+	/** QuteScoop: parses a template into a Program, expanding partials from @p resolver.
+	  * Evaluating the program gives the same result as render() for contexts that
+	  * have neither lists nor lambdas (listCount() == 0 and canEval() == false).
+	  * Set delimiter tags inside sections are applied as if the section was rendered.
+	  */
+	Program compile(const QString& _template, PartialResolver* resolver);
+
 private:
 	QString render(const QString& _template, int startPos, int endPos, Context* context);
+	void compile(const QString& _template, int startPos, int endPos, PartialResolver* resolver, Program* program);
 
 	Tag findTag(const QString& content, int pos, int endPos);
 	Tag findEndTag(const QString& content, const Tag& startTag, int endPos);